@@ -13,6 +13,7 @@
 #include <functional>
 #include <stxxl/sorter>
 #include <Utils/IOStatistics.h>
+#include <Utils/Progress.h>
 #include <DegreeStream.h>
 #include <GenericComparator.h>
 #include "Utils/Hashfuncs.h"
@@ -90,7 +91,7 @@ namespace Curveball {
 		ParameterEstimation _param_est;
 
 		InputStream &_edges;
-		DegreeStream &_degrees;
+		RLEDegreeStream &_degrees;
 		node_t _num_nodes;
 		const tradeid_t _num_rounds;
 		OutReceiver &_out_edges;
@@ -135,7 +136,7 @@ namespace Curveball {
 		 * @param insertion_buffer_size Size of insertion buffer per thread
 		 */
 		EMCurveball(InputStream &edges,
-					DegreeStream &degrees,
+					RLEDegreeStream &degrees,
 					const node_t num_nodes,
 					const tradeid_t num_rounds,
 					EdgeStream &out_edges,
@@ -185,7 +186,7 @@ namespace Curveball {
 		 * @param num_threads Number of threads
 		 */
 		EMCurveball(InputStream &edges,
-					DegreeStream &degrees,
+					RLEDegreeStream &degrees,
 					const node_t num_nodes,
 					const tradeid_t num_rounds,
 					EdgeStream &out_edges,
@@ -233,21 +234,23 @@ namespace Curveball {
 			// of the form <h(u), deg(u), u>.
 			IOStatistics first_fill_report;
 			degree_t max_degree = 0;
-			for (node_t node = 0; !_degrees.empty(); ++_degrees) {
+			for (; !_degrees.empty(); _degrees.next_run()) {
+				const auto &run = _degrees.current_run();
+
 				// determine maximum degree while scanning degrees
-				max_degree = std::max(max_degree, *_degrees);
+				max_degree = std::max(max_degree, run.value);
 
 				// in the initialization phase this can be done for both
 				// the current and subsequent round
-				target_infos.push_active(
-					TargetMsg{hash_funcs[0].hash(node), *_degrees, node}
-				);
-
-				target_infos.push_pending(
-					TargetMsg{hash_funcs[1].hash(node), *_degrees, node}
-				);
-
-				node++;
+				const auto &hash_active = hash_funcs[0];
+				target_infos.push_active(run, [&](const node_t node) {
+					return hash_active.hash(node);
+				});
+
+				const auto &hash_pending = hash_funcs[1];
+				target_infos.push_pending(run, [&](const node_t node) {
+					return hash_pending.hash(node);
+				});
 			}
 			first_fill_report.report("FirstFill");
 
@@ -292,6 +295,7 @@ namespace Curveball {
 			}
 
 			// process all global trades one by one
+			ProgressTask progress("Curveball global trades", _num_rounds);
 			for (tradeid_t round = 0; round < _num_rounds; round++) {
 				// process the global trade
 				msgs_container.process_active();
@@ -312,19 +316,20 @@ namespace Curveball {
 
 					// refill obsolete containers
 					_degrees.rewind();
-					for (node_t node = 0; node < _num_nodes; node++, ++_degrees) {
-						target_infos.push_pending(
-							TargetMsg{hash_funcs.next_hash(node),
-									  *_degrees,
-									  node});
+					for (; !_degrees.empty(); _degrees.next_run()) {
+						target_infos.push_pending(_degrees.current_run(),
+							[&](const node_t node) {
+								return hash_funcs.next_hash(node);
+							});
 					}
-					assert(_degrees.empty());
 
 					// compute new bounds on the containers for msg insertion
 					const auto new_bounds = target_infos.get_bounds_pending();
 
 					msgs_container.set_new_bounds(new_bounds);
 				}
+
+				progress.advance();
 			}
 			// check whether all hash-functions have been processed
 			assert(hash_funcs.at_last());
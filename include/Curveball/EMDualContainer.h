@@ -12,6 +12,7 @@
 #include <parallel/algorithm>
 #include <parallel/numeric>
 #include <Utils/IOStatistics.h>
+#include <Utils/Progress.h>
 #include "EMMessageContainer.h"
 #include "IMAdjacencyList.h"
 #include "Utils/Hashfuncs.h"
@@ -360,6 +361,8 @@ namespace Curveball {
 		 * reinitialization for next round is done.
 		 */
 		void process_active() {
+			ProgressTask progress("Curveball macrochunks", _num_chunks);
+
 			// process macrochunk by macrochunk
 			for (chunkid_t mc_id = 0; mc_id < _num_chunks; mc_id++) {
 				{
@@ -381,12 +384,13 @@ namespace Curveball {
 											 msgs.end(),
 											 __gnu_parallel::quicksort_tag());
 						#else
+						// in-place, so that sorting does not double the peak memory of
+						// the macrochunk; messages are only compared by target anyhow
 						const hnode_t last_upper_bound = (mc_id > 0 ? _active_upper_bounds[mc_id - 1] : 0);
-						intsort::sort(msgs,
+						intsort::sort_inplace(msgs,
 									  [&] (const NeighbourMsg& msg)
 									  {return msg.target - last_upper_bound;},
 									  _active_upper_bounds[mc_id] - last_upper_bound + 1);
-						// radix-sort data-structure is dealloc here
 						#endif
 					}
 
@@ -813,6 +817,7 @@ namespace Curveball {
 				reset();
 
 				trading_report.report("Trading");
+				progress.advance();
 			} // for-loop over macrochunks
 
 			// check if all information was extracted
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <defs.h>
+#include <DegreeStream.h>
 #include <stxxl/sorter>
 #include "../../libs/stxxl/include/stxxl/bits/compat/unique_ptr.h"
 
@@ -173,6 +174,30 @@ namespace Curveball {
 			assert(_pending->size() <= static_cast<size_t>(_num_nodes));
 		}
 
+		/**
+		 * Push auxiliary information of all nodes of a degree run in the active
+		 * container.
+		 * @param run Run of nodes sharing the same degree.
+		 * @param hash Hash function applied to the node ids.
+		 */
+		template <typename HashFunc>
+		void push_active(const RLEDegreeStream::run_type &run, HashFunc &&hash) {
+			for (node_t node = run.index - run.count; node < static_cast<node_t>(run.index); node++)
+				push_active(TargetMsg{hash(node), run.value, node});
+		}
+
+		/**
+		 * Push auxiliary information of all nodes of a degree run in the next
+		 * container.
+		 * @param run Run of nodes sharing the same degree.
+		 * @param hash Hash function applied to the node ids.
+		 */
+		template <typename HashFunc>
+		void push_pending(const RLEDegreeStream::run_type &run, HashFunc &&hash) {
+			for (node_t node = run.index - run.count; node < static_cast<node_t>(run.index); node++)
+				push_pending(TargetMsg{hash(node), run.value, node});
+		}
+
 		/**
 		 * Rewinds the auxiliary information stream of the active round.
 		 */
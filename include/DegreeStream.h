@@ -9,6 +9,7 @@
 
 #include <defs.h>
 #include <stxxl/sequence>
+#include <DistributionCount.h>
 #include <memory>
 
 class DegreeStream {
@@ -209,3 +210,208 @@ public:
 	  return *this;
   }
 };
+
+/**
+ * Run-length encoded degree sequence, i.e. a writable and rewindable variant
+ * of DistributionCount. Consecutive equal degrees are collapsed into a single
+ * run (degree, count, index) where index is the number of nodes covered by
+ * this and all previous runs. For power-law sequences the number of runs is
+ * in the order of the number of distinct degrees, so the I/O is negligible.
+ *
+ * The stream can be consumed node by node (operator*, operator++) as a drop-in
+ * for DegreeStream, or run by run (current_run, next_run) by consumers that
+ * natively handle blocks of equal degrees.
+ */
+class RLEDegreeStream {
+public:
+	using value_type = degree_t;
+	using run_type = DistributionBlockDescriptor<degree_t>;
+
+protected:
+	using em_buffer_t = stxxl::sequence<run_type>;
+	using em_reader_t = typename em_buffer_t::stream;
+
+	std::unique_ptr<em_buffer_t> _em_buffer;
+	std::unique_ptr<em_reader_t> _em_reader;
+
+	enum Mode {
+			WRITING, READING
+	};
+	Mode _mode;
+
+	size_t _size = 0;
+	size_t _num_runs = 0;
+
+	//! Run currently written (WRITING) or read (READING)
+	run_type _current_run;
+	//! Number of nodes of the current run not yet consumed
+	stxxl::uint64 _run_remaining = 0;
+	bool _empty = true;
+
+	void _fetch_run() {
+		if (_em_reader->empty()) {
+			_empty = true;
+			_run_remaining = 0;
+			return;
+		}
+
+		_current_run = _em_reader->operator*();
+		_run_remaining = _current_run.count;
+		_em_reader->operator++();
+		_empty = false;
+	}
+
+public:
+	RLEDegreeStream() {
+		clear();
+	}
+
+	RLEDegreeStream(const RLEDegreeStream &) = delete;
+
+	~RLEDegreeStream() {
+		// in this order ;)
+		_em_reader.reset(nullptr);
+		_em_buffer.reset(nullptr);
+	}
+
+	RLEDegreeStream(RLEDegreeStream &&) = default;
+
+	RLEDegreeStream &operator=(RLEDegreeStream &&) = default;
+
+// Write interface
+	//! Appends count nodes of the given degree
+	void push(const degree_t degree, const stxxl::uint64 count = 1) {
+		assert(_mode == WRITING);
+
+		if (UNLIKELY(!count))
+			return;
+
+		_size += count;
+
+		if (LIKELY(_current_run.count && _current_run.value == degree)) {
+			_current_run.count += count;
+			_current_run.index += count;
+			return;
+		}
+
+		if (_current_run.count) {
+			_em_buffer->push_back(_current_run);
+			_num_runs++;
+		}
+
+		_current_run = {degree, count, _size};
+	}
+
+	//! switches to read mode and resets the stream
+	void rewind() {
+		if (_mode == WRITING) {
+			if (_current_run.count) {
+				_em_buffer->push_back(_current_run);
+				_num_runs++;
+			}
+
+			_mode = READING;
+		}
+
+		_em_reader.reset(new em_reader_t(*_em_buffer));
+		_fetch_run();
+	}
+
+	// returns back to writing mode on an empty stream
+	void clear() {
+		_mode = WRITING;
+		_em_reader.reset(nullptr);
+		_em_buffer.reset(new em_buffer_t(16, 16));
+		_size = 0;
+		_num_runs = 0;
+		_current_run = {0, 0, 0};
+		_run_remaining = 0;
+		_empty = true;
+	}
+
+	//! Number of nodes
+	size_t size() const {
+		return _size;
+	}
+
+	//! Number of runs (only accurate in read mode)
+	size_t num_runs() const {
+		return _num_runs;
+	}
+
+// Consume interface
+	//! return true when in write mode or if all nodes are consumed
+	bool empty() const {
+		return _empty;
+	}
+
+	const value_type &operator*() const {
+		assert(READING == _mode);
+		return _current_run.value;
+	}
+
+	RLEDegreeStream &operator++() {
+		assert(READING == _mode);
+
+		if (UNLIKELY(_empty))
+			return *this;
+
+		if (!--_run_remaining)
+			_fetch_run();
+
+		return *this;
+	}
+
+	//! The run containing the current node
+	const run_type &current_run() const {
+		assert(READING == _mode);
+		return _current_run;
+	}
+
+	//! Number of nodes of the current run not yet consumed (including the current node)
+	stxxl::uint64 run_remaining() const {
+		return _run_remaining;
+	}
+
+	//! Skips the remaining nodes of the current run
+	RLEDegreeStream &next_run() {
+		assert(READING == _mode);
+
+		if (LIKELY(!_empty))
+			_fetch_run();
+
+		return *this;
+	}
+
+	/**
+	 * Stream adapter yielding whole runs, e.g. as input to HavelHakimiGeneratorRLE.
+	 * It starts at the current run of the underlying stream.
+	 */
+	class RunStream {
+	public:
+		using value_type = run_type;
+
+	private:
+		RLEDegreeStream & _degrees;
+
+	public:
+		RunStream(RLEDegreeStream & degrees) : _degrees(degrees) {}
+
+		const value_type & operator * () const {
+			return _degrees.current_run();
+		}
+
+		const value_type * operator -> () const {
+			return &_degrees.current_run();
+		}
+
+		RunStream & operator++ () {
+			_degrees.next_run();
+			return *this;
+		}
+
+		bool empty() const {
+			return _degrees.empty();
+		}
+	};
+};
@@ -3,6 +3,7 @@
 #include <defs.h>
 #include <stxxl/sequence>
 #include <memory>
+#include <vector>
 
 class EdgeStream {
 public:
@@ -15,6 +16,11 @@ protected:
     std::unique_ptr<em_buffer_t> _em_buffer;
     std::unique_ptr<em_reader_t> _em_reader;
 
+    // used instead of the EM buffer after enableInternalMemory()
+    bool _internal;
+    std::vector<node_t> _im_buffer;
+    size_t _im_position;
+
     enum Mode {WRITING, READING};
     Mode _mode;
 
@@ -35,7 +41,8 @@ protected:
 
 public:
     EdgeStream(bool multi_edges = true, bool loops = true)
-        : _allow_multi_edges(multi_edges)
+        : _internal(false)
+        , _allow_multi_edges(multi_edges)
         , _allow_loops(loops)
         , _current(edge_t::invalid())
     {clear();}
@@ -58,6 +65,12 @@ public:
         _allow_loops = true;
     }
 
+    //! Keep the edges in a std::vector instead of an EM sequence; clears the stream
+    void enableInternalMemory() {
+        _internal = true;
+        clear();
+    }
+
 // Write interface
     void push(const edge_t& edge) {
         assert(_mode == WRITING);
@@ -79,14 +92,21 @@ public:
         // ensure order
         assert(!_number_of_edges || _current <= edge);
 
-        em_buffer_t & em_buffer = *_em_buffer;
+        if (_internal) {
+            for(; UNLIKELY(_current_out_node < edge.first); _current_out_node++)
+                _im_buffer.push_back(INVALID_NODE);
 
-        while(UNLIKELY(_current_out_node < edge.first)) {
-            em_buffer.push_back(INVALID_NODE);
-            _current_out_node++;
-        }
+            _im_buffer.push_back(edge.second);
+        } else {
+            em_buffer_t & em_buffer = *_em_buffer;
 
-        em_buffer.push_back(edge.second);
+            while(UNLIKELY(_current_out_node < edge.first)) {
+                em_buffer.push_back(INVALID_NODE);
+                _current_out_node++;
+            }
+
+            em_buffer.push_back(edge.second);
+        }
         _number_of_edges++;
 
         _current = edge;
@@ -98,9 +118,14 @@ public:
     //! switches to read mode and resets the stream
     void rewind() {
         _mode = READING;
-        _em_reader.reset(new em_reader_t(*_em_buffer));
         _current = {0, 0};
-        _empty = _em_reader->empty();
+        if (_internal) {
+            _im_position = 0;
+            _empty = _im_buffer.empty();
+        } else {
+            _em_reader.reset(new em_reader_t(*_em_buffer));
+            _empty = _em_reader->empty();
+        }
 
         if (!empty())
             ++(*this);
@@ -113,8 +138,15 @@ public:
         _number_of_edges = 0;
         _number_of_multiedges = 0;
         _number_of_selfloops = 0;
+        _empty = true;
+        _im_position = 0;
         _em_reader.reset(nullptr);
-        _em_buffer.reset(new em_buffer_t(16, 16));
+        if (_internal) {
+            _em_buffer.reset(nullptr);
+            std::vector<node_t>().swap(_im_buffer);
+        } else {
+            _em_buffer.reset(new em_buffer_t(16, 16));
+        }
     }
 
     //! Number of edges available if rewind was called
@@ -151,6 +183,18 @@ public:
         assert(READING == _mode);
         assert(!_empty);
 
+        if (_internal) {
+            _empty = (_im_position == _im_buffer.size());
+            if (UNLIKELY(_empty))
+                return *this;
+
+            for(; UNLIKELY(_im_buffer[_im_position] == INVALID_NODE); ++_im_position, ++_current.first)
+                assert(_im_position + 1 < _im_buffer.size());
+
+            _current.second = _im_buffer[_im_position++];
+            return *this;
+        }
+
         em_reader_t& reader = *_em_reader;
 
         // handle end of stream
@@ -29,6 +29,7 @@ protected:
         internal_swapid_t sid;
         bool forward_only; // if this requests is only for generating the correct forwaring information but no existence information is needed
         DECL_TO_TUPLE(e, sid, forward_only);
+        DECL_PACKED_KEY(e, packed_key::descending(sid), forward_only);
         bool operator< (const edge_existence_request_t& o) const {
             return (e < o.e || (e == o.e && (sid > o.sid || (sid == o.sid && forward_only < o.forward_only))));
         }
@@ -66,12 +67,12 @@ protected:
 public:
     EdgeSwapInternalSwapsBase(const EdgeSwapInternalSwapsBase &) = delete;
 
-    EdgeSwapInternalSwapsBase() :
+    EdgeSwapInternalSwapsBase(const uint_t& query_sorter_mem = SORTER_MEM) :
         EdgeSwapBase()
 #ifdef EDGE_SWAP_DEBUG_VECTOR
         , _debug_vector_writer(_result)
 #endif
-        , _query_sorter(typename GenericComparatorStruct<edge_existence_request_t>::Ascending(), SORTER_MEM)
+        , _query_sorter(typename GenericComparatorStruct<edge_existence_request_t>::Ascending(), query_sorter_mem)
     {
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <EdgeSwaps/EdgeSwapInternalSwapsBase.h>
+#include <Utils/IntSort.h>
 
 #if 1
     #include <parallel/algorithm>
@@ -58,7 +59,7 @@ void EdgeSwapInternalSwapsBase::loadEdgeExistenceInformation(EdgeReader &edgeRea
     }
 
     _query_sorter.clear();
-    SEQPAR::sort(_edge_existence_successors.begin(), _edge_existence_successors.end());
+    intsort::sort_packed(_edge_existence_successors);
     std::make_heap(_edge_existence_pq.begin(), _edge_existence_pq.end(), std::greater<edge_existence_answer_t>());
 }
 
@@ -73,6 +73,7 @@ namespace EdgeSwapParallelTFP {
             return (edge < o.edge || (edge == o.edge && (swap_id_forward_only > o.swap_id_forward_only)));
         }
         DECL_TO_TUPLE(edge, swap_id_forward_only);
+        DECL_PACKED_KEY(edge, packed_key::descending(swap_id_forward_only));
         DECL_TUPLE_OS(ExistenceRequestMsg);
     };
 
@@ -2,15 +2,20 @@
 
 #include <algorithm>
 #include <array>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
+#include <parallel/algorithm>
 
 #include <stx/btree_map>
+#include <stxxl/stream>
 
 #include "PQSorterMerger.h"
 #include "EdgeVectorUpdateStream.h"
 
 #include <Utils/AsyncStream.h>
 #include <Utils/AsyncPusher.h>
+#include <Utils/IntSort.h>
 
 #define ASYNC_STREAMS
 #define REPORT_SORTER_STATS(X) \
@@ -27,8 +32,8 @@ namespace EdgeSwapTFP {
     /*
      * This method implements the steps "request nodes" and "load nodes".
      */
-    template<class EdgeReader>
-    void EdgeSwapTFP::_compute_dependency_chain(EdgeReader & edge_reader_in, BoolStream & edge_remains_valid) {
+    template<class EdgeReader, class SwapRequests>
+    void EdgeSwapTFP::_compute_dependency_chain(EdgeReader & edge_reader_in, SwapRequests & swap_requests_in, BoolStream & edge_remains_valid) {
         edge_remains_valid.clear();
 
         edgeid_t eid = 0; // points to the next edge that can be read
@@ -40,20 +45,20 @@ namespace EdgeSwapTFP {
 
         #ifdef ASYNC_STREAMS
             AsyncStream<EdgeReader> edge_reader(edge_reader_in, false, 1.0e6);
-            AsyncStream<EdgeSwapSorter> edge_swap_sorter(*_edge_swap_sorter, false, 1.0e6);
+            AsyncStream<SwapRequests> edge_swap_sorter(swap_requests_in, false, 1.0e6);
             edge_reader.acquire();
             edge_swap_sorter.acquire();
         #else
             EdgeReader & edge_reader = edge_reader_in;
-            EdgeSwapSorter & edge_swap_sorter = *_edge_swap_sorter;
+            SwapRequests & edge_swap_sorter = swap_requests_in;
         #endif
 
         #ifdef ASYNC_PUSHERS
-            AsyncPusher<DependencyChainEdgeSorter, DependencyChainEdgeMsg> depchain_edge_sorter(_depchain_edge_sorter, 1<<20, 20);
-            AsyncPusher<DependencyChainSuccessorSorter, DependencyChainSuccessorMsg> depchain_successor_sorter(_depchain_successor_sorter);
+            AsyncPusher<DependencyChainEdgeSorter, DependencyChainEdgeMsg> depchain_edge_sorter(*_depchain_edge_sorter, 1<<20, 20);
+            AsyncPusher<DependencyChainSuccessorSorter, DependencyChainSuccessorMsg> depchain_successor_sorter(*_depchain_successor_sorter);
         #else
-            auto & depchain_edge_sorter = _depchain_edge_sorter;
-            auto & depchain_successor_sorter = _depchain_successor_sorter;
+            auto & depchain_edge_sorter = *_depchain_edge_sorter;
+            auto & depchain_successor_sorter = *_depchain_successor_sorter;
         #endif
 
         bool first_swap_of_edge = true;
@@ -143,10 +148,12 @@ namespace EdgeSwapTFP {
         #endif
 
         // then sort
-        _depchain_successor_sorter.sort();
-        REPORT_SORTER_STATS(_depchain_successor_sorter);
-        _depchain_edge_sorter.sort();
-        REPORT_SORTER_STATS(_depchain_edge_sorter);
+        _depchain_successor_sorter->sort();
+        REPORT_SORTER_STATS(*_depchain_successor_sorter);
+        _observe(2, _depchain_successor_sorter->size());
+        _depchain_edge_sorter->sort();
+        REPORT_SORTER_STATS(*_depchain_edge_sorter);
+        _observe(0, _depchain_edge_sorter->size());
 
         // Free EM of edge swaps before continuing
         _edge_swap_sorter->clear();
@@ -174,13 +181,13 @@ namespace EdgeSwapTFP {
         // use pq in addition to _depchain_edge_sorter to pass messages between swaps
         assert(_dependency_chain_pq.empty());
         #ifdef ASYNC_STREAMS
-             AsyncStream<DependencyChainEdgeSorter> depchain_edge_sorter(_depchain_edge_sorter, false);
-             AsyncStream<DependencyChainSuccessorSorter> depchain_successor_sorter(_depchain_successor_sorter, false);
+             AsyncStream<DependencyChainEdgeSorter> depchain_edge_sorter(*_depchain_edge_sorter, false);
+             AsyncStream<DependencyChainSuccessorSorter> depchain_successor_sorter(*_depchain_successor_sorter, false);
              depchain_edge_sorter.acquire();
              depchain_successor_sorter.acquire();
         #else
-             auto & depchain_edge_sorter = _depchain_edge_sorter;
-             auto & depchain_successor_sorter = _depchain_successor_sorter;
+             auto & depchain_edge_sorter = *_depchain_edge_sorter;
+             auto & depchain_successor_sorter = *_depchain_successor_sorter;
         #endif
 
         PQSorterMerger<DependencyChainEdgePQ, decltype(depchain_edge_sorter), compute_stats>
@@ -192,6 +199,9 @@ namespace EdgeSwapTFP {
 
         std::array<std::vector<edge_t>, 2> dd_new_edges;
 
+        _hub_requests.clear();
+        _hub_requests_enabled = (_hub_index != nullptr);
+
         for (; !_swap_directions.empty(); ++_swap_directions, ++sid) {
             swapid_t successors[2] = {0,0};
 
@@ -316,7 +326,7 @@ namespace EdgeSwapTFP {
                             _dependency_chain_pq.push(DependencyChainEdgeMsg{successors[i], send_edge});
                         }
 
-                        _existence_request_sorter.push(ExistenceRequestMsg{send_edge, sid, false});
+                        _push_existence_request(ExistenceRequestMsg{send_edge, sid, false});
                     }
                 }
 
@@ -330,13 +340,14 @@ namespace EdgeSwapTFP {
                         _dependency_chain_pq.push(DependencyChainEdgeMsg{successors[i], edge});
                     }
 
-                    _existence_request_sorter.push(ExistenceRequestMsg{edge, sid, true});
+                    _push_existence_request(ExistenceRequestMsg{edge, sid, true});
                 }
             }
 
             // if we pushed something into the PQ we need to update the merger
             if (UNLIKELY(successors[0] || successors[1])) {
                 depchain_pqsort.update();
+                _observe(1, _dependency_chain_pq.size());
             }
         }
 
@@ -350,18 +361,19 @@ namespace EdgeSwapTFP {
             depchain_pqsort.dump_stats("depchain_pqsort");
         }
 
-        _existence_request_sorter.sort();
-        REPORT_SORTER_STATS(_existence_request_sorter)
+        _existence_request_sorter->sort();
+        REPORT_SORTER_STATS(*_existence_request_sorter)
+        _observe(8, _existence_request_sorter->size());
         _swap_directions.rewind();
 
         if (_async_processing) {
             _depchain_thread.reset(new std::thread([&]() {
-                _depchain_successor_sorter.rewind();
-                _depchain_edge_sorter.rewind();
+                _depchain_successor_sorter->rewind();
+                _depchain_edge_sorter->rewind();
             }));
         } else {
-            _depchain_successor_sorter.rewind();
-            _depchain_edge_sorter.rewind();
+            _depchain_successor_sorter->rewind();
+            _depchain_edge_sorter->rewind();
         }
     }
 
@@ -374,79 +386,97 @@ namespace EdgeSwapTFP {
      */
     void EdgeSwapTFP::_load_existence() {
 
-        uint64_t stat_exist_reqs = _existence_request_sorter.size();
+        uint64_t stat_exist_reqs = _existence_request_sorter->size();
         uint64_t stat_forward_only = 0;
         uint64_t stat_dropped_dep = 0;
         stx::btree_map<uint_t, swapid_t> stat_hist_requests_per_edge;
 
         #ifdef ASYNC_STREAMS
-            AsyncStream<ExistenceRequestSorter> existence_request_sorter(_existence_request_sorter);
+            AsyncStream<ExistenceRequestSorter> existence_request_sorter(*_existence_request_sorter);
         #else
-            auto & existence_request_sorter = _existence_request_sorter;
+            auto & existence_request_sorter = *_existence_request_sorter;
         #endif
 
 
 
-        while (!existence_request_sorter.empty()) {
-            auto &request = *existence_request_sorter;
-            edge_t current_edge = request.edge;
+        // requests are processed edge by edge; exists_in_graph is queried once per edge in ascending order
+        auto answer_requests = [&] (auto & existence_requests, auto exists_in_graph) {
+            while (!existence_requests.empty()) {
+                auto &request = *existence_requests;
+                edge_t current_edge = request.edge;
 
-            // find edge in graph
-            bool exists = false;
-            for (; !_edges.empty(); ++_edges) {
-                const auto &edge = *_edges;
-                if (edge > current_edge) break;
-                exists = (edge == current_edge);
-            }
+                const bool exists = exists_in_graph(current_edge);
 
-            // build dependency chain (i.e. inform earlier swaps about later ones) and find the earliest swap
-            swapid_t last_swap = request.swap_id();
-            bool foundTargetEdge = false; // if we already found a swap where the edge is a target
+                // build dependency chain (i.e. inform earlier swaps about later ones) and find the earliest swap
+                swapid_t last_swap = request.swap_id();
+                bool foundTargetEdge = false; // if we already found a swap where the edge is a target
 
-            swapid_t stat_requests_per_edge = 0;
+                swapid_t stat_requests_per_edge = 0;
 
-            // observe that existence requests are ordered desc so we iterate over a dependency chain backwards
-            for (; !existence_request_sorter.empty(); ++existence_request_sorter) {
-                auto &request = *existence_request_sorter;
-                if (request.edge != current_edge)
-                    break;
+                // observe that existence requests are ordered desc so we iterate over a dependency chain backwards
+                for (; !existence_requests.empty(); ++existence_requests) {
+                    auto &request = *existence_requests;
+                    if (request.edge != current_edge)
+                        break;
 
-                if (UNLIKELY(last_swap != request.swap_id() && foundTargetEdge)) {
-                    // inform an earlier swap about later swaps that need the new state
-                    assert(last_swap > request.swap_id());
-                    _existence_successor_sorter.push(ExistenceSuccessorMsg{request.swap_id(), current_edge, last_swap});
-                    DEBUG_MSG(_display_debug, "Inform swap " << request.swap_id() << " that " << last_swap << " is a successor for edge " << current_edge);
-                } else if (compute_stats) {
-                    stat_dropped_dep++;
-                }
+                    if (UNLIKELY(last_swap != request.swap_id() && foundTargetEdge)) {
+                        // inform an earlier swap about later swaps that need the new state
+                        assert(last_swap > request.swap_id());
+                        _existence_successor_sorter->push(ExistenceSuccessorMsg{request.swap_id(), current_edge, last_swap});
+                        DEBUG_MSG(_display_debug, "Inform swap " << request.swap_id() << " that " << last_swap << " is a successor for edge " << current_edge);
+                    } else if (compute_stats) {
+                        stat_dropped_dep++;
+                    }
 
-                last_swap = request.swap_id();
-                foundTargetEdge = (foundTargetEdge || !request.forward_only());
+                    last_swap = request.swap_id();
+                    foundTargetEdge = (foundTargetEdge || !request.forward_only());
 
-                if (compute_stats) {
-                    stat_forward_only += request.forward_only();
-                    stat_requests_per_edge++;
+                    if (compute_stats) {
+                        stat_forward_only += request.forward_only();
+                        stat_requests_per_edge++;
+                    }
                 }
-            }
 
-            if (compute_stats)
-                stat_hist_requests_per_edge[stat_requests_per_edge]++;
+                if (compute_stats)
+                    stat_hist_requests_per_edge[stat_requests_per_edge]++;
 
-            // inform earliest swap whether edge exists
-            if (foundTargetEdge) {
-            #ifdef NDEBUG
-                if (exists) {
-                    _existence_info_sorter.push(ExistenceInfoMsg{last_swap, current_edge});
+                // inform earliest swap whether edge exists
+                if (foundTargetEdge) {
+                #ifdef NDEBUG
+                    if (exists) {
+                        _existence_info_sorter->push(ExistenceInfoMsg{last_swap, current_edge});
+                    }
+                #else
+                    _existence_info_sorter->push(ExistenceInfoMsg{last_swap, current_edge, exists});
+                    DEBUG_MSG(_display_debug, "Inform swap " << last_swap << " edge " << current_edge << " exists " << exists);
+                #endif
                 }
-            #else
-                _existence_info_sorter.push(ExistenceInfoMsg{last_swap, current_edge, exists});
-                DEBUG_MSG(_display_debug, "Inform swap " << last_swap << " edge " << current_edge << " exists " << exists);
-            #endif
             }
+        };
+
+        // find edge in graph
+        answer_requests(existence_request_sorter, [&] (const edge_t & current_edge) {
+            bool exists = false;
+            for (; !_edges.empty(); ++_edges) {
+                const auto &edge = *_edges;
+                if (edge > current_edge) break;
+                exists = (edge == current_edge);
+            }
+            return exists;
+        });
+
+        // requests to hub edges are answered from RAM
+        if (!_hub_requests.empty()) {
+            intsort::sort_packed(_hub_requests);
+            auto hub_requests = stxxl::stream::streamify(_hub_requests.cbegin(), _hub_requests.cend());
+            answer_requests(hub_requests, [&] (const edge_t & current_edge) {
+                return _hub_index->exists(current_edge);
+            });
         }
 
         if (compute_stats) {
             std::cout << "Existence requests: " << stat_exist_reqs << "\n"
+                         "Hub requests answered in RAM: " << _hub_requests.size() << "\n"
                          "Forward only requests: " << stat_forward_only << "\n"
                          "Dep. Chains shortend: " << stat_dropped_dep << std::endl;
 
@@ -455,22 +485,25 @@ namespace EdgeSwapTFP {
             }
         }
 
-        REPORT_SORTER_STATS(_existence_successor_sorter);
-        REPORT_SORTER_STATS(_existence_info_sorter);
+        REPORT_SORTER_STATS(*_existence_successor_sorter);
+        REPORT_SORTER_STATS(*_existence_info_sorter);
+        _observe(9, _existence_successor_sorter->size());
+        _observe(7, _existence_info_sorter->size());
 
         if (_async_processing) {
-            std::thread t1([&](){_existence_successor_sorter.sort();});
-            std::thread t2([&](){_existence_info_sorter.sort();});
+            std::thread t1([&](){_existence_successor_sorter->sort();});
+            std::thread t2([&](){_existence_info_sorter->sort();});
             //_existence_request_sorter.finish_clear();
             t1.join(); t2.join();
         } else {
             //_existence_request_sorter.finish_clear();
-            _existence_successor_sorter.sort();
-            _existence_info_sorter.sort();
+            _existence_successor_sorter->sort();
+            _existence_info_sorter->sort();
         }
 
         // existence requests are not needed anymore, clear them
-        _existence_request_sorter.clear();
+        _existence_request_sorter->clear();
+        _hub_requests.clear();
         _edges.rewind();
     }
 
@@ -488,16 +521,16 @@ namespace EdgeSwapTFP {
 #endif
 
        #ifdef ASYNC_STREAMS
-             AsyncStream<DependencyChainEdgeSorter> depchain_edge_sorter(_depchain_edge_sorter, false);
-             AsyncStream<DependencyChainSuccessorSorter> depchain_successor_sorter(_depchain_successor_sorter, false);
-             AsyncStream<ExistenceInfoSorter> existence_info_sorter(_existence_info_sorter, false);
+             AsyncStream<DependencyChainEdgeSorter> depchain_edge_sorter(*_depchain_edge_sorter, false);
+             AsyncStream<DependencyChainSuccessorSorter> depchain_successor_sorter(*_depchain_successor_sorter, false);
+             AsyncStream<ExistenceInfoSorter> existence_info_sorter(*_existence_info_sorter, false);
              depchain_edge_sorter.acquire();
              depchain_successor_sorter.acquire();
              existence_info_sorter.acquire();
         #else
-             auto & depchain_edge_sorter = _depchain_edge_sorter;
-             auto & depchain_successor_sorter = _depchain_successor_sorter;
-             auto & existence_info_sorter = _existence_info_sorter;
+             auto & depchain_edge_sorter = *_depchain_edge_sorter;
+             auto & depchain_successor_sorter = *_depchain_successor_sorter;
+             auto & existence_info_sorter = *_existence_info_sorter;
         #endif
 
         assert(_dependency_chain_pq.empty());
@@ -521,6 +554,9 @@ namespace EdgeSwapTFP {
 
         for (; !_swap_directions.empty(); ++_swap_directions, ++sid) {
             edge_state_pqsort.update();
+            // the edge state PQ shares the pool of the dependency chain PQ
+            _observe(1, _dependency_chain_pq.size());
+            _observe(6, _existence_info_pq.size());
 
             // collect the current state of the edge to be swapped
             edge_t edges[4];
@@ -640,6 +676,14 @@ namespace EdgeSwapTFP {
                 DEBUG_MSG(_display_debug, "Swap " << sid << " " << res);
             }
 
+            // keep the in-RAM index in sync with the graph for the next run
+            if (_hub_index && perform_swap) {
+                _hub_index->erase(edges[0]);
+                _hub_index->erase(edges[1]);
+                _hub_index->insert(new_edges[0]);
+                _hub_index->insert(new_edges[1]);
+            }
+
             // forward edge state to successor swap
             bool successor_found[2] = {false, false};
             for (; !depchain_successor_sorter.empty(); ++depchain_successor_sorter) {
@@ -669,8 +713,8 @@ namespace EdgeSwapTFP {
             }
 
             // forward existence information
-            for (; !_existence_successor_sorter.empty(); ++_existence_successor_sorter) {
-                auto &succ = *_existence_successor_sorter;
+            for (; !_existence_successor_sorter->empty(); ++(*_existence_successor_sorter)) {
+                auto &succ = **_existence_successor_sorter;
 
                 assert(succ.swap_id >= sid);
                 if (succ.swap_id > sid) break;
@@ -736,16 +780,17 @@ namespace EdgeSwapTFP {
 #endif
 
         // check message data structures are empty
-        assert(_depchain_successor_sorter.empty());
+        assert(_depchain_successor_sorter->empty());
         //_depchain_successor_sorter.finish_clear();
 
-        assert(_existence_successor_sorter.empty());
+        assert(_existence_successor_sorter->empty());
         //_existence_successor_sorter.finish_clear();
 
         assert(_existence_info_pq.empty());
         //_existence_info_sorter.finish_clear();
 
         REPORT_SORTER_STATS(_edge_update_sorter);
+        _observe(5, _edge_update_sorter.size());
 
         if (_async_processing) {
             _edge_update_sorter_thread.reset(
@@ -761,7 +806,7 @@ namespace EdgeSwapTFP {
 
         using UpdateStream = EdgeVectorUpdateStream<EdgeStream, BoolStream, decltype(_edge_update_sorter), true>;
 
-        if (!_edge_swap_sorter->size()) {
+        if (!_sorted_requests && !_edge_swap_sorter->size()) {
             // there are no swaps - let's see whether there are pending updates
             if (_edge_update_sorter.size()) {
                 UpdateStream update_stream(_edges, _last_edge_update_mask, _edge_update_sorter);
@@ -775,9 +820,23 @@ namespace EdgeSwapTFP {
             return;
         }
 
+        _observe(4, _edge_swap_sorter->size());
+        const auto run_swaps = _swap_directions.size();
+
+        TelemetrySpan run_span("TFP run");
+        run_span.counter("run", _iteration);
+
+        auto compute_dependency_chain = [&] (auto & edge_reader) {
+            TelemetrySpan span("_compute_dependency_chain");
+            if (_sorted_requests)
+                _compute_dependency_chain(edge_reader, *_sorted_requests, _edge_update_mask);
+            else
+                _compute_dependency_chain(edge_reader, *_edge_swap_sorter, _edge_update_mask);
+        };
+
         if (_first_run) {
             // first iteration
-            _compute_dependency_chain(_edges, _edge_update_mask);
+            compute_dependency_chain(_edges);
             _edges.rewind();
             _first_run = false;
 
@@ -786,7 +845,7 @@ namespace EdgeSwapTFP {
                 _edge_update_sorter_thread->join();
 
             UpdateStream update_stream(_edges, _last_edge_update_mask, _edge_update_sorter);
-            _compute_dependency_chain(update_stream, _edge_update_mask);
+            compute_dependency_chain(update_stream);
             update_stream.finish();
 
             _edge_update_sorter.clear();
@@ -799,6 +858,10 @@ namespace EdgeSwapTFP {
         }
         _iteration++;
 
+        // _edges are the result of all previous runs now
+        if (_random_swaps_state)
+            _write_checkpoint();
+
 #ifndef NDEBUG
         // test that input is lexicographically ordered and loop free
         {
@@ -823,17 +886,98 @@ namespace EdgeSwapTFP {
         std::swap(_edge_update_mask, _last_edge_update_mask);
 
         _report_stats("_compute_dependency_chain: ", show_stats);
-        _simulate_swaps();
+        {
+            TelemetrySpan span("_simulate_swaps");
+            _simulate_swaps();
+        }
         _report_stats("_simulate_swaps: ", show_stats);
-        _load_existence();
+        {
+            TelemetrySpan span("_load_existence");
+            _load_existence();
+        }
         _report_stats("_load_existence: ", show_stats);
-        _perform_swaps();
+        {
+            TelemetrySpan span("_perform_swaps");
+            _perform_swaps();
+        }
         _report_stats("_perform_swaps: ", show_stats);
 
         _reset();
         _report_stats("_process_swaps: ", show_stats);
+        _progress.advance(run_swaps);
+
+        {
+            // same order as in MemoryEstimation
+            static const char* structures[] = {
+                "depchain_edge_sorter_items", "depchain_pq_items", "depchain_successor_sorter_items",
+                "edge_state_pq_items", "edge_swap_sorter_items", "edge_update_sorter_items",
+                "existence_info_pq_items", "existence_info_sorter_items",
+                "existence_request_sorter_items", "existence_successor_sorter_items"};
+
+            for (size_t i = 0; i < _observed_items.size(); ++i)
+                run_span.counter(structures[i], _observed_items[i]);
+        }
+
+        if (_adaptive_memory)
+            _rebalance_memory();
+        else
+            _observed_items.fill(0);
+    }
+
+    void EdgeSwapTFP::_rebalance_memory() {
+        _mem_est.rebalance(_observed_items);
+        _observed_items.fill(0);
+        _resize_structures();
     }
 
+    void EdgeSwapTFP::_resize_structures() {
+        // all structures are empty at this point (see _reset)
+        _depchain_edge_sorter.reset(new DependencyChainEdgeSorter(DependencyChainEdgeComparatorSorter{}, _mem_est.depchain_edge_sorter()));
+        _depchain_successor_sorter.reset(new DependencyChainSuccessorSorter(DependencyChainSuccessorComparator{}, _mem_est.depchain_successor_sorter()));
+        _existence_request_sorter.reset(new ExistenceRequestSorter(ExistenceRequestComparator{}, _mem_est.existence_request_sorter()));
+        _existence_info_sorter.reset(new ExistenceInfoSorter(ExistenceInfoComparator{}, _mem_est.existence_info_sorter()));
+        _existence_successor_sorter.reset(new ExistenceSuccessorSorter(ExistenceSuccessorComparator{}, _mem_est.existence_successor_sorter()));
+
+        assert(_dependency_chain_pq.empty());
+        _dependency_chain_pq_pool.resize_prefetch(_mem_est.depchain_pq_pool() / DependencyChainEdgePQBlock::raw_size);
+        _dependency_chain_pq_pool.resize_write(_mem_est.depchain_pq_pool() / DependencyChainEdgePQBlock::raw_size);
+
+        assert(_existence_info_pq.empty());
+        _existence_info_pq_pool.resize_prefetch(_mem_est.existence_info_pq_pool() / ExistenceInfoPQBlock::raw_size);
+        _existence_info_pq_pool.resize_write(_mem_est.existence_info_pq_pool() / ExistenceInfoPQBlock::raw_size);
+    }
+
+
+    void EdgeSwapTFP::setHubExistenceIndex(degree_t min_degree, size_t max_requests) {
+        if (_next_swap_id_pushing || !_first_run)
+            throw std::runtime_error("[EdgeSwapTFP] The hub existence index has to be set before swaps are pushed");
+
+        _hub_min_degree = min_degree;
+        _hub_requests = std::vector<ExistenceRequestMsg>();
+        if (!min_degree) {
+            _hub_index.reset();
+            return;
+        }
+
+        _hub_index.reset(new HubEdgeIndex(_num_nodes, min_degree));
+        _hub_index->load(_edges);
+
+        const size_t index_bytes = _hub_index->memory_usage();
+        if (index_bytes >= _mem_est.budget())
+            throw std::runtime_error("[EdgeSwapTFP] The hub existence index takes " + std::to_string(index_bytes)
+                                     + " bytes and exceeds the memory budget");
+
+        _max_hub_requests = max_requests ? max_requests : (_mem_est.budget() - index_bytes) / 8 / sizeof(ExistenceRequestMsg);
+        const size_t buffer_bytes = _max_hub_requests * sizeof(ExistenceRequestMsg);
+
+        std::cout << "Hub existence index holds " << _hub_index->size() << " edges in " << index_bytes
+                  << " bytes; request buffer of " << buffer_bytes << " bytes" << std::endl;
+
+        // the buffer is allocated upfront, so it cannot grow beyond its share
+        _hub_requests.reserve(_max_hub_requests);
+        _mem_est.reserve(index_bytes + buffer_bytes);
+        _resize_structures();
+    }
 
     void EdgeSwapTFP::_start_processing(bool async) {
         // prepare new structures
@@ -852,6 +996,9 @@ namespace EdgeSwapTFP {
         std::swap(_edge_swap_sorter_pushing, _edge_swap_sorter);
         std::swap(_swap_directions_pushing, _swap_directions);
 
+        // the total of push() is only known run by run; runRandomSwaps announces it upfront
+        _progress.add_total(_swap_directions.size());
+
         REPORT_SORTER_STATS(*_edge_swap_sorter);
 
         if (async) {
@@ -874,19 +1021,81 @@ namespace EdgeSwapTFP {
         //_edges.rewind();
     }
 
-    EdgeSwapTFP::MemoryEstimation::size_array_t
-    EdgeSwapTFP::MemoryEstimation::_compute(const size_t& mem, const swapid_t& no_swaps, const degree_t& avg_deg) const {
-        auto format = [] (const size_t& x) {
-            std::string xs = std::to_string(x);
-            return xs;
-            std::string ret;
+    void EdgeSwapTFP::runRandomSwaps(swapid_t number_of_swaps, seed_t seed) {
+        std::ostringstream seed_engine;
+        seed_engine << STDRandomEngine(seed);
 
-            for(int i = xs.size() - 3; i > -3; i -= 3)
-                ret = xs.substr(std::max(0, i), 3) + (ret.empty() ? "" : ",") + ret;
+        _run_random_swaps(RandomSwapsState {_num_nodes, static_cast<edgeid_t>(_edges.size()), _run_length,
+                                            number_of_swaps, 0, 0, seed_engine.str()});
+    }
 
-            return ret;
-        };
+    void EdgeSwapTFP::resumeRandomSwaps(const RandomSwapsState& state) {
+        if (state.run_length != _run_length)
+            throw std::runtime_error("[EdgeSwapTFP] Checkpoint was written with a different run length");
+
+        if (state.num_nodes != _num_nodes || state.num_edges != static_cast<edgeid_t>(_edges.size()))
+            throw std::runtime_error("[EdgeSwapTFP] Checkpoint does not match the edges");
+
+        // continue the numbering of runs, e.g. for the snapshot callback
+        _iteration = state.runs_done;
+        _run_random_swaps(state);
+    }
+
+    void EdgeSwapTFP::_run_random_swaps(RandomSwapsState state) {
+        assert(!_next_swap_id_pushing);
+        if (_process_thread.joinable())
+            _process_thread.join();
+
+        STDRandomEngine seed_gen;
+        {
+            std::istringstream iss(state.seed_engine);
+            iss >> seed_gen;
+            if (!iss)
+                throw std::runtime_error("[EdgeSwapTFP] Invalid state of the seed engine");
+        }
+
+        _progress.add_total(state.total_swaps - state.swaps_done);
+        _last_checkpoint = std::chrono::steady_clock::now();
+
+        for (bool first = true; state.swaps_done < state.total_swaps; first = false) {
+            const swapid_t run_swaps = std::min<uint64_t>(_run_length, state.total_swaps - state.swaps_done);
+
+            // the first run starts from the input (or the checkpoint), so there is nothing to save
+            if (!first && !_checkpoint_filename.empty()) {
+                std::ostringstream seed_engine;
+                seed_engine << seed_gen;
+                state.seed_engine = seed_engine.str();
+                _random_swaps_state = &state;
+            }
+
+            _sorted_requests.reset(new SortedSwapRequestGenerator(run_swaps, _edges.size(), static_cast<seed_t>(seed_gen())));
+
+            _swap_directions.clear();
+            auto directions = _sorted_requests->directions();
+            for (swapid_t i = 0; i < run_swaps; ++i, ++directions)
+                _swap_directions.push(*directions);
+            _swap_directions.consume();
+
+            _process_swaps();
+            _random_swaps_state = nullptr;
+
+            state.swaps_done += run_swaps;
+            state.runs_done++;
+        }
+
+        // apply the updates of the last run
+        _sorted_requests.reset();
+        _swap_directions.clear();
+        _swap_directions.consume();
+        if (_edge_update_sorter_thread && _edge_update_sorter_thread->joinable())
+            _edge_update_sorter_thread->join();
+        _process_swaps();
 
+        _first_run = true;
+    }
+
+    EdgeSwapTFP::MemoryEstimation::size_array_t
+    EdgeSwapTFP::MemoryEstimation::_compute(const size_t& mem, const swapid_t& no_swaps, const degree_t& avg_deg) const {
         auto bceil = [] (const size_t& x, const size_t& bs) -> size_t {
             return ((x + bs - 1) / bs) * bs;
         };
@@ -919,12 +1128,104 @@ namespace EdgeSwapTFP {
             estimate(0.004931, 0.000230, sizeof(ExistenceSuccessorMsg), STXXL_DEFAULT_BLOCK_SIZE(ExistenceSuccessorMsg))
         };
 
+        return _fit(est, mem);
+    }
+
+    void EdgeSwapTFP::MemoryEstimation::rebalance(const volume_array_t& observed_items) {
+        const size_t item_sizes[] = {
+            sizeof(DependencyChainEdgeMsg), sizeof(DependencyChainEdgeMsg), sizeof(DependencyChainSuccessorMsg),
+            sizeof(DependencyChainEdgeMsg), sizeof(EdgeSwapMsg), sizeof(edge_t),
+            sizeof(ExistenceInfoMsg), sizeof(ExistenceInfoMsg), sizeof(ExistenceRequestMsg), sizeof(ExistenceSuccessorMsg)
+        };
+
+        // demand including the multiplicity and some headroom
+        std::array<size_t, std::tuple_size<size_array_t>::value> demand;
+        for (unsigned int i = 0; i < demand.size(); i++)
+            demand[i] = 5 * observed_items[i] * item_sizes[i] * std::get<2>(_sizes[i]) / 4;
+
+        _distribute(demand);
+    }
+
+    void EdgeSwapTFP::MemoryEstimation::reserve(size_t bytes) {
+        if (bytes >= _mem)
+            throw std::runtime_error("[EdgeSwapTFP::MemoryEstimation] Cannot reserve " + std::to_string(bytes)
+                                     + " of " + std::to_string(_mem) + " bytes");
+
+        _mem -= bytes;
+
+        // keep the current proportions
+        std::array<size_t, std::tuple_size<size_array_t>::value> demand;
+        for (unsigned int i = 0; i < demand.size(); i++)
+            demand[i] = std::get<0>(_sizes[i]) * std::get<2>(_sizes[i]);
+
+        _distribute(demand);
+    }
+
+    void EdgeSwapTFP::MemoryEstimation::_distribute(const std::array<size_t, 10>& demand) {
+        const size_t min_blocks = 16 * (stxxl::sort_memory_usage_factor() * 2 + 1);
+
+        // the swap and update sorters hold data across runs and keep their sizes
+        auto is_fixed = [] (unsigned int i) {return i == 4 || i == 5;};
+
+        // EdgeSwapTFP has no edge state PQ (the edge states are merged from the
+        // dependency chain PQ), so this slot is never observed and gets the minimum
+        auto is_unused = [] (unsigned int i) {return i == 3;};
+
+        // every structure first gets its minimum size; the demand beyond that
+        // is served from the remainder
+        size_array_t est = _sizes;
+        std::array<size_t, std::tuple_size<size_array_t>::value> extra_demand {};
+        size_t total_extra_demand = 0;
+        size_t reserved = 0;
+        for (unsigned int i = 0; i < est.size(); i++) {
+            const size_t min_size = std::get<1>(est[i]) * std::get<2>(est[i]) * min_blocks;
+
+            if (is_fixed(i)) {
+                std::get<0>(est[i]) *= std::get<2>(est[i]);
+            } else {
+                extra_demand[i] = is_unused(i) ? 0 : std::max(min_size, demand[i]) - min_size;
+                total_extra_demand += extra_demand[i];
+                std::get<0>(est[i]) = min_size;
+            }
+
+            reserved += std::get<0>(est[i]);
+        }
+
+        // hand out the remaining budget proportional to the extra demand; _fit takes
+        // care if the reserved memory already overshoots
+        if (total_extra_demand && _mem > reserved) {
+            const double scale = 1.0 * (_mem - reserved) / total_extra_demand;
+            for (unsigned int i = 0; i < est.size(); i++) {
+                auto &f = est[i];
+                const size_t bs = std::get<1>(f) * std::get<2>(f);
+                std::get<0>(f) += static_cast<size_t>(extra_demand[i] * scale / bs) * bs;
+            }
+        }
+
+        _sizes = _fit(est, _mem, false);
+    }
+
+    EdgeSwapTFP::MemoryEstimation::size_array_t
+    EdgeSwapTFP::MemoryEstimation::_fit(size_array_t est, const size_t& mem, bool verbose) const {
+        auto format = [] (const size_t& x) {
+            std::string xs = std::to_string(x);
+            return xs;
+            std::string ret;
+
+            for(int i = xs.size() - 3; i > -3; i -= 3)
+                ret = xs.substr(std::max(0, i), 3) + (ret.empty() ? "" : ",") + ret;
+
+            return ret;
+        };
+
+        const size_t min_blocks = 16 * (stxxl::sort_memory_usage_factor() * 2 + 1);
+
         // if the estimation is too large, reduce evenly but do not fall below minimum size
         {
             const size_t total_mem = std::accumulate(est.cbegin(), est.cend(), size_t(0), [] (const size_t& b, const size_block_t& a) -> size_t {return std::get<0>(a) + b;});
             if (total_mem > mem) {
                 const auto at_min =
-                        std::accumulate(est.cbegin(), est.cend(), 0, [&] (const size_t& pref, const size_block_t& a) -> size_t {
+                        std::accumulate(est.cbegin(), est.cend(), size_t(0), [&] (const size_t& pref, const size_block_t& a) -> size_t {
                             return (std::get<0>(a) == std::get<1>(a) * std::get<2>(a) * min_blocks) * std::get<0>(a) + pref;
                 });
 
@@ -935,13 +1236,14 @@ namespace EdgeSwapTFP {
                 }
 
                 const double factor = 1.0 * (total_mem - at_min) / (mem - at_min);
-                std::cout << "Correct Estimation Factor: " << factor << std::endl;
+                if (verbose)
+                    std::cout << "Correct Estimation Factor: " << factor << std::endl;
 
                 for (auto &f : est) {
                     std::get<0>(f) = std::llround(std::get<0>(f) / factor / (std::get<1>(f) * std::get<2>(f))) * std::get<1>(f) * std::get<2>(f);
                     std::get<0>(f) = std::max(std::get<0>(f), std::get<1>(f) * std::get<2>(f) * min_blocks);
                 }
-            } else {
+            } else if (verbose) {
                 std::cout << "Size estimation fits requested size limit" << std::endl;
             }
         }
@@ -961,7 +1263,7 @@ namespace EdgeSwapTFP {
             std::get<0>(x) /= std::get<2>(x);
 
         // Report Assignment
-        {
+        if (verbose) {
 
             std::cout << "Assigned " << format(total_mem) << "b of " << format(mem) << "b (" << (100.0 * total_mem / mem)  << "%) as follows:\n";
 
@@ -3,7 +3,11 @@
 #include <stxxl/vector>
 #include <stxxl/sorter>
 #include <stxxl/bits/unused.h>
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <chrono>
+#include <string>
 #include <thread>
 
 #include <defs.h>
@@ -13,9 +17,14 @@
 
 #include "EdgeSwapBase.h"
 #include "BoolStream.h"
+#include "HubEdgeIndex.h"
 #include <stxxl/priority_queue>
 
 #include <EdgeStream.h>
+#include <SortedSwapRequestGenerator.h>
+#include <Utils/Progress.h>
+#include <Utils/Telemetry.h>
+#include <stxxl/bits/common/seed.h>
 
 namespace EdgeSwapTFP {
     struct EdgeSwapMsg {
@@ -69,6 +78,7 @@ namespace EdgeSwapTFP {
             return (edge < o.edge || (edge == o.edge && (flagged_swap_id > o.flagged_swap_id)));
         }
         DECL_TO_TUPLE(edge, flagged_swap_id);
+        DECL_PACKED_KEY(edge, packed_key::descending(flagged_swap_id));
         DECL_TUPLE_OS(ExistenceRequestMsg);
     };
 
@@ -135,18 +145,59 @@ namespace EdgeSwapTFP {
             size_t existence_request_sorter() const {return std::get<0>(_sizes[8]);}
             size_t existence_successor_sorter() const {return std::get<0>(_sizes[9]);}
 
+            //! Memory split among the structures above
+            size_t budget() const {return _mem;}
+
+
+            //! Number of items observed per data structure (in the order of the getters above)
+            using volume_array_t = std::array<uint64_t, 10>;
 
             MemoryEstimation(const size_t& mem, const swapid_t& no_swaps, const degree_t avg_deg)
-                    : _sizes( _compute(mem, no_swaps, avg_deg) )
+                    : _mem(mem)
+                    , _sizes( _compute(mem, no_swaps, avg_deg) )
             {}
 
+            /**
+             * Splits the memory proportional to the volumes observed in the previous run.
+             * The swap and update sorters keep their sizes and the unused edge state PQ
+             * slot gets the minimum. Unlike the constructor, nothing is printed.
+             */
+            void rebalance(const volume_array_t& observed_items);
+
+            /**
+             * Takes bytes off the budget for IM structures besides the sorters and PQs
+             * (see setHubExistenceIndex) and shrinks the other structures proportionally.
+             * As rebalance(), it keeps the sizes of the swap and update sorters.
+             */
+            void reserve(size_t bytes);
+
         protected:
             using size_block_t = std::tuple<size_t, size_t, size_t>;
             using size_array_t = std::array<size_block_t, 10>;
-            const size_array_t _sizes;
+            size_t _mem;
+            size_array_t _sizes;
+
+            //! Assigns the budget proportional to the demand (in bytes) of the structures which are not fixed
+            void _distribute(const std::array<size_t, 10>& demand);
             size_array_t _compute(const size_t& mem, const swapid_t& no_swaps, const degree_t& avg_deg) const;
+            //! Shrinks est to fit into mem; the assignment is printed if verbose
+            size_array_t _fit(size_array_t est, const size_t& mem, bool verbose = true) const;
         };
-        const MemoryEstimation _mem_est;
+        MemoryEstimation _mem_est;
+
+        //! If set, the memory split is adapted to the volumes observed after each run
+        bool _adaptive_memory;
+        MemoryEstimation::volume_array_t _observed_items;
+
+        void _observe(const size_t structure, const uint64_t items) {
+            if (_adaptive_memory || Telemetry::enabled())
+                _observed_items[structure] = std::max(_observed_items[structure], items);
+        }
+
+        void _rebalance_memory();
+
+        //! Recreates the structures which do not carry data across runs with the sizes of _mem_est
+        void _resize_structures();
 
 // graph
         using edge_buffer_t = EdgeStream;
@@ -162,6 +213,9 @@ namespace EdgeSwapTFP {
         std::unique_ptr<EdgeSwapSorter> _edge_swap_sorter;
         BoolStream _swap_directions;
 
+        // if set, replaces _edge_swap_sorter as source of the current run's requests (see runRandomSwaps)
+        std::unique_ptr<SortedSwapRequestGenerator> _sorted_requests;
+
         swapid_t _next_swap_id_pushing;
         std::unique_ptr<EdgeSwapSorter> _edge_swap_sorter_pushing;
         BoolStream _swap_directions_pushing;
@@ -170,11 +224,11 @@ namespace EdgeSwapTFP {
         // we need to use a desc-comparator since the pq puts the largest element on top
         using DependencyChainEdgeComparatorSorter = typename GenericComparatorStruct<DependencyChainEdgeMsg>::Ascending;
         using DependencyChainEdgeSorter = stxxl::sorter<DependencyChainEdgeMsg, DependencyChainEdgeComparatorSorter>;
-        DependencyChainEdgeSorter _depchain_edge_sorter;
+        std::unique_ptr<DependencyChainEdgeSorter> _depchain_edge_sorter;
 
         using DependencyChainSuccessorComparator = typename GenericComparatorStruct<DependencyChainSuccessorMsg>::Ascending;
         using DependencyChainSuccessorSorter = stxxl::sorter<DependencyChainSuccessorMsg, DependencyChainSuccessorComparator>;
-        DependencyChainSuccessorSorter _depchain_successor_sorter;
+        std::unique_ptr<DependencyChainSuccessorSorter> _depchain_successor_sorter;
 
         std::unique_ptr<std::thread> _depchain_thread;
 
@@ -183,16 +237,40 @@ namespace EdgeSwapTFP {
 // existence requests
         using ExistenceRequestComparator = typename GenericComparatorStruct<ExistenceRequestMsg>::Ascending;
         using ExistenceRequestSorter = stxxl::sorter<ExistenceRequestMsg, ExistenceRequestComparator>;
-        ExistenceRequestSorter _existence_request_sorter;
+        std::unique_ptr<ExistenceRequestSorter> _existence_request_sorter;
+
+        // semi-external mode: requests to hub edges are kept in RAM and answered by _hub_index
+        degree_t _hub_min_degree;
+        size_t _max_hub_requests;
+        std::unique_ptr<HubEdgeIndex> _hub_index;
+        std::vector<ExistenceRequestMsg> _hub_requests;
+        bool _hub_requests_enabled;
+
+        void _push_existence_request(const ExistenceRequestMsg& msg) {
+            if (_hub_requests_enabled && _hub_index->is_hub(msg.edge)) {
+                if (LIKELY(_hub_requests.size() < _max_hub_requests)) {
+                    _hub_requests.push_back(msg);
+                    return;
+                }
+
+                // out of budget: fall back to the sorter for the remainder of this run
+                for (const auto &r : _hub_requests)
+                    _existence_request_sorter->push(r);
+                _hub_requests.clear();
+                _hub_requests_enabled = false;
+            }
+
+            _existence_request_sorter->push(msg);
+        }
 
 // existence information and dependencies
         using ExistenceInfoComparator = typename GenericComparatorStruct<ExistenceInfoMsg>::Ascending;
         using ExistenceInfoSorter = stxxl::sorter<ExistenceInfoMsg, ExistenceInfoComparator>;
-        ExistenceInfoSorter _existence_info_sorter;
+        std::unique_ptr<ExistenceInfoSorter> _existence_info_sorter;
 
         using ExistenceSuccessorComparator = typename GenericComparatorStruct<ExistenceSuccessorMsg>::Ascending;
         using ExistenceSuccessorSorter = stxxl::sorter<ExistenceSuccessorMsg, ExistenceSuccessorComparator>;
-        ExistenceSuccessorSorter _existence_successor_sorter;
+        std::unique_ptr<ExistenceSuccessorSorter> _existence_successor_sorter;
 
 // edge updates
         using EdgeUpdateComparator = typename GenericComparator<edge_t>::Ascending;
@@ -223,8 +301,8 @@ namespace EdgeSwapTFP {
 // algos
         void _gather_edges();
 
-        template <class EdgeReader>
-        void _compute_dependency_chain(EdgeReader&, BoolStream&);
+        template <class EdgeReader, class SwapRequests>
+        void _compute_dependency_chain(EdgeReader&, SwapRequests&, BoolStream&);
 
         void _simulate_swaps();
         void _load_existence();
@@ -233,11 +311,11 @@ namespace EdgeSwapTFP {
 
         void _reset() {
             _edge_swap_sorter->clear();
-            _depchain_edge_sorter.clear();
-            _depchain_successor_sorter.clear();
-            _existence_request_sorter.clear();
-            _existence_info_sorter.clear();
-            _existence_successor_sorter.clear();
+            _depchain_edge_sorter->clear();
+            _depchain_successor_sorter->clear();
+            _existence_request_sorter->clear();
+            _existence_info_sorter->clear();
+            _existence_successor_sorter->clear();
         }
 
         bool _first_run;
@@ -253,6 +331,38 @@ namespace EdgeSwapTFP {
 
         node_t _num_nodes;
 
+        //! Swaps processed; reported by the progress reporter (see Utils/Progress.h)
+        ProgressTask _progress {"TFP swaps"};
+
+    public:
+        /**
+         * State of runRandomSwaps at the start of a run. Together with the
+         * edges at this point, it suffices to continue with the same swaps
+         * as an uninterrupted execution (see setCheckpoint).
+         */
+        struct RandomSwapsState {
+            node_t num_nodes;
+            edgeid_t num_edges;
+            uint64_t run_length;
+            uint64_t total_swaps;
+            uint64_t swaps_done;
+            uint64_t runs_done;
+            std::string seed_engine; //!< textual state of the engine drawing the seed of each run
+        };
+
+    protected:
+// checkpoints
+        std::string _checkpoint_filename;
+        double _checkpoint_interval;
+        std::chrono::steady_clock::time_point _last_checkpoint;
+        unsigned int _checkpoint_slot;
+
+        // state before the current run; only set within runRandomSwaps if a checkpoint may be taken
+        const RandomSwapsState* _random_swaps_state;
+
+        void _run_random_swaps(RandomSwapsState state);
+        void _write_checkpoint();
+
     public:
         EdgeSwapTFP() = delete;
         EdgeSwapTFP(const EdgeSwapTFP &) = delete;
@@ -268,6 +378,8 @@ namespace EdgeSwapTFP {
         ) :
               EdgeSwapBase(),
               _mem_est(im_memory, run_length, edges.size() / num_nodes),
+              _adaptive_memory(false),
+              _observed_items(),
 
               _run_length(run_length),
               _edges(edges),
@@ -276,11 +388,14 @@ namespace EdgeSwapTFP {
               _next_swap_id_pushing(0),
               _edge_swap_sorter_pushing(new EdgeSwapSorter(EdgeSwapComparator(), _mem_est.edge_swap_sorter())),
 
-              _depchain_edge_sorter(DependencyChainEdgeComparatorSorter{}, _mem_est.depchain_edge_sorter()),
-              _depchain_successor_sorter(DependencyChainSuccessorComparator{}, _mem_est.depchain_successor_sorter()),
-              _existence_request_sorter(ExistenceRequestComparator{}, _mem_est.existence_request_sorter()),
-              _existence_info_sorter(ExistenceInfoComparator{}, _mem_est.existence_info_sorter()),
-              _existence_successor_sorter(ExistenceSuccessorComparator{}, _mem_est.existence_successor_sorter()),
+              _depchain_edge_sorter(new DependencyChainEdgeSorter(DependencyChainEdgeComparatorSorter{}, _mem_est.depchain_edge_sorter())),
+              _depchain_successor_sorter(new DependencyChainSuccessorSorter(DependencyChainSuccessorComparator{}, _mem_est.depchain_successor_sorter())),
+              _existence_request_sorter(new ExistenceRequestSorter(ExistenceRequestComparator{}, _mem_est.existence_request_sorter())),
+              _hub_min_degree(0),
+              _max_hub_requests(0),
+              _hub_requests_enabled(false),
+              _existence_info_sorter(new ExistenceInfoSorter(ExistenceInfoComparator{}, _mem_est.existence_info_sorter())),
+              _existence_successor_sorter(new ExistenceSuccessorSorter(ExistenceSuccessorComparator{}, _mem_est.existence_successor_sorter())),
               _edge_update_sorter(EdgeUpdateComparator{}, _mem_est.edge_update_sorter()),
 
               _dependency_chain_pq_pool(_mem_est.depchain_pq_pool() / DependencyChainEdgePQBlock::raw_size,
@@ -295,7 +410,11 @@ namespace EdgeSwapTFP {
 
               _process_swap_callback(cb),
               _iteration(0),
-              _num_nodes(num_nodes)
+              _num_nodes(num_nodes),
+
+              _checkpoint_interval(0),
+              _checkpoint_slot(0),
+              _random_swaps_state(nullptr)
         { }
 
         EdgeSwapTFP(edge_buffer_t &edges, swap_vector &swaps, swapid_t run_length = 1000000) :
@@ -320,6 +439,62 @@ namespace EdgeSwapTFP {
         }
 
         void run();
+
+        /**
+         * Alternative to push() and run(): performs number_of_swaps uniformly
+         * random swaps (as produced by SwapGenerator) in runs of run_length.
+         * The requests of each run are generated in edge id order by a
+         * SortedSwapRequestGenerator, so the swap sorter is skipped entirely.
+         */
+        void runRandomSwaps(swapid_t number_of_swaps, seed_t seed = stxxl::get_next_seed());
+
+        /**
+         * Continues runRandomSwaps from a state returned by loadCheckpoint.
+         * The edges have to be the ones loaded with it and run_length has to
+         * match; otherwise std::runtime_error is thrown.
+         */
+        void resumeRandomSwaps(const RandomSwapsState& state);
+
+        /**
+         * Lets runRandomSwaps write a checkpoint at the start of a run if at
+         * least interval_seconds passed since the previous one. The edges are
+         * stored in thrillbin format (as the snapshots) alternately in
+         * "<filename>.edges0" and "<filename>.edges1", followed by the state
+         * in filename, which is replaced atomically. Hence, the last complete
+         * checkpoint survives a crash at any point. An empty filename disables
+         * checkpoints.
+         */
+        void setCheckpoint(const std::string& filename, double interval_seconds);
+
+        //! Reads a checkpoint written by runRandomSwaps, replaces the content
+        //! of edges by the stored edges and returns the state to resume from.
+        static RandomSwapsState loadCheckpoint(const std::string& filename, edge_buffer_t& edges);
+
+        /**
+         * If enabled, the item counts of all sorters and PQs are recorded during
+         * each run and the memory is re-distributed accordingly before the next
+         * one. The swap and update sorters keep their initial sizes as they hold
+         * data across runs.
+         */
+        void setAdaptiveMemory(bool adaptive) {
+            _adaptive_memory = adaptive;
+        }
+
+        /**
+         * Enables the semi-external mode: node degrees and all edges incident
+         * to a node of degree at least min_degree are kept in RAM. Existence
+         * requests to these edges bypass _existence_request_sorter and are
+         * answered from memory. If more than max_requests of them occur in a
+         * single run, the remaining ones are handled externally; by default,
+         * max_requests is chosen such that the request buffer takes an eighth
+         * of the memory left by the index.
+         *
+         * The index is built right away from the edges, which have to be readable,
+         * and, together with the request buffer, is taken off the memory budget.
+         * Hence, it has to be called before the first swap is pushed.
+         * A min_degree of 0 disables the mode.
+         */
+        void setHubExistenceIndex(degree_t min_degree, size_t max_requests = 0);
     };
 };
 
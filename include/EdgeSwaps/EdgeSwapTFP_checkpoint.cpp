@@ -0,0 +1,154 @@
+#include "EdgeSwapTFP.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <Utils/ExportGraph.h>
+#include <Utils/ThrillBinaryReader.h>
+
+/*
+ * Checkpoint format of runRandomSwaps (all values in host byte order):
+ *  - 8 bytes magic "TFPCKPT1"
+ *  - int64 number of nodes, int64 number of edges
+ *  - uint64 run length, total swaps, swaps done, runs done
+ *  - uint8 slot; the edges are stored in "<filename>.edges<slot>" as thrillbin
+ *  - uint64 length followed by the textual state of the seed engine
+ */
+
+namespace EdgeSwapTFP {
+    namespace {
+        constexpr char checkpoint_magic[8] = {'T', 'F', 'P', 'C', 'K', 'P', 'T', '1'};
+
+        template <typename T>
+        void write_pod(std::ostream& os, const T& value) {
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        T read_pod(std::istream& is) {
+            T value;
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!is)
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] Unexpected end of file");
+            return value;
+        }
+
+        std::string edges_filename(const std::string& filename, unsigned int slot) {
+            return filename + ".edges" + std::to_string(slot);
+        }
+
+        EdgeSwapTFP::RandomSwapsState read_state(const std::string& filename, unsigned int& slot) {
+            std::ifstream is(filename, std::ios::binary);
+            if (!is)
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] Cannot open " + filename);
+
+            char magic[sizeof(checkpoint_magic)];
+            is.read(magic, sizeof(magic));
+            if (!is || !std::equal(magic, magic + sizeof(magic), checkpoint_magic))
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] " + filename + " is not a checkpoint");
+
+            EdgeSwapTFP::RandomSwapsState state;
+            state.num_nodes = static_cast<node_t>(read_pod<int64_t>(is));
+            state.num_edges = static_cast<edgeid_t>(read_pod<int64_t>(is));
+            state.run_length = read_pod<uint64_t>(is);
+            state.total_swaps = read_pod<uint64_t>(is);
+            state.swaps_done = read_pod<uint64_t>(is);
+            state.runs_done = read_pod<uint64_t>(is);
+            slot = read_pod<uint8_t>(is);
+
+            state.seed_engine.resize(read_pod<uint64_t>(is));
+            is.read(&state.seed_engine[0], state.seed_engine.size());
+            if (!is)
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] Unexpected end of file");
+
+            return state;
+        }
+    }
+
+    void EdgeSwapTFP::setCheckpoint(const std::string& filename, double interval_seconds) {
+        _checkpoint_filename = filename;
+        _checkpoint_interval = interval_seconds;
+        _checkpoint_slot = 0;
+
+        // never overwrite the edges of an existing checkpoint before it is replaced
+        if (!filename.empty() && std::ifstream(filename).good()) {
+            try {
+                read_state(filename, _checkpoint_slot);
+            } catch (const std::runtime_error&) {
+                _checkpoint_slot = 0;
+            }
+        }
+    }
+
+    void EdgeSwapTFP::_write_checkpoint() {
+        const auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - _last_checkpoint).count() < _checkpoint_interval)
+            return;
+
+        const RandomSwapsState& state = *_random_swaps_state;
+        const unsigned int slot = 1 - _checkpoint_slot;
+        const std::string edges_file = edges_filename(_checkpoint_filename, slot);
+
+        // remove all parts of the slot, as the new graph may consist of fewer
+        for (size_t part = 0; !std::remove(ThrillBinaryReader::part_filename(edges_file, part).c_str()); ++part) {}
+
+        _edges.rewind();
+        export_as_thrillbin_sorted(_edges, edges_file, _num_nodes);
+        _edges.rewind();
+
+        const std::string tmp = _checkpoint_filename + ".tmp";
+        {
+            std::ofstream os(tmp, std::ios::trunc | std::ios::binary);
+            if (!os)
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] Cannot open " + tmp + " for writing");
+
+            os.write(checkpoint_magic, sizeof(checkpoint_magic));
+            write_pod<int64_t>(os, state.num_nodes);
+            write_pod<int64_t>(os, state.num_edges);
+            write_pod<uint64_t>(os, state.run_length);
+            write_pod<uint64_t>(os, state.total_swaps);
+            write_pod<uint64_t>(os, state.swaps_done);
+            write_pod<uint64_t>(os, state.runs_done);
+            write_pod<uint8_t>(os, slot);
+            write_pod<uint64_t>(os, state.seed_engine.size());
+            os.write(state.seed_engine.data(), state.seed_engine.size());
+
+            os.flush();
+            if (!os)
+                throw std::runtime_error("[EdgeSwapTFP checkpoint] Failed to write " + tmp);
+        }
+
+        if (std::rename(tmp.c_str(), _checkpoint_filename.c_str()))
+            throw std::runtime_error("[EdgeSwapTFP checkpoint] Cannot replace " + _checkpoint_filename);
+
+        _checkpoint_slot = slot;
+        _last_checkpoint = std::chrono::steady_clock::now();
+
+        std::cout << "[EdgeSwapTFP checkpoint] Wrote checkpoint after " << state.swaps_done << " of "
+                  << state.total_swaps << " swaps to " << _checkpoint_filename << " in "
+                  << std::chrono::duration<double>(_last_checkpoint - now).count() << "s" << std::endl;
+    }
+
+    EdgeSwapTFP::RandomSwapsState EdgeSwapTFP::loadCheckpoint(const std::string& filename, edge_buffer_t& edges) {
+        unsigned int slot;
+        RandomSwapsState state = read_state(filename, slot);
+
+        edges.clear();
+        for (ThrillBinaryReader reader(edges_filename(filename, slot)); !reader.empty(); ++reader)
+            edges.push(*reader);
+        edges.consume();
+
+        if (static_cast<edgeid_t>(edges.size()) != state.num_edges)
+            throw std::runtime_error("[EdgeSwapTFP checkpoint] Number of edges stored in " + filename + " does not match");
+
+        std::cout << "[EdgeSwapTFP checkpoint] Loaded " << state.num_edges << " edges after "
+                  << state.swaps_done << " of " << state.total_swaps << " swaps from " << filename << std::endl;
+
+        return state;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+#include <defs.h>
+
+/**
+ * Semi-external edge existence index for high-degree nodes.
+ *
+ * Keeps the degree of every node in RAM (O(n) words) and all edges incident
+ * to at least one hub, i.e. a node with degree >= min_degree, in a hash set.
+ * Edges are distributed over several partitions by the hash of their key,
+ * which keeps each table small and rehashing cheap while the index grows.
+ *
+ * As swaps preserve degrees, the hub property of an edge never changes; the
+ * owner has to reflect performed swaps via erase() and insert().
+ */
+class HubEdgeIndex {
+public:
+    HubEdgeIndex(node_t num_nodes, degree_t min_degree, unsigned int num_partitions = 64)
+        : _min_degree(min_degree)
+        , _partitions(num_partitions)
+    {
+        assert(num_partitions > 0);
+        _degrees.reserve(num_nodes);
+    }
+
+    //! Computes the node degrees in a first and loads the hub edges in a second scan
+    template <typename EdgeReader>
+    void load(EdgeReader & edges) {
+        _degrees.clear();
+        for (auto & p : _partitions)
+            p.clear();
+
+        for (; !edges.empty(); ++edges) {
+            const edge_t & e = *edges;
+            const node_t max_node = std::max(e.first, e.second);
+            if (static_cast<size_t>(max_node) >= _degrees.size())
+                _degrees.resize(max_node + 1, 0);
+
+            _degrees[e.first]++;
+            _degrees[e.second]++;
+        }
+
+        edges.rewind();
+
+        for (; !edges.empty(); ++edges)
+            insert(*edges);
+
+        edges.rewind();
+    }
+
+    //! Returns true if at least one endpoint is a hub
+    bool is_hub(const edge_t & e) const {
+        return _degree(e.first) >= _min_degree || _degree(e.second) >= _min_degree;
+    }
+
+    //! Existence of a hub edge; must not be called for other edges
+    bool exists(const edge_t & e) const {
+        assert(is_hub(e));
+        const uint64_t k = _key(e);
+        return _partition(k).count(k);
+    }
+
+    void insert(const edge_t & e) {
+        if (!is_hub(e))
+            return;
+
+        const uint64_t k = _key(e);
+        _partition(k).insert(k);
+    }
+
+    void erase(const edge_t & e) {
+        if (!is_hub(e))
+            return;
+
+        const uint64_t k = _key(e);
+        _partition(k).erase(k);
+    }
+
+    //! Number of hub edges indexed
+    size_t size() const {
+        size_t result = 0;
+        for (const auto & p : _partitions)
+            result += p.size();
+        return result;
+    }
+
+    //! Approximate RAM consumption of the degrees and the hash sets (buckets and nodes)
+    size_t memory_usage() const {
+        // a node holds the key and the next pointer, plus the allocator's header
+        constexpr size_t node_bytes = sizeof(uint64_t) + 2 * sizeof(void*);
+
+        size_t result = _degrees.capacity() * sizeof(degree_t);
+        for (const auto & p : _partitions)
+            result += p.bucket_count() * sizeof(void*) + p.size() * node_bytes;
+        return result;
+    }
+
+protected:
+    using partition_t = std::unordered_set<uint64_t>;
+
+    const degree_t _min_degree;
+    std::vector<degree_t> _degrees;
+    std::vector<partition_t> _partitions;
+
+    degree_t _degree(const node_t u) const {
+        return static_cast<size_t>(u) < _degrees.size() ? _degrees[u] : 0;
+    }
+
+    static uint64_t _key(const edge_t & e) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(e.first)) << 32) | static_cast<uint32_t>(e.second);
+    }
+
+    partition_t & _partition(const uint64_t k) {
+        return _partitions[std::hash<uint64_t>{}(k * 0x9E3779B97F4A7C15llu) % _partitions.size()];
+    }
+
+    const partition_t & _partition(const uint64_t k) const {
+        return _partitions[std::hash<uint64_t>{}(k * 0x9E3779B97F4A7C15llu) % _partitions.size()];
+    }
+};
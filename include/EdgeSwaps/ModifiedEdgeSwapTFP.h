@@ -70,6 +70,7 @@ namespace ModifiedEdgeSwapTFP {
             return (edge < o.edge || (edge == o.edge && (flagged_swap_id > o.flagged_swap_id)));
         }
         DECL_TO_TUPLE(edge, flagged_swap_id);
+        DECL_PACKED_KEY(edge, packed_key::descending(flagged_swap_id));
         DECL_TUPLE_OS(ExistenceRequestMsg);
     };
 
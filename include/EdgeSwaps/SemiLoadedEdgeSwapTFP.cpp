@@ -32,11 +32,11 @@ namespace EdgeSwapTFP {
         #endif
 
         #ifdef ASYNC_PUSHERS
-            AsyncPusher<DependencyChainEdgeSorter, DependencyChainEdgeMsg> depchain_edge_sorter(_depchain_edge_sorter, 1<<20, 20);
-            AsyncPusher<DependencyChainSuccessorSorter, DependencyChainSuccessorMsg> depchain_successor_sorter(_depchain_successor_sorter);
+            AsyncPusher<DependencyChainEdgeSorter, DependencyChainEdgeMsg> depchain_edge_sorter(*_depchain_edge_sorter, 1<<20, 20);
+            AsyncPusher<DependencyChainSuccessorSorter, DependencyChainSuccessorMsg> depchain_successor_sorter(*_depchain_successor_sorter);
         #else
-            auto & depchain_edge_sorter = _depchain_edge_sorter;
-            auto & depchain_successor_sorter = _depchain_successor_sorter;
+            auto & depchain_edge_sorter = *_depchain_edge_sorter;
+            auto & depchain_successor_sorter = *_depchain_successor_sorter;
         #endif
 
         // For every edge we send the incident vertices to the first swap,
@@ -149,8 +149,8 @@ namespace EdgeSwapTFP {
         #endif
 
         // then sort
-        _depchain_successor_sorter.sort();
-        _depchain_edge_sorter.sort();
+        _depchain_successor_sorter->sort();
+        _depchain_edge_sorter->sort();
     }
 
     void SemiLoadedEdgeSwapTFP::_start_processing(bool) {
@@ -179,6 +179,8 @@ namespace EdgeSwapTFP {
             return;
         }
 
+        const auto run_swaps = _swap_directions.size();
+
         if (_first_run) {
             // first iteration
             _compute_dependency_chain_semi_loaded(_edges, _edge_update_mask);
@@ -228,6 +230,7 @@ namespace EdgeSwapTFP {
 
         // clear loaded edge swaps. the other sorter is cleared in _reset()
         _loaded_edge_swap_sorter->clear();
+        _progress.advance(run_swaps);
 
         if (_updated_edges_callback) {
             if (_edge_update_sorter_thread && _edge_update_sorter_thread->joinable())
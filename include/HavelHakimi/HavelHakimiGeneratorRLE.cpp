@@ -1,4 +1,4 @@
 #include "HavelHakimiGeneratorRLE.h"
 
 template class HavelHakimiGeneratorRLE<DistributionCount<MonotonicPowerlawRandomStream<>>>;
-
+template class HavelHakimiGeneratorRLE<RLEDegreeStream::RunStream>;
@@ -7,6 +7,7 @@
 #include <stxxl/stack>
 #include <utility>
 #include <DistributionCount.h>
+#include <DegreeStream.h>
 #include <Utils/MonotonicPowerlawRandomStream.h>
 
 
@@ -231,3 +232,4 @@ public:
 };
 
 extern template class HavelHakimiGeneratorRLE<DistributionCount<MonotonicPowerlawRandomStream<>>>;
+extern template class HavelHakimiGeneratorRLE<RLEDegreeStream::RunStream>;
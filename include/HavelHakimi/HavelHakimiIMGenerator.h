@@ -5,7 +5,6 @@
 #include <stack>
 #include <assert.h>
 #include <stxxl/bits/common/utils.h>
-#include <stxxl/sequence>
 #include <DegreeStream.h>
 #include "defs.h"
 
@@ -70,15 +69,11 @@ namespace detail {
         edgeid_t _unsatisfied_degree;
         node_t _unsatisfied_nodes;
 
-        using degree_buffer_t = stxxl::sequence<degree_t>;
-        using degree_forward_stream = degree_buffer_t::stream;
-
         //! Degree output
-        degree_buffer_t  _input_degrees;
-        std::unique_ptr<degree_forward_stream> _input_degrees_forward;
+        RLEDegreeStream _input_degrees;
         degree_t _unsatisfied_neighbors = 0;
 
-        DegreeStream _output_degrees;
+        RLEDegreeStream _output_degrees;
         bool _skipped_first = false;
 
         /**
@@ -186,9 +181,9 @@ namespace detail {
             } else {
                 if (DegreesOut) {
                     if (LIKELY(_skipped_first)) {
-                        _output_degrees.push(_input_degrees_forward->operator*() - _unsatisfied_neighbors);
+                        _output_degrees.push(*_input_degrees - _unsatisfied_neighbors);
                         _unsatisfied_neighbors = 0;
-                        _input_degrees_forward->operator++();
+                        ++_input_degrees;
                     } else {
                         _skipped_first = true;
                     }
@@ -253,46 +248,60 @@ namespace detail {
             _unsatisfied_nodes(0)
         {}
 
-        ~HavelHakimiIMGenerator_impl() {
-            _input_degrees_forward.reset(nullptr);
-        }
-
         //! Push a new vertex -represented by its degree- into degree sequence
         void push(degree_t deg) {
+            push(deg, 1);
+        }
+
+        //! Push a run of count vertices with the same degree into degree sequence
+        void push(degree_t deg, node_t count) {
             assert(_mode == Push);
             assert(deg > 0);
 
+            if (UNLIKELY(!count))
+                return;
+
+            const node_t last_node = _push_current_node + count - 1;
+
             if (UNLIKELY(_blocks.empty())) {
-                _blocks.push_back(Block(deg, _push_current_node, _push_current_node));
+                _blocks.push_back(Block(deg, _push_current_node, last_node));
             }
 
             if (_push_direction == IncreasingDegree) {
                 if (LIKELY(_blocks.back().degree == deg)) {
-                    _blocks.back().node_upper = _push_current_node;
+                    _blocks.back().node_upper = last_node;
                 } else {
                     assert(deg > _blocks.back().degree);
-                    _blocks.push_back(Block(deg, _push_current_node, _push_current_node));
+                    _blocks.push_back(Block(deg, _push_current_node, last_node));
                 }
             } else {
                 if (LIKELY(_blocks.front().degree == deg)) {
-                    _blocks.front().node_upper = _push_current_node;
+                    _blocks.front().node_upper = last_node;
                 } else {
                     assert(deg < _blocks.back().degree);
                     _blocks.push_front(
-                        Block(deg, _push_current_node, _push_current_node));
+                        Block(deg, _push_current_node, last_node));
                 }
             }
 
-            ++_push_current_node;
-            _max_number_of_edges += deg;
+            _push_current_node += count;
+            _max_number_of_edges += static_cast<edgeid_t>(deg) * count;
 
             if (DegreesOut)
-                _input_degrees.push_back(deg);
+                _input_degrees.push(deg, count);
+        }
+
+        //! Push a run-length encoded degree sequence
+        void push(RLEDegreeStream &degrees) {
+            for (; !degrees.empty(); degrees.next_run())
+                push(degrees.current_run().value,
+                     static_cast<node_t>(degrees.run_remaining()));
         }
 
         //! Switch to generation mode; the streaming interface become available
         void generate() {
-            _input_degrees_forward.reset(new degree_forward_stream(_input_degrees));
+            if (DegreesOut)
+                _input_degrees.rewind();
 
             assert(_mode == Push);
 
@@ -331,12 +340,12 @@ namespace detail {
 
         //! Push rest of degrees into output degree stream
         void finalize() {
-            for (; !_input_degrees_forward->empty(); _input_degrees_forward->operator++())
-                _output_degrees.push(_input_degrees_forward->operator*());
+            for (; !_input_degrees.empty(); _input_degrees.next_run())
+                _output_degrees.push(*_input_degrees, _input_degrees.run_remaining());
             assert(_output_degrees.size() == static_cast<size_t>(_push_current_node - _initial_node));
         }
 
-        DegreeStream& get_degree_stream() {
+        RLEDegreeStream& get_degree_stream() {
             return _output_degrees;
         }
 
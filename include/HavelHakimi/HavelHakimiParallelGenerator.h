@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @brief Havel-Hakimi generator materialising edges in parallel
+ */
+#pragma once
+
+#include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <vector>
+#include <omp.h>
+
+/**
+ * @brief Havel-Hakimi generator with block-parallel edge emission
+ *
+ * Produces exactly the same edge sequence as HavelHakimiIMGenerator. Instead of
+ * emitting one edge at a time, the block structure is simulated per source node,
+ * i.e. each source records the node ranges (segments) it connects to, which costs
+ * time proportional to the number of blocks touched rather than to the degree.
+ * Once the segments cover a batch of edges, the batch is written by all threads
+ * into a buffer using the prefix sum over the segment sizes; the stream interface
+ * then serves edges from this buffer.
+ */
+class HavelHakimiParallelGenerator : protected detail::HavelHakimiIMGenerator_impl<false> {
+    using Base = detail::HavelHakimiIMGenerator_impl<false>;
+
+public:
+    using PushDirection = Base::PushDirection;
+    using value_type = Base::value_type;
+
+    static constexpr PushDirection IncreasingDegree = Base::IncreasingDegree;
+    static constexpr PushDirection DecreasingDegree = Base::DecreasingDegree;
+
+protected:
+    struct Segment {
+        node_t source;
+        node_t lower;
+        node_t upper; // inclusive
+    };
+
+    const edgeid_t _batch_size;
+    bool _sources_left;
+
+    std::vector<Segment> _segments;
+    std::vector<edgeid_t> _segment_offsets;
+    std::vector<edge_t> _buffer;
+    size_t _buffer_pos;
+
+    /**
+     * Block-granular version of _fetch_next_edge/_checkout_block: takes the next source
+     * and checks out all blocks it connects to. Returns false if no source is left.
+     */
+    bool _simulate_source() {
+        _restore_blocks();
+
+        if (UNLIKELY(_blocks.empty())) {
+            std::cout << "HH generate sequence with "
+                      << (_push_current_node - _initial_node)
+                      << " nodes and " << _max_number_of_edges << " req. edges; "
+                      << " reqs for " << _unsatisfied_nodes << " nodes and "
+                      << _unsatisfied_degree << " edges unsatisfied"
+                      << std::endl;
+            return false;
+        }
+
+        auto &source_block = _blocks.back();
+        const node_t source = source_block.node_lower++;
+        degree_t remaining = source_block.degree;
+        if (source_block.node_lower > source_block.node_upper)
+            _blocks.pop_back();
+
+        while (remaining) {
+            if (UNLIKELY(_blocks.empty())) {
+                _unsatisfied_nodes++;
+                _unsatisfied_degree += remaining;
+                break;
+            }
+
+            auto block = _blocks.back();
+            if (block.size() > remaining) {
+                // partially consume block, i.e. keep lower ids at higher degree
+                _blocks.back().node_upper -= remaining;
+                block.node_lower = _blocks.back().node_upper + 1;
+
+                _blocks_checkedout.push(_blocks.back());
+                _blocks.pop_back();
+            } else {
+                _blocks.pop_back();
+            }
+
+            --block.degree;
+            _blocks_checkedout.push(block);
+
+            _segments.push_back(Segment{source, block.node_lower, block.node_upper});
+            remaining -= block.size();
+        }
+
+        return true;
+    }
+
+    void _fill_buffer() {
+        _segments.clear();
+        edgeid_t number_of_edges = 0;
+
+        while (_sources_left && number_of_edges < _batch_size) {
+            const size_t first = _segments.size();
+            _sources_left = _simulate_source();
+            for (size_t i = first; i < _segments.size(); ++i)
+                number_of_edges += _segments[i].upper - _segments[i].lower + 1;
+        }
+
+        _segment_offsets.resize(_segments.size());
+        {
+            edgeid_t offset = 0;
+            for (size_t i = 0; i < _segments.size(); ++i) {
+                _segment_offsets[i] = offset;
+                offset += _segments[i].upper - _segments[i].lower + 1;
+            }
+        }
+
+        _buffer.resize(number_of_edges);
+
+        #pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < _segments.size(); ++i) {
+            const Segment seg = _segments[i];
+            edge_t* out = _buffer.data() + _segment_offsets[i];
+            for (node_t v = seg.lower; v <= seg.upper; ++v)
+                *(out++) = edge_t(seg.source, v);
+        }
+
+        _buffer_pos = 0;
+        _empty = _buffer.empty();
+    }
+
+public:
+    HavelHakimiParallelGenerator(PushDirection push_direction = IncreasingDegree,
+                                 node_t initial_node = 0,
+                                 edgeid_t batch_size = edgeid_t(1) << 20)
+        : Base(push_direction, initial_node)
+        , _batch_size(batch_size)
+        , _sources_left(false)
+        , _buffer_pos(0)
+    {
+        _empty = true;
+    }
+
+    using Base::push;
+    using Base::unsatisfiedDegree;
+    using Base::unsatisfiedNodes;
+
+    //! Switch to generation mode; the streaming interface become available
+    void generate() {
+        assert(_mode == Push);
+
+        _max_number_of_edges /= 2;
+
+        // If the degree sequence was provided in increasing order, we have to
+        // reverse the node ids
+        if (_push_direction == IncreasingDegree) {
+            for (auto &block : _blocks) {
+                auto tmp = _push_current_node - 1 - block.node_lower + _initial_node;
+                block.node_lower =
+                    _push_current_node - 1 - block.node_upper + _initial_node;
+                block.node_upper = tmp;
+            }
+        }
+
+        std::cout << "HH Queue size: " << _blocks.size() << " for "
+                  << (_push_current_node - _initial_node) << " nodes\n";
+
+        _mode = Generate;
+        _sources_left = true;
+        _fill_buffer();
+    }
+
+    HavelHakimiParallelGenerator &operator++() {
+        assert(_mode == Generate);
+        assert(!_empty);
+
+        if (++_buffer_pos == _buffer.size())
+            _fill_buffer();
+
+        return *this;
+    }
+
+    const value_type &operator*() const {
+        assert(_mode == Generate);
+        return _buffer[_buffer_pos];
+    }
+
+    const value_type *operator->() const {
+        assert(_mode == Generate);
+        return &_buffer[_buffer_pos];
+    }
+
+    bool empty() const {
+        return _empty;
+    }
+
+    edgeid_t maxEdges() const {
+        assert(_mode == Generate);
+        return _max_number_of_edges;
+    }
+};
@@ -1,8 +1,13 @@
 #include <LFR/CommunityEdgeRewiringSwaps.h>
 #include <EdgeSwaps/EdgeSwapInternalSwapsBase_impl.h>
 #include <Utils/RandomBoolStream.h>
+#include <EdgeExistenceInformation.h>
+#include <memory>
+#include <unordered_set>
+#include <omp.h>
 
 #include <Utils/RandomSeed.h>
+#include <Utils/Progress.h>
 
 //#define EXIT_AFTER_COM_REWIRING
 
@@ -15,11 +20,13 @@ void CommunityEdgeRewiringSwaps::run() {
     unsigned int retry_count = 0;
 
     unsigned int iterations = 0;
+    ProgressTask progress("LFR community rewiring iterations");
 
     const bool addition_random = _random_edge_ratio > std::numeric_limits<double>::epsilon();
 
     while (true) {
         ++iterations;
+        progress.advance();
 
         // generate vector of struct { community, duplicate edge, partner edge }.
         std::vector<community_swap_edges_t> com_swap_edges;
@@ -391,7 +398,9 @@ void CommunityEdgeRewiringSwaps::run() {
         assert(_edge_ids_in_current_swaps.size() == _edges_in_current_swaps.size());
 
 
-        {
+        if (_parallel) {
+            executeSwapsPerCommunity();
+        } else {
             EdgeReaderWrapper edgeReader(_community_edges);
             executeSwaps(_current_swaps, _edges_in_current_swaps, _swap_has_successor, edgeReader);
         }
@@ -405,6 +414,232 @@ void CommunityEdgeRewiringSwaps::run() {
 #endif
 }
 
+void CommunityEdgeRewiringSwaps::executeSwapsPerCommunity() {
+    const swapid_t num_swaps = _current_swaps.size();
+    if (!num_swaps)
+        return;
+
+    auto is_trivial = [] (const swap_descriptor& s) {
+        return s.edges()[0] == s.edges()[1] || s.edges()[0] == -1;
+    };
+
+    // partition swaps by community while keeping their order
+    std::vector<swapid_t> swaps_by_community(num_swaps);
+    std::vector<swapid_t> community_begin;
+    {
+        community_t num_communities = 0;
+        for (const auto& c : _community_of_current_edge)
+            num_communities = std::max(num_communities, c + 1);
+
+        community_begin.assign(num_communities + 1, 0);
+        for (const auto& s : _current_swaps)
+            if (!is_trivial(s))
+                ++community_begin[_community_of_current_edge[s.edges()[0]] + 1];
+
+        for (community_t c = 0; c < num_communities; ++c)
+            community_begin[c + 1] += community_begin[c];
+
+        std::vector<swapid_t> pos(community_begin.begin(), community_begin.end() - 1);
+        for (swapid_t sid = 0; sid < num_swaps; ++sid) {
+            const auto& s = _current_swaps[sid];
+            if (!is_trivial(s))
+                swaps_by_community[pos[_community_of_current_edge[s.edges()[0]]]++] = sid;
+        }
+    }
+    const community_t num_communities = static_cast<community_t>(community_begin.size()) - 1;
+    const int num_threads = omp_get_max_threads();
+
+    EdgeExistenceInformation existence(num_swaps);
+    existence.start_initialization();
+
+    // simulate swaps of each community to obtain all edges that might be targets
+    // (cf. EdgeSwapInternalSwapsBase::simulateSwapsAndGenerateEdgeExistenceQuery)
+    using query_t = std::pair<edge_t, swapid_t>;
+    std::vector<std::vector<query_t>> thread_queries(num_threads);
+    {
+        // internal edges are never shared by swaps of different communities
+        std::vector<std::vector<edge_t>> possible_edges(_edges_in_current_swaps.size());
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            auto& queries = thread_queries[omp_get_thread_num()];
+            std::vector<edge_t> current_edges[2];
+            std::vector<edge_t> new_edges[2];
+
+            #pragma omp for schedule(dynamic, 1)
+            for (community_t com = 0; com < num_communities; ++com) {
+                for (swapid_t i = community_begin[com]; i < community_begin[com + 1]; ++i) {
+                    const swapid_t sid = swaps_by_community[i];
+                    const auto& eids = _current_swaps[sid].edges();
+
+                    for (unsigned char spos = 0; spos < 2; ++spos) {
+                        current_edges[spos].clear();
+                        new_edges[spos].clear();
+                        if (!possible_edges[eids[spos]].empty())
+                            current_edges[spos] = std::move(possible_edges[eids[spos]]);
+                        current_edges[spos].push_back(_edges_in_current_swaps[eids[spos]]);
+                    }
+
+                    for (const auto &e0 : current_edges[0]) {
+                        for (const auto &e1 : current_edges[1]) {
+                            edge_t t[2];
+                            std::tie(t[0], t[1]) = _swap_edges(e0, e1, _current_swaps[sid].direction());
+
+                            if (t[0].first != t[0].second && t[1].first != t[1].second) {
+                                for (unsigned char spos = 0; spos < 2; ++spos)
+                                    new_edges[spos].push_back(t[spos]);
+                            }
+                        }
+                    }
+
+                    for (unsigned char spos = 0; spos < 2; ++spos) {
+                        std::sort(new_edges[spos].begin(), new_edges[spos].end());
+                        new_edges[spos].erase(std::unique(new_edges[spos].begin(), new_edges[spos].end()), new_edges[spos].end());
+
+                        for (const auto &e : new_edges[spos])
+                            queries.emplace_back(e, sid);
+                        existence.add_possible_info(sid, new_edges[spos].size());
+
+                        if (_swap_has_successor[spos][sid]) {
+                            current_edges[spos].pop_back();
+                            std::sort(current_edges[spos].begin(), current_edges[spos].end());
+                            possible_edges[eids[spos]].clear();
+                            std::set_union(current_edges[spos].begin(), current_edges[spos].end(),
+                                           new_edges[spos].begin(), new_edges[spos].end(),
+                                           std::back_inserter(possible_edges[eids[spos]]));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    existence.finish_initialization();
+
+    std::vector<query_t> queries;
+    {
+        size_t total = 0;
+        for (const auto& q : thread_queries)
+            total += q.size();
+
+        queries.reserve(total);
+        for (auto& q : thread_queries) {
+            queries.insert(queries.end(), q.begin(), q.end());
+            std::vector<query_t>().swap(q);
+        }
+    }
+    SEQPAR::sort(queries.begin(), queries.end());
+
+    std::cout << "Requesting " << queries.size() << " (possibly non-unique) possible conflict edges" << std::endl;
+
+    // answer existence queries; every thread reads the range of community edges covering its queries
+    {
+        using const_iterator = edge_community_vector_t::const_iterator;
+        auto by_edge = [] (const edge_community_t& a, const edge_t& e) {return a.edge < e;};
+
+        // chunk boundaries must not split queries of the same edge
+        std::vector<size_t> query_begin(num_threads + 1, queries.size());
+        query_begin[0] = 0;
+        for (int t = 1; t < num_threads; ++t) {
+            size_t i = std::max(query_begin[t - 1], queries.size() * t / num_threads);
+            while (i > query_begin[t - 1] && i < queries.size() && queries[i].first == queries[i - 1].first)
+                ++i;
+            query_begin[t] = i;
+        }
+
+        // the vector is not thread-safe, so ranges are determined in advance
+        std::vector<const_iterator> range_begin(num_threads + 1, _community_edges.cend());
+        for (int t = 0; t < num_threads; ++t) {
+            if (query_begin[t] < queries.size())
+                range_begin[t] = std::lower_bound(_community_edges.cbegin(), _community_edges.cend(), queries[query_begin[t]].first, by_edge);
+        }
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            const int tid = omp_get_thread_num();
+            auto q = queries.cbegin() + query_begin[tid];
+            const auto q_end = queries.cbegin() + query_begin[tid + 1];
+
+            if (q != q_end) {
+                std::unique_ptr<edge_community_vector_t::bufreader_type> reader;
+                #pragma omp critical (_community_edge_reader)
+                reader.reset(new edge_community_vector_t::bufreader_type(range_begin[tid], range_begin[tid + 1]));
+
+                while (q != q_end) {
+                    const edge_t e = q->first;
+                    while (!reader->empty() && (*reader)->edge < e)
+                        ++(*reader);
+
+                    const bool found = !reader->empty() && (*reader)->edge == e;
+                    for (; q != q_end && q->first == e; ++q) {
+                        if (found) {
+                            existence.push_exists(q->second, e);
+                        } else {
+                            existence.push_missing(q->second);
+                        }
+                    }
+                }
+
+                #pragma omp critical (_community_edge_reader)
+                reader.reset();
+            }
+        }
+    }
+    std::vector<query_t>().swap(queries);
+
+    // perform swaps of each community in order
+    swapid_t no_performed = 0;
+    swapid_t no_conflicts = 0;
+    swapid_t no_loops = 0;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads) reduction(+: no_performed, no_conflicts, no_loops)
+    for (community_t com = 0; com < num_communities; ++com) {
+        // edges created within this community in this round
+        std::unordered_set<uint64_t> created;
+        auto key = [] (const edge_t& e) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(e.first)) << 32) | static_cast<uint32_t>(e.second);
+        };
+
+        for (swapid_t i = community_begin[com]; i < community_begin[com + 1]; ++i) {
+            const swapid_t sid = swaps_by_community[i];
+            const auto& eids = _current_swaps[sid].edges();
+
+            edge_t s_edges[2] = {_edges_in_current_swaps[eids[0]], _edges_in_current_swaps[eids[1]]};
+            edge_t t_edges[2];
+            std::tie(t_edges[0], t_edges[1]) = _swap_edges(s_edges[0], s_edges[1], _current_swaps[sid].direction());
+
+            if (t_edges[0].first == t_edges[0].second || t_edges[1].first == t_edges[1].second) {
+                ++no_loops;
+                continue;
+            }
+
+            existence.wait_for_missing(sid);
+
+            bool conflict = false;
+            for (unsigned char spos = 0; spos < 2; ++spos) {
+                const bool c = existence.exists(sid, t_edges[spos]) || created.count(key(t_edges[spos]));
+                no_conflicts += c;
+                conflict |= c;
+            }
+
+            if (conflict)
+                continue;
+
+            for (unsigned char spos = 0; spos < 2; ++spos) {
+                _edges_in_current_swaps[eids[spos]] = t_edges[spos];
+                created.erase(key(s_edges[spos]));
+                created.insert(key(t_edges[spos]));
+            }
+
+            ++no_performed;
+        }
+    }
+
+    std::cout << "Performed " << no_performed << " out of " << num_swaps << " swaps ("
+              "loops: " << no_loops << " conflicts: " << no_conflicts << ")"
+              << std::endl;
+}
+
 // fallback, if we dont converge -- then just delete duplicates
 void CommunityEdgeRewiringSwaps::deleteDuplicates() {
     if (UNLIKELY(_community_edges.empty()))
@@ -67,12 +67,24 @@ private:
     std::array<std::vector<bool>, 2> _swap_has_successor;
 
     const double _random_edge_ratio;
+    const bool _parallel;
 
     template <typename Callback>
     void loadAndStoreEdges(Callback callback);
 
     void deleteDuplicates();
 
+    /**
+     * Parallel alternative to executeSwaps(): as both edges of a swap belong to the same
+     * community, the swaps are partitioned by community and each community is simulated
+     * and executed by a single thread in the original order. Existence queries are
+     * answered by parallel readers over disjoint ranges of the community edges and
+     * distributed using EdgeExistenceInformation. Edges created or removed by swaps of
+     * other communities in the same round are not visible; resulting duplicates are
+     * found again in the next round.
+     */
+    void executeSwapsPerCommunity();
+
     class EdgeReaderWrapper {
     private:
         stxxl::vector<edge_community_t>::bufreader_type _reader;
@@ -112,10 +124,13 @@ private:
     };
 
 public:
-    CommunityEdgeRewiringSwaps(stxxl::vector<edge_community_t> &intra_edges, const size_t& max_swaps, const double& random_edge_ratio)
-            : _community_edges(intra_edges)
+    CommunityEdgeRewiringSwaps(stxxl::vector<edge_community_t> &intra_edges, const size_t& max_swaps, const double& random_edge_ratio,
+                               const uint_t& sorter_mem = SORTER_MEM, const bool parallel = true)
+            : EdgeSwapInternalSwapsBase(sorter_mem)
+            , _community_edges(intra_edges)
             , _max_swaps(max_swaps)
             , _random_edge_ratio(random_edge_ratio)
+            , _parallel(parallel)
     {};
 
     void run();
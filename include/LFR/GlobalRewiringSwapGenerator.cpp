@@ -1,8 +1,9 @@
 #include <LFR/GlobalRewiringSwapGenerator.h>
 #include <stxxl/priority_queue>
 
-GlobalRewiringSwapGenerator::GlobalRewiringSwapGenerator(const stxxl::vector< LFR::CommunityAssignment > &communityAssignment, edgeid_t numEdges, seed_t seed)
-    : _edge_community_input_sorter(new edge_community_sorter_t(GenericComparatorStruct<EdgeCommunity>::Ascending(), SORTER_MEM)),
+GlobalRewiringSwapGenerator::GlobalRewiringSwapGenerator(const stxxl::vector< LFR::CommunityAssignment > &communityAssignment, edgeid_t numEdges, seed_t seed, uint_t sorter_mem)
+    : _sorter_mem(sorter_mem),
+      _edge_community_input_sorter(new edge_community_sorter_t(GenericComparatorStruct<EdgeCommunity>::Ascending(), _sorter_mem)),
       _num_edges(numEdges),
       _empty(true),
       _rand_gen(seed),
@@ -10,7 +11,7 @@ GlobalRewiringSwapGenerator::GlobalRewiringSwapGenerator(const stxxl::vector< LF
       _bool_stream(_rand_gen())
     {
 
-    stxxl::sorter<NodeCommunity, GenericComparatorStruct<NodeCommunity>::Ascending> node_community_sorter(GenericComparatorStruct<NodeCommunity>::Ascending(), SORTER_MEM);
+    stxxl::sorter<NodeCommunity, GenericComparatorStruct<NodeCommunity>::Ascending> node_community_sorter(GenericComparatorStruct<NodeCommunity>::Ascending(), _sorter_mem);
     #pragma omp critical (_community_assignment)
     {
         stxxl::vector<LFR::CommunityAssignment>::bufreader_type communityReader(communityAssignment);
@@ -27,6 +27,7 @@ public:
 
 private:
     stxxl::sequence<NodeCommunity> _node_communities;
+    const uint_t _sorter_mem; //!< memory of each of the sorters
     using edge_community_sorter_t = stxxl::sorter<EdgeCommunity, GenericComparatorStruct<EdgeCommunity>::Ascending>;
     std::unique_ptr<stxxl::sequence<NodeCommunity>::stream> _node_community_reader; // when storing this by value, the end iterator is initialized too early...
     std::unique_ptr<edge_community_sorter_t> _edge_community_input_sorter;
@@ -43,7 +44,8 @@ private:
     RandomBoolStream _bool_stream;
 
 public:
-    GlobalRewiringSwapGenerator(const stxxl::vector<LFR::CommunityAssignment> &communityAssignment, edgeid_t numEdges, seed_t seed);
+    GlobalRewiringSwapGenerator(const stxxl::vector<LFR::CommunityAssignment> &communityAssignment, edgeid_t numEdges, seed_t seed,
+                                uint_t sorter_mem = SORTER_MEM);
 
     /**
      * Add edges that shall be checked for conflicts by providing an STXXL stream interface to the edges.
@@ -66,7 +68,7 @@ public:
             // Note also that input does not contain any sorter, so this does not initialize the output sorter without sorting or discard any input.
             std::swap(_edge_community_input_sorter, _edge_community_output_sorter);
         } else {
-            _edge_community_input_sorter.reset(new edge_community_sorter_t(edge_community_sorter_t::cmp_type(), SORTER_MEM));
+            _edge_community_input_sorter.reset(new edge_community_sorter_t(edge_community_sorter_t::cmp_type(), _sorter_mem));
         }
 
         decltype(_node_communities)::stream nodeCommunityReader(_node_communities);
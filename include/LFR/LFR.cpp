@@ -90,6 +90,12 @@ namespace LFR {
 
         _node_sorter.sort();
         std::cout << "Degree sum: " << _degree_sum << " Membership sum: " << memebership_sum << "\n";
+
+        // now the volumes of all phases are known
+        _memory_plan.plan(memebership_sum, _degree_sum, _mixing,
+                          static_cast<node_t>(_community_distribution_params.maxDegree),
+                          _overlap_max_memberships > 1);
+        _memory_plan.report(std::cout);
     }
 
 
@@ -150,15 +156,25 @@ namespace LFR {
         {
             IOStatistics iols("LFR");
 
-            _compute_node_distributions();
-            _compute_community_size();
-            _correct_community_sizes();
-            _compute_community_assignments();
+            if (_checkpoint_load_filename.empty()) {
+                _compute_node_distributions();
+                if (_internal_memory)
+                    _check_internal_memory();
+
+                _compute_community_size();
+                _correct_community_sizes();
+                _compute_community_assignments();
+            } else {
+                _load_checkpoint(_checkpoint_load_filename);
+                if (_internal_memory)
+                    _check_internal_memory();
+            }
             _verify_assignment();
 
-            // the merging of the communities needs a sorter
-            _max_memory_usage -= SORTER_MEM;
-            STXXL_MSG("Remaining memory for actual swaps is " << _max_memory_usage << " bytes");
+            if (!_checkpoint_save_filename.empty())
+                _save_checkpoint(_checkpoint_save_filename);
+
+            STXXL_MSG("Memory for global swaps is " << _memory_plan[MemoryPlanner::GlobalSwaps] << " bytes");
             STXXL_MSG("Degree sum is " << _degree_sum);
 
             int_t globalSwapsPerIteration = std::max<int_t>(std::min<int_t>(1<<0, _degree_sum/ 2 * _mixing), (_degree_sum / 2 * _mixing) / 4);
@@ -166,36 +182,40 @@ namespace LFR {
             STXXL_MSG("Doing " << globalSwapsPerIteration << " swaps per iteration for global swaps");
             // subtract actually used amount of memory (so more memory is possibly available for communities)
 
-            {
-                IOStatistics ios("GenCommGraphs");
-                const bool is_disjoint = (_overlap_method == OverlapMethod::constDegree && _overlap_config.constDegree.overlappingNodes == 0);
-                if (is_disjoint) {
-                    _generate_community_graphs<true>();
-                } else {
-                    _generate_community_graphs<false>();
+            if (_internal_memory) {
+                _generate_graph_internal();
+            } else {
+                {
+                    IOStatistics ios("GenCommGraphs");
+                    const bool is_disjoint = (_overlap_method == OverlapMethod::constDegree && _overlap_config.constDegree.overlappingNodes == 0);
+                    if (is_disjoint) {
+                        _generate_community_graphs<true>();
+                    } else {
+                        _generate_community_graphs<false>();
+                    }
+
+                    std::cout << "Current EM allocation after GenCommGraphs: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
+                    std::cout << "Maximum EM allocation after GenCommGraphs: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
+                }
+                {
+                    IOStatistics ios("GenGlobGraph");
+                    _generate_global_graph(globalSwapsPerIteration);
+                    std::cout << "Current EM allocation after GenGlobGraph: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
+                    std::cout << "Maximum EM allocation after GenGlobGraph: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
+                }
+                {
+                    IOStatistics ios("MergeGraphs");
+                    _merge_community_and_global_graph();
+                    std::cout << "Current EM allocation after MergeGraphs: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
+                    std::cout << "Maximum EM allocation after MergeGraphs: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
                 }
 
-                std::cout << "Current EM allocation after GenCommGraphs: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
-                std::cout << "Maximum EM allocation after GenCommGraphs: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
-            }
-            {
-                IOStatistics ios("GenGlobGraph");
-                _generate_global_graph(globalSwapsPerIteration);
-                std::cout << "Current EM allocation after GenGlobGraph: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
-                std::cout << "Maximum EM allocation after GenGlobGraph: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
-            }
-            {
-                IOStatistics ios("MergeGraphs");
-                _merge_community_and_global_graph();
-                std::cout << "Current EM allocation after MergeGraphs: " <<  stxxl::block_manager::get_instance()->get_current_allocation() << std::endl;
-                std::cout << "Maximum EM allocation after MergeGraphs: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
-            }
-
-            std::cout << "Resulting graph has " << _edges.size() << " edges, " << _intra_community_edges.size() << " of them are intra-community edges and " <<
-            _inter_community_edges.size() << " of them are inter-community edges. Mixing: "
-            << (static_cast<double>(_inter_community_edges.size()) / _edges.size())
+                std::cout << "Resulting graph has " << _edges.size() << " edges, " << _intra_community_edges.size() << " of them are intra-community edges and " <<
+                _inter_community_edges.size() << " of them are inter-community edges. Mixing: "
+                << (static_cast<double>(_inter_community_edges.size()) / _edges.size())
 
-            << std::endl;
+                << std::endl;
+            }
         }
 
         _verify_result_graph();
@@ -3,12 +3,17 @@
 #include <defs.h>
 #include "TupleHelper.h"
 
+#include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 #include <SyncWorker.h>
 #include <Utils/MonotonicPowerlawRandomStream.h>
 #include <stxxl/sorter>
 #include <stxxl/vector>
 #include <EdgeStream.h>
+#include "LFRMemoryPlanner.h"
+#include "LFRVerificationReport.h"
 
 //#define LFR_TESTING
 
@@ -48,17 +53,27 @@ public:
 };
 
 class NodeDegreeMembershipInternalDegComparator {
-    const double _mixing;
+    double _mixing;
+    bool _break_ties;
 
 public:
-    NodeDegreeMembershipInternalDegComparator(double m) : _mixing(m) {}
+    /**
+     * If @a break_ties is set, the memberships break ties, so that nodes equal under
+     * this order are identical and the order is reproducible (as needed for checkpoints).
+     * This changes the node order and hence the generated graph for a given seed.
+     */
+    NodeDegreeMembershipInternalDegComparator(double m, bool break_ties = false) : _mixing(m), _break_ties(break_ties) {}
 
     bool operator()(const NodeDegreeMembership &a, const NodeDegreeMembership &b) const {
         auto ai = a.intraCommunityDegree(_mixing,0);
         auto bi = b.intraCommunityDegree(_mixing,0);
+        if (_break_ties)
+            return std::tie(ai, a.degree(), a.ceil(), a.memberships()) > std::tie(bi, b.degree(), b.ceil(), b.memberships());
         return std::tie(ai, a.degree(), a.ceil()) > std::tie(bi, b.degree(), b.ceil());
     }
 
+    double mixing() const {return _mixing;}
+
     NodeDegreeMembership max_value() const {
         return {std::numeric_limits<degree_t>::min(),
                 std::numeric_limits<community_t>::max(), true};
@@ -69,6 +84,82 @@ public:
     }
 };
 
+/**
+ * Nodes sorted by NodeDegreeMembershipInternalDegComparator with the interface of
+ * an stxxl::sorter. The nodes are kept in an stxxl::sorter or, for the internal
+ * memory backend, in a std::vector which is sorted in parallel.
+ */
+class NodeDegreeMembershipSorter {
+    using comparator_t = NodeDegreeMembershipInternalDegComparator;
+    using em_sorter_t = stxxl::sorter<NodeDegreeMembership, comparator_t>;
+
+    comparator_t _comp;
+    uint_t _memory;
+
+    std::unique_ptr<em_sorter_t> _em_sorter;
+    std::vector<NodeDegreeMembership> _im_nodes;
+    size_t _im_position;
+
+public:
+    NodeDegreeMembershipSorter(const comparator_t& comp, uint_t memory)
+        : _comp(comp), _memory(memory), _em_sorter(new em_sorter_t(comp, memory)), _im_position(0)
+    {}
+
+    //! Switches between the EM and the IM container; discards all nodes
+    void setInternalMemory(bool internal) {
+        std::vector<NodeDegreeMembership>().swap(_im_nodes);
+        _im_position = 0;
+        _em_sorter.reset(internal ? nullptr : new em_sorter_t(_comp, _memory));
+    }
+
+    //! Sets whether the memberships break ties (see NodeDegreeMembershipInternalDegComparator); discards all nodes
+    void setBreakTies(bool break_ties) {
+        _comp = comparator_t(_comp.mixing(), break_ties);
+        setInternalMemory(!_em_sorter);
+    }
+
+    void push(const NodeDegreeMembership& ndm) {
+        if (_em_sorter)
+            _em_sorter->push(ndm);
+        else
+            _im_nodes.push_back(ndm);
+    }
+
+    void sort() {
+        if (_em_sorter)
+            _em_sorter->sort();
+        else
+            SEQPAR::sort(_im_nodes.begin(), _im_nodes.end(), _comp);
+        _im_position = 0;
+    }
+
+    void rewind() {
+        if (_em_sorter)
+            _em_sorter->rewind();
+        _im_position = 0;
+    }
+
+    bool empty() const {
+        return _em_sorter ? _em_sorter->empty() : _im_position == _im_nodes.size();
+    }
+
+    const NodeDegreeMembership& operator*() const {
+        return _em_sorter ? **_em_sorter : _im_nodes[_im_position];
+    }
+
+    const NodeDegreeMembership* operator->() const {
+        return &**this;
+    }
+
+    NodeDegreeMembershipSorter& operator++() {
+        if (_em_sorter)
+            ++(*_em_sorter);
+        else
+            ++_im_position;
+        return *this;
+    }
+};
+
 struct CommunityAssignment {
     community_t community_id; //!< community id
     degree_t degree; //!< intra-community degree of this node
@@ -86,6 +177,7 @@ struct CommunityAssignment {
     }
 
     DECL_TO_TUPLE(community_id, degree, node_id);
+    DECL_PACKED_KEY(community_id, packed_key::descending(degree), node_id);
     DECL_TUPLE_OS(CommunityAssignment);
 };
 
@@ -121,7 +213,7 @@ class LFR {
     friend class LFRCommunityAssignBenchmark;
 
 public:
-    using NodeDegreeDistribution = MonotonicPowerlawRandomStream<false>;
+    using NodeDegreeDistribution = MonotonicPowerlawRandomStream<false, ParallelMonotonicUniformRandomStream<true>>;
     using CommunityDistribution = MonotonicPowerlawRandomStream<false>;
 
 
@@ -131,7 +223,7 @@ protected:
     // model parameters
     const node_t _number_of_nodes;
     NodeDegreeDistribution::Parameters _degree_distribution_params;
-    const community_t _number_of_communities;
+    community_t _number_of_communities;
     CommunityDistribution::Parameters _community_distribution_params;
     const double _mixing;
     
@@ -140,13 +232,18 @@ protected:
 
     community_t _overlap_max_memberships;
 
-    uint_t _max_memory_usage;
+    MemoryPlanner _memory_plan;
     uint_t _degree_sum;
 
     double _community_rewiring_random {0.0};
 
+    std::string _checkpoint_save_filename; //!< if non-empty, checkpoint is written after the assignment
+    std::string _checkpoint_load_filename; //!< if non-empty, all phases up to the assignment are replaced by the checkpoint
+
+    bool _internal_memory {false}; //!< run all phases in IM (see setInternalMemory())
+
     // model materialization
-    stxxl::sorter<NodeDegreeMembership, NodeDegreeMembershipInternalDegComparator> _node_sorter;
+    NodeDegreeMembershipSorter _node_sorter;
 
     /**
      * The i-th entry contains the sum of sizes of communities 0 to i-1. It, hence,
@@ -161,6 +258,26 @@ protected:
      * of community k */
     stxxl::vector<CommunityAssignment> _community_assignments;
 
+    //! Replaces _community_assignments for the internal memory backend
+    std::vector<CommunityAssignment> _internal_assignments;
+
+    uint_t _number_of_assignments() const {
+        return _internal_memory ? _internal_assignments.size() : _community_assignments.size();
+    }
+
+    //! Calls cb for every assignment in the order of _community_assignments
+    template <typename Callback>
+    void _for_each_assignment(Callback cb) {
+        if (_internal_memory) {
+            for (const auto& a : _internal_assignments)
+                cb(a);
+            return;
+        }
+
+        for (typename decltype(_community_assignments)::bufreader_type reader(_community_assignments); !reader.empty(); ++reader)
+            cb(*reader);
+    }
+
     EdgeStream _intra_community_edges;
     EdgeStream _inter_community_edges;
     EdgeStream _edges;
@@ -184,6 +301,14 @@ protected:
     void _verify_assignment();
     void _verify_result_graph();
 
+    void _save_checkpoint(const std::string& filename);
+    void _load_checkpoint(const std::string& filename);
+
+    //! Throws if the internal memory backend exceeds the budget or IMGraph's limits; requires the node degrees
+    void _check_internal_memory();
+    void _generate_graph_internal();
+    void _rewire_community_duplicates_internal(std::vector<CommunityEdge>& edges);
+
 public:
     LFR(const NodeDegreeDistribution::Parameters & node_degree_dist,
         const NodeDegreeDistribution::Parameters & community_degree_dist,
@@ -195,22 +320,15 @@ public:
         _number_of_communities((community_t)community_degree_dist.numberOfNodes),
         _community_distribution_params(community_degree_dist),
         _mixing(mixing_parameter),
-        _max_memory_usage(max_memory_usage),
-        _node_sorter(NodeDegreeMembershipInternalDegComparator(_mixing), SORTER_MEM)
+        _memory_plan(max_memory_usage, omp_get_max_threads(), _number_of_nodes, _number_of_communities),
+        _node_sorter(NodeDegreeMembershipInternalDegComparator(_mixing), _memory_plan.node_sorter())
     {
         _overlap_method = geometric;
         _overlap_config.geometric.maxDegreeIntraDegree = (uint_t)node_degree_dist.maxDegree;
-
-        if (_max_memory_usage < 4 * SORTER_MEM + 1.3 * SORTER_MEM * omp_get_max_threads() + sizeof(node_t) * _number_of_communities * 4) {
-            throw std::runtime_error("Not enough memory given, need at least memory for a sorter and a bit more per thread, four global sorters and several values per community.");
-        }
-
-        _max_memory_usage -= SORTER_MEM; // for _node_sorter FIXME see if we really need it constantly...
-        _max_memory_usage -= _number_of_communities * sizeof(node_t); // for _community_cumulative_sizes
     }
 
     LFR(const LFR& other)
-          : LFR(other._degree_distribution_params, other._community_distribution_params, other._mixing, other._max_memory_usage)
+          : LFR(other._degree_distribution_params, other._community_distribution_params, other._mixing, other._memory_plan.budget())
     {
         setOverlap(other._overlap_method, other._overlap_config);
     }
@@ -229,6 +347,49 @@ public:
         _community_rewiring_random = v;
     }
 
+    /**
+     * After the community assignment, store the node degrees, memberships, community sizes
+     * and the assignment into @a filename. See setCheckpointLoad().
+     * To make the node order reproducible, ties between nodes are broken by their memberships
+     * (see NodeDegreeMembershipInternalDegComparator), so the graph generated for a seed differs
+     * from a run without checkpoint. Call before run().
+     */
+    void setCheckpointSave(const std::string& filename) {
+        _checkpoint_save_filename = filename;
+        _node_sorter.setBreakTies(true);
+    }
+
+    /**
+     * Skip the sampling of the node degrees, community sizes and the community assignment
+     * and restore them from a checkpoint written by setCheckpointSave() instead.
+     * The checkpoint may stem from a run with a different seed or mixing parameter; in the
+     * latter case the intra-community degrees are recomputed and the nodes relabeled. If a
+     * node then does not fit into one of its communities, the community sizes are corrected
+     * and the assignment is recomputed. The geometric overlap method derives the memberships
+     * from the mixing, so it only accepts checkpoints with the same mixing parameter.
+     * The number of nodes has to match; the community parameters are taken from the checkpoint.
+     * Ties between nodes are broken as in setCheckpointSave(). Call before run().
+     */
+    void setCheckpointLoad(const std::string& filename) {
+        _checkpoint_load_filename = filename;
+        _node_sorter.setBreakTies(true);
+    }
+
+    /**
+     * Run all phases entirely in internal memory: the nodes, the community assignment
+     * and the resulting edges are kept in std::vectors, and the community graphs, the
+     * global graph and its rewiring use intsort::sort and IMGraphs instead of the EM
+     * sorters and swap algorithms. The output follows the same distribution; run()
+     * throws as soon as the instance is known not to fit into the memory budget or
+     * the global graph exceeds IMGraph::maxEdges(). Call before run().
+     */
+    void setInternalMemory(bool v) {
+        _internal_memory = v;
+        _node_sorter.setInternalMemory(v);
+        if (v)
+            _edges.enableInternalMemory();
+    }
+
     /**
      * This exports the community assignments such that in every line a node id and its community/communities are written (separated by space).
      * Node ids are 1-based.
@@ -238,7 +399,22 @@ public:
         using node_community_t = std::tuple<node_t, community_t>;
         using nc_comp_t = GenericComparatorTuple<node_community_t>::Ascending;
 
-        stxxl::sorter<node_community_t, nc_comp_t> output_sorter(nc_comp_t(), SORTER_MEM);
+        if (_internal_memory) {
+            std::vector<node_community_t> node_communities;
+            node_communities.reserve(_internal_assignments.size());
+            for (const auto& ca : _internal_assignments)
+                node_communities.emplace_back(ca.node_id, ca.community_id);
+            SEQPAR::sort(node_communities.begin(), node_communities.end(), nc_comp_t());
+
+            for (auto it = node_communities.cbegin(); it != node_communities.cend(); ++it) {
+                if (it == node_communities.cbegin() || std::get<0>(*it) != std::get<0>(*std::prev(it)))
+                    os << (it == node_communities.cbegin() ? "" : "\n") << std::get<0>(*it);
+                os << " " << std::get<1>(*it);
+            }
+            return;
+        }
+
+        stxxl::sorter<node_community_t, nc_comp_t> output_sorter(nc_comp_t(), _memory_plan[MemoryPlanner::ExportSorter]);
 
         for (const auto& ca : _community_assignments) {
             output_sorter.push(std::make_tuple(ca.node_id, ca.community_id));
@@ -264,15 +440,22 @@ public:
      */
     template <typename ostream_t>
     void export_community_assignment_binary(ostream_t & os) {
-        for (const auto& ca : _community_assignments) {
+        _for_each_assignment([&os] (const CommunityAssignment& ca) {
             static_assert(std::is_same<int32_t, decltype(ca.node_id)>::value, "node id is not longer int32_t");
             static_assert(std::is_same<int32_t, decltype(ca.community_id)>::value, "node id is not longer int32_t");
             os.write(reinterpret_cast<const char*>(&ca.node_id), 4);
             os.write(reinterpret_cast<const char*>(&ca.community_id), 4);
-        }
+        });
     }
 
     void run();
+
+    /**
+     * Parallel single-pass verification of the generated graph against the requested
+     * degrees, mixing and community assignment; can be used in release builds.
+     * Requires 12 bytes of IM per node.
+     */
+    VerificationReport verify_graph();
 };
 
 
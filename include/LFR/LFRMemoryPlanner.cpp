@@ -0,0 +1,256 @@
+#include "LFRMemoryPlanner.h"
+#include "LFR.h"
+
+#include <IMGraph.h>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace LFR {
+
+constexpr uint_t MemoryPlanner::min_sorter_mem;
+constexpr uint_t MemoryPlanner::min_swap_mem;
+
+MemoryPlanner::MemoryPlanner(uint_t budget, unsigned int threads, node_t nodes, community_t communities)
+    : _budget(budget)
+    , _threads(std::max(1u, threads))
+    , _nodes(nodes)
+    , _communities(communities)
+    , _planned(false)
+{
+    _assigned.fill(0);
+    _number_of_requests.fill(0);
+
+    // the node sorter is alive during the whole run; it never needs more than
+    // its volume, but should not starve all other phases either
+    _node_sorter_mem = std::max(min_sorter_mem,
+                                std::min<uint_t>(static_cast<uint_t>(_nodes) * sizeof(NodeDegreeMembership),
+                                                 _budget / 8));
+
+    _persistent = _node_sorter_mem + (static_cast<uint_t>(_communities) + 1) * sizeof(node_t);
+
+    // minimal requirement of the most demanding phases (see plan())
+    const uint_t min_community_graphs = min_sorter_mem + _threads * (min_swap_mem / 2);
+    const uint_t min_global_rewire = min_swap_mem + 3 * min_sorter_mem;
+    const uint_t required = _persistent + std::max(min_community_graphs, min_global_rewire);
+
+    if (_budget < required) {
+        throw std::runtime_error("Not enough memory given, need at least "
+                                 + std::to_string(required / UIntScale::Mi) + " MiB: memory for the node sorter, "
+                                 "a swap engine per thread and several values per community.");
+    }
+}
+
+void MemoryPlanner::set_communities(community_t communities) {
+    _communities = communities;
+    _persistent = _node_sorter_mem + (static_cast<uint_t>(_communities) + 1) * sizeof(node_t);
+    _planned = false;
+}
+
+void MemoryPlanner::_add(Phase phase, Consumer c, uint_t demand, uint_t minimum, bool elastic) {
+    assert(_number_of_requests[phase] < NumberOfConsumers);
+    _requests[phase][_number_of_requests[phase]++] = Request{c, std::max(demand, minimum), minimum, elastic};
+}
+
+void MemoryPlanner::plan(edgeid_t memberships, edgeid_t degree_sum, double mixing,
+                         node_t max_community_size, bool overlapping) {
+    _number_of_requests.fill(0);
+    _assigned.fill(0);
+
+    const double memberships_per_node = static_cast<double>(memberships) / std::max<node_t>(1, _nodes);
+    const uint_t inter_edges = static_cast<uint_t>(degree_sum * mixing / 2);
+    const uint_t intra_edges = static_cast<uint_t>(degree_sum / 2) - inter_edges;
+
+    // Community assignment
+    {
+        // RandomIntervalTree over all communities (padded to a power of two) including
+        // the buffer of its linear-time build and the remaining capacities, the batches
+        // of the parallel online allocation and the offline allocation of at most 1M
+        // overlapping nodes
+        const uint_t tree_leaves = uint_t(1) << static_cast<uint_t>(std::ceil(std::log2(std::max<community_t>(2, _communities))));
+        const uint_t batch_memberships = std::min<uint_t>(1 << 22, memberships);
+        const uint_t offline_nodes = overlapping ? std::min<uint_t>(1 << 20, _nodes) : 0;
+        const uint_t internal = 3 * tree_leaves * sizeof(node_t)
+            + batch_memberships * (sizeof(NodeDegreeMembership) + sizeof(edgeid_t) + sizeof(::LFR::CommunityAssignment))
+            + offline_nodes * (sizeof(NodeDegreeMembership) + sizeof(node_t))
+            + static_cast<uint_t>(offline_nodes * memberships_per_node) * sizeof(::LFR::CommunityAssignment);
+
+        _add(CommunityAssignment, AssignmentInternal, internal, internal);
+        _add(CommunityAssignment, AssignmentSorter, memberships * sizeof(::LFR::CommunityAssignment), min_sorter_mem);
+    }
+
+    // Community graphs
+    {
+        const uint_t edge_size = overlapping ? sizeof(CommunityEdge) : sizeof(edge_t);
+        _add(CommunityGraphs, CommunityEdgeSorter, intra_edges * edge_size, min_sorter_mem);
+
+        // a worker has to keep the largest community in IM: the id mapping
+        // and the graph whose degree is the average intra-community degree
+        const uint_t avg_intra_degree = memberships ? 2 * intra_edges / memberships : 0;
+        const uint_t max_com_edges = std::min<uint_t>(
+            static_cast<uint_t>(max_community_size) * avg_intra_degree / 2,
+            static_cast<uint_t>(max_community_size) * (max_community_size - 1) / 2);
+        const uint_t per_worker = 2 * max_community_size * sizeof(node_t)
+            + IMGraph::memoryUsage(max_community_size, max_com_edges);
+
+        _add(CommunityGraphs, CommunityWorkers, _threads * per_worker, _threads * (min_swap_mem / 2), true);
+    }
+
+    // Global graph: Havel-Hakimi and translation of ids
+    {
+        _add(GlobalGraphTranslate, GlobalDegreeSorter, _nodes * sizeof(std::pair<degree_t, node_t>), min_sorter_mem);
+        _add(GlobalGraphTranslate, GlobalEdgeSorterSource, inter_edges * sizeof(edge_t), min_sorter_mem);
+        _add(GlobalGraphTranslate, GlobalEdgeSorterTarget, inter_edges * sizeof(edge_t), min_sorter_mem);
+    }
+
+    // Global graph: rewiring
+    {
+        // a rewiring iteration processes about m/4 swaps; EdgeSwapTFP needs
+        // roughly 256 bytes per swap to keep all its structures in IM
+        _add(GlobalGraphRewire, GlobalSwaps, std::max<uint_t>(1, inter_edges / 4) * 256, min_swap_mem, true);
+        _add(GlobalGraphRewire, GlobalRewiringSorters,
+             3 * static_cast<uint_t>(inter_edges * memberships_per_node) * 3 * sizeof(node_t),
+             3 * min_sorter_mem);
+    }
+
+    // Verification
+    {
+        _add(Verification, VerifyMembershipSorter, memberships * sizeof(std::pair<node_t, degree_t>), min_sorter_mem);
+        _add(Verification, VerifyDegreeSorter, 2 * (intra_edges + inter_edges) * sizeof(node_t), min_sorter_mem);
+    }
+
+    // Export
+    _add(Export, ExportSorter, memberships * sizeof(std::tuple<node_t, community_t>), min_sorter_mem);
+
+    for (unsigned int p = 0; p < NumberOfPhases; ++p)
+        _distribute(static_cast<Phase>(p));
+
+    _planned = true;
+}
+
+void MemoryPlanner::_distribute(Phase phase) {
+    auto& requests = _requests[phase];
+    const unsigned int n = _number_of_requests[phase];
+    const uint_t available = _budget - _persistent;
+
+    uint_t min_sum = 0;
+    for (unsigned int i = 0; i < n; ++i)
+        min_sum += requests[i].minimum;
+
+    if (min_sum > available) {
+        throw std::runtime_error(std::string("Not enough memory for phase ") + _phase_name(phase)
+                                 + ": need at least " + std::to_string((min_sum + _persistent) / UIntScale::Mi) + " MiB");
+    }
+
+    std::vector<uint_t> assigned(n);
+    std::vector<bool> saturated(n);
+    for (unsigned int i = 0; i < n; ++i) {
+        assigned[i] = requests[i].minimum;
+        saturated[i] = (assigned[i] >= requests[i].demand);
+    }
+
+    // water-filling: distribute proportional to the demand, but never beyond it
+    uint_t rest = available - min_sum;
+    while (rest) {
+        double weight = 0;
+        for (unsigned int i = 0; i < n; ++i)
+            if (!saturated[i]) weight += requests[i].demand;
+
+        if (weight == 0) break;
+
+        // consumers whose demand is met by their share are capped and removed
+        std::vector<unsigned int> capped;
+        for (unsigned int i = 0; i < n; ++i) {
+            if (saturated[i]) continue;
+            const uint_t share = static_cast<uint_t>(rest * (requests[i].demand / weight));
+            if (assigned[i] + share >= requests[i].demand)
+                capped.push_back(i);
+        }
+
+        if (capped.empty()) {
+            uint_t given = 0;
+            for (unsigned int i = 0; i < n; ++i) {
+                if (saturated[i]) continue;
+                const uint_t share = static_cast<uint_t>(rest * (requests[i].demand / weight));
+                assigned[i] += share;
+                given += share;
+            }
+            rest -= std::min(rest, given);
+            break;
+        }
+
+        for (auto i : capped) {
+            rest -= requests[i].demand - assigned[i];
+            assigned[i] = requests[i].demand;
+            saturated[i] = true;
+        }
+    }
+
+    // elastic consumers share whatever is left
+    if (rest) {
+        double weight = 0;
+        for (unsigned int i = 0; i < n; ++i)
+            if (requests[i].elastic) weight += requests[i].demand;
+
+        for (unsigned int i = 0; i < n; ++i)
+            if (requests[i].elastic)
+                assigned[i] += static_cast<uint_t>(rest * (requests[i].demand / weight));
+    }
+
+    for (unsigned int i = 0; i < n; ++i)
+        _assigned[requests[i].consumer] = assigned[i];
+}
+
+void MemoryPlanner::report(std::ostream& os) const {
+    os << "LFR memory plan; budget " << (_budget / UIntScale::Mi) << " MiB, "
+          "node sorter " << (_node_sorter_mem / UIntScale::Mi) << " MiB, "
+          "persistent " << (_persistent / UIntScale::Mi) << " MiB\n";
+
+    if (!_planned)
+        return;
+
+    for (unsigned int p = 0; p < NumberOfPhases; ++p) {
+        os << " Phase " << _phase_name(static_cast<Phase>(p)) << "\n";
+        for (unsigned int i = 0; i < _number_of_requests[p]; ++i) {
+            const Request& r = _requests[p][i];
+            os << "  " << std::setw(24) << std::left << _consumer_name(r.consumer) << std::right
+               << " assigned: " << std::setw(8) << (_assigned[r.consumer] / UIntScale::Mi) << " MiB"
+               << " demand: " << std::setw(8) << (r.demand / UIntScale::Mi) << " MiB"
+               << (r.elastic ? " (elastic)" : "") << "\n";
+        }
+    }
+}
+
+const char* MemoryPlanner::_phase_name(Phase p) {
+    switch (p) {
+        case CommunityAssignment:  return "CommunityAssignment";
+        case CommunityGraphs:      return "CommunityGraphs";
+        case GlobalGraphTranslate: return "GlobalGraphTranslate";
+        case GlobalGraphRewire:    return "GlobalGraphRewire";
+        case Verification:         return "Verification";
+        case Export:               return "Export";
+        default:                   return "?";
+    }
+}
+
+const char* MemoryPlanner::_consumer_name(Consumer c) {
+    switch (c) {
+        case AssignmentSorter:       return "AssignmentSorter";
+        case AssignmentInternal:     return "AssignmentInternal";
+        case CommunityEdgeSorter:    return "CommunityEdgeSorter";
+        case CommunityWorkers:       return "CommunityWorkers";
+        case GlobalDegreeSorter:     return "GlobalDegreeSorter";
+        case GlobalEdgeSorterSource: return "GlobalEdgeSorterSource";
+        case GlobalEdgeSorterTarget: return "GlobalEdgeSorterTarget";
+        case GlobalSwaps:            return "GlobalSwaps";
+        case GlobalRewiringSorters:  return "GlobalRewiringSorters";
+        case VerifyMembershipSorter: return "VerifyMembershipSorter";
+        case VerifyDegreeSorter:     return "VerifyDegreeSorter";
+        case ExportSorter:           return "ExportSorter";
+        default:                     return "?";
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Distribution of the main memory budget among the EM structures of LFR
+ */
+#pragma once
+
+#include <defs.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <string>
+#include <ostream>
+
+namespace LFR {
+
+/**
+ * @brief Central memory planner for all sorters, PQs and worker memory of LFR
+ *
+ * Instead of assigning a constant amount of memory (SORTER_MEM) to every
+ * sorter, the planner knows which consumers are alive in each phase of the
+ * generator and splits the budget available in this phase proportional to
+ * the expected volume (number of items times item size) of each consumer.
+ * A consumer never receives more than its expected volume unless it is
+ * elastic (e.g. the swap engines which benefit from any additional memory);
+ * all elastic consumers of a phase share whatever is left.
+ *
+ * The _node_sorter and the community size prefix sum are alive during the
+ * whole run and are hence subtracted from the budget of every phase.
+ *
+ * Usage: the planner is constructed together with LFR (which only requires
+ * the number of nodes to size the _node_sorter) and plan() has to be called
+ * as soon as the degree and membership sums are known, i.e. after
+ * LFR::_compute_node_distributions.
+ */
+class MemoryPlanner {
+public:
+    //! Phases of LFR; all consumers of a phase may be alive at the same time
+    enum Phase : unsigned int {
+        CommunityAssignment,
+        CommunityGraphs,
+        GlobalGraphTranslate,
+        GlobalGraphRewire,
+        Verification,
+        Export,
+        NumberOfPhases
+    };
+
+    //! Memory consumers; the comment states the phase they belong to
+    enum Consumer : unsigned int {
+        AssignmentSorter,       //!< CommunityAssignment: sorts CommunityAssignment
+        AssignmentInternal,     //!< CommunityAssignment: RandomIntervalTree and offline allocation (fixed)
+        CommunityEdgeSorter,    //!< CommunityGraphs: collects the intra-community edges
+        CommunityWorkers,       //!< CommunityGraphs: IM graphs/EM swaps of all threads (elastic)
+        GlobalDegreeSorter,     //!< GlobalGraphTranslate: external degree/node pairs
+        GlobalEdgeSorterSource, //!< GlobalGraphTranslate: first id translation
+        GlobalEdgeSorterTarget, //!< GlobalGraphTranslate: second id translation
+        GlobalSwaps,            //!< GlobalGraphRewire: swap engine (elastic)
+        GlobalRewiringSorters,  //!< GlobalGraphRewire: the three sorters of GlobalRewiringSwapGenerator
+        VerifyMembershipSorter, //!< Verification: node/intra-degree pairs
+        VerifyDegreeSorter,     //!< Verification: edge endpoints
+        ExportSorter,           //!< Export: node/community pairs
+        NumberOfConsumers
+    };
+
+    //! Smallest amount of memory handed to a sorter
+    static constexpr uint_t min_sorter_mem = 64 * UIntScale::Mi;
+
+    //! Smallest amount of memory handed to a swap engine (per instance)
+    static constexpr uint_t min_swap_mem = 512 * UIntScale::Mi;
+
+    MemoryPlanner(uint_t budget, unsigned int threads, node_t nodes, community_t communities);
+
+    /**
+     * Compute the assignment of all phases.
+     * @param memberships   Total number of memberships (i.e. community assignments)
+     * @param degree_sum    Sum of all node degrees
+     * @param mixing        Fraction of inter-community edges
+     * @param max_community_size Size of the largest community
+     * @param overlapping   Whether nodes may be member of several communities
+     * @throws std::runtime_error if the budget does not suffice
+     */
+    void plan(edgeid_t memberships, edgeid_t degree_sum, double mixing,
+              node_t max_community_size, bool overlapping);
+
+    //! Update the number of communities (e.g. as restored from a checkpoint); call before plan()
+    void set_communities(community_t communities);
+
+    //! Memory assigned to a consumer (only valid after plan())
+    uint_t operator[](Consumer c) const {
+        assert(_planned);
+        return _assigned[c];
+    }
+
+    //! Bytes used by the _node_sorter; fixed at construction
+    uint_t node_sorter() const { return _node_sorter_mem; }
+
+    //! Bytes available to each of the community worker threads
+    uint_t community_worker() const { return (*this)[CommunityWorkers] / _threads; }
+
+    //! Share of community_worker() used for the sorter of the external id mapping
+    uint_t community_worker_sorter() const { return std::max(min_sorter_mem, community_worker() / 4); }
+
+    //! The duplicate rewiring runs after all workers finished, so it may use their memory
+    uint_t community_rewiring_sorter() const { return std::max(min_sorter_mem, (*this)[CommunityWorkers] / 2); }
+
+    //! Memory of a single sorter in GlobalRewiringSwapGenerator
+    uint_t global_rewiring_sorter() const { return (*this)[GlobalRewiringSorters] / 3; }
+
+    //! Total budget as provided by the user
+    uint_t budget() const { return _budget; }
+
+    //! Print the assignment of every phase
+    void report(std::ostream& os) const;
+
+protected:
+    struct Request {
+        Consumer consumer;
+        uint_t demand;  //!< bytes to keep all expected items in IM
+        uint_t minimum; //!< bytes required to work at all
+        bool elastic;   //!< may use more than demand
+    };
+
+    const uint_t _budget;
+    const unsigned int _threads;
+    const node_t _nodes;
+    community_t _communities;
+
+    uint_t _persistent;
+    uint_t _node_sorter_mem;
+
+    bool _planned;
+    std::array<uint_t, NumberOfConsumers> _assigned;
+    std::array<std::array<Request, NumberOfConsumers>, NumberOfPhases> _requests;
+    std::array<unsigned int, NumberOfPhases> _number_of_requests;
+
+    void _add(Phase phase, Consumer c, uint_t demand, uint_t minimum, bool elastic = false);
+    void _distribute(Phase phase);
+
+    static const char* _phase_name(Phase p);
+    static const char* _consumer_name(Consumer c);
+};
+
+}
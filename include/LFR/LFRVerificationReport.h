@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @brief Result of the parallel single-pass verification of an LFR graph
+ */
+#pragma once
+
+#include <defs.h>
+#include <array>
+#include <ostream>
+
+namespace LFR {
+
+/**
+ * @brief Counters gathered by LFR::verify_graph()
+ *
+ * Each thread accumulates its own instance which are combined using merge().
+ * Degree deviations (requested minus realised degree of a node) are counted in
+ * logarithmic buckets: bucket 0 contains exact matches, bucket i > 0 deviations in
+ * [2^(i-1), 2^i).
+ */
+struct VerificationReport {
+    static constexpr unsigned int histogram_buckets = 32;
+
+    // graph
+    uint64_t nodes {0};
+    uint64_t edges {0};
+    uint64_t intra_edges {0};
+    uint64_t inter_edges {0};
+    uint64_t self_loops {0};
+    uint64_t multi_edges {0};
+    uint64_t unsorted_edges {0};
+    uint64_t invalid_edges {0};        //!< edges with endpoints outside [0, n)
+
+    // nodes
+    uint64_t degree_mismatches {0};    //!< nodes whose realised degree differs from the requested one
+    uint64_t degree_overassigned {0};  //!< nodes with a higher degree than requested
+    int64_t  missing_degree {0};       //!< sum of requested minus realised degrees
+    uint64_t intra_degree_mismatches {0};
+    int64_t  missing_intra_degree {0};
+    uint64_t membership_mismatches {0}; //!< nodes with a number of assignments different from the requested memberships
+    uint64_t uncovered_nodes {0};       //!< nodes without any community
+    bool node_count_mismatch {false};   //!< the number of requested degrees differs from the number of nodes
+
+    // communities
+    uint64_t communities {0};
+    uint64_t empty_communities {0};
+    uint64_t community_size_mismatches {0};
+
+    double requested_mixing {0.0};
+
+    std::array<uint64_t, histogram_buckets> degree_deviation {};
+
+    static unsigned int deviation_bucket(int64_t deviation) {
+        uint64_t d = static_cast<uint64_t>(deviation < 0 ? -deviation : deviation);
+        unsigned int bucket = 0;
+        while (d && bucket + 1 < histogram_buckets) {
+            d >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    void merge(const VerificationReport& o) {
+        nodes += o.nodes;
+        edges += o.edges;
+        intra_edges += o.intra_edges;
+        inter_edges += o.inter_edges;
+        self_loops += o.self_loops;
+        multi_edges += o.multi_edges;
+        unsorted_edges += o.unsorted_edges;
+        invalid_edges += o.invalid_edges;
+
+        degree_mismatches += o.degree_mismatches;
+        degree_overassigned += o.degree_overassigned;
+        missing_degree += o.missing_degree;
+        intra_degree_mismatches += o.intra_degree_mismatches;
+        missing_intra_degree += o.missing_intra_degree;
+        membership_mismatches += o.membership_mismatches;
+        uncovered_nodes += o.uncovered_nodes;
+        node_count_mismatch |= o.node_count_mismatch;
+
+        communities += o.communities;
+        empty_communities += o.empty_communities;
+        community_size_mismatches += o.community_size_mismatches;
+
+        for (unsigned int i = 0; i < histogram_buckets; ++i)
+            degree_deviation[i] += o.degree_deviation[i];
+    }
+
+    double realised_mixing() const {
+        return edges ? static_cast<double>(inter_edges) / edges : 0.0;
+    }
+
+    //! Structural errors; degree deviations are expected as LFR discards duplicate edges
+    bool valid() const {
+        return !self_loops && !multi_edges && !unsorted_edges && !invalid_edges
+            && !degree_overassigned && !membership_mismatches && !uncovered_nodes && !node_count_mismatch
+            && !empty_communities && !community_size_mismatches;
+    }
+
+    //! Write the report as a single JSON object
+    void write_json(std::ostream& os) const {
+        os << "{\n"
+           << "  \"valid\": " << (valid() ? "true" : "false") << ",\n"
+           << "  \"nodes\": " << nodes << ",\n"
+           << "  \"edges\": " << edges << ",\n"
+           << "  \"intra_edges\": " << intra_edges << ",\n"
+           << "  \"inter_edges\": " << inter_edges << ",\n"
+           << "  \"requested_mixing\": " << requested_mixing << ",\n"
+           << "  \"realised_mixing\": " << realised_mixing() << ",\n"
+           << "  \"self_loops\": " << self_loops << ",\n"
+           << "  \"multi_edges\": " << multi_edges << ",\n"
+           << "  \"unsorted_edges\": " << unsorted_edges << ",\n"
+           << "  \"invalid_edges\": " << invalid_edges << ",\n"
+           << "  \"degree_mismatches\": " << degree_mismatches << ",\n"
+           << "  \"degree_overassigned\": " << degree_overassigned << ",\n"
+           << "  \"missing_degree\": " << missing_degree << ",\n"
+           << "  \"intra_degree_mismatches\": " << intra_degree_mismatches << ",\n"
+           << "  \"missing_intra_degree\": " << missing_intra_degree << ",\n"
+           << "  \"membership_mismatches\": " << membership_mismatches << ",\n"
+           << "  \"uncovered_nodes\": " << uncovered_nodes << ",\n"
+           << "  \"node_count_mismatch\": " << (node_count_mismatch ? "true" : "false") << ",\n"
+           << "  \"communities\": " << communities << ",\n"
+           << "  \"empty_communities\": " << empty_communities << ",\n"
+           << "  \"community_size_mismatches\": " << community_size_mismatches << ",\n"
+           << "  \"degree_deviation_histogram\": [";
+
+        // skip trailing empty buckets
+        unsigned int last = histogram_buckets;
+        while (last > 1 && !degree_deviation[last - 1])
+            --last;
+
+        for (unsigned int i = 0; i < last; ++i)
+            os << (i ? ", " : "") << degree_deviation[i];
+
+        os << "]\n}\n";
+    }
+};
+
+}
@@ -0,0 +1,320 @@
+#include "LFR.h"
+
+#include <GenericComparator.h>
+#include <Utils/RandomSeed.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+
+/*
+ * Checkpoint format (all values in host byte order):
+ *  - 8 bytes magic "LFRCKPT1"
+ *  - int64 number of nodes, int64 number of communities, int64 number of assignments
+ *  - double mixing parameter used to compute the intra-community degrees
+ *  - per node in the order of _node_sorter: int32 degree, int32 memberships, uint8 ceil
+ *  - (number of communities + 1) x int32 exclusive prefix sum of community sizes
+ *  - per assignment in the order of _community_assignments: int32 community, int32 degree, int32 node
+ */
+
+namespace LFR {
+    namespace {
+        constexpr char checkpoint_magic[8] = {'L', 'F', 'R', 'C', 'K', 'P', 'T', '1'};
+
+        template <typename T>
+        void write_pod(std::ostream& os, const T& value) {
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        T read_pod(std::istream& is) {
+            T value;
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!is)
+                throw std::runtime_error("[LFR checkpoint] Unexpected end of file");
+            return value;
+        }
+
+        NodeDegreeMembership read_node(std::istream& is) {
+            const auto degree = read_pod<degree_t>(is);
+            const auto memberships = read_pod<community_t>(is);
+            const auto ceil = read_pod<uint8_t>(is);
+            return NodeDegreeMembership(degree, memberships, ceil != 0);
+        }
+    }
+
+    void LFR::_save_checkpoint(const std::string& filename) {
+        std::ofstream os(filename, std::ios::trunc | std::ios::binary);
+        if (!os)
+            throw std::runtime_error("[LFR checkpoint] Cannot open " + filename + " for writing");
+
+        const community_t number_of_communities = static_cast<community_t>(_community_cumulative_sizes.size()) - 1;
+
+        os.write(checkpoint_magic, sizeof(checkpoint_magic));
+        write_pod<int64_t>(os, _number_of_nodes);
+        write_pod<int64_t>(os, number_of_communities);
+        write_pod<int64_t>(os, _number_of_assignments());
+        write_pod<double>(os, _mixing);
+
+        for (_node_sorter.rewind(); !_node_sorter.empty(); ++_node_sorter) {
+            write_pod<degree_t>(os, _node_sorter->degree());
+            write_pod<community_t>(os, _node_sorter->memberships());
+            write_pod<uint8_t>(os, _node_sorter->ceil());
+        }
+        _node_sorter.rewind();
+
+        for (const auto& s : _community_cumulative_sizes)
+            write_pod<node_t>(os, s);
+
+        _for_each_assignment([&os] (const CommunityAssignment& a) {
+            write_pod<community_t>(os, a.community_id);
+            write_pod<degree_t>(os, a.degree);
+            write_pod<node_t>(os, a.node_id);
+        });
+
+        if (!os)
+            throw std::runtime_error("[LFR checkpoint] Failed to write " + filename);
+
+        std::cout << "Wrote checkpoint with " << _number_of_nodes << " nodes, " << number_of_communities
+                  << " communities and " << _number_of_assignments() << " assignments to " << filename << std::endl;
+    }
+
+    void LFR::_load_checkpoint(const std::string& filename) {
+        std::ifstream is(filename, std::ios::binary);
+        if (!is)
+            throw std::runtime_error("[LFR checkpoint] Cannot open " + filename);
+
+        // header
+        {
+            char magic[sizeof(checkpoint_magic)];
+            is.read(magic, sizeof(magic));
+            if (!is || !std::equal(magic, magic + sizeof(magic), checkpoint_magic))
+                throw std::runtime_error("[LFR checkpoint] " + filename + " is not an LFR checkpoint");
+        }
+
+        const auto number_of_nodes = read_pod<int64_t>(is);
+        const auto number_of_communities = read_pod<int64_t>(is);
+        const auto number_of_assignments = read_pod<int64_t>(is);
+        const auto checkpoint_mixing = read_pod<double>(is);
+
+        if (number_of_nodes != _number_of_nodes)
+            throw std::runtime_error("[LFR checkpoint] Checkpoint contains " + std::to_string(number_of_nodes)
+                                     + " nodes, but " + std::to_string(_number_of_nodes) + " were requested");
+
+        const bool same_mixing = (checkpoint_mixing == _mixing);
+        std::cout << "Restoring checkpoint " << filename << " created with mixing " << checkpoint_mixing
+                  << (same_mixing ? "" : "; will recompute intra-community degrees") << std::endl;
+
+        // the geometric method samples the memberships from the intra-community degree
+        if (!same_mixing && _overlap_method == geometric)
+            throw std::runtime_error("[LFR checkpoint] Checkpoint was created with mixing " + std::to_string(checkpoint_mixing)
+                                     + ", but the memberships of the geometric overlap method depend on it; requested mixing is "
+                                     + std::to_string(_mixing));
+
+        // only the constDegree method rounds the external degree randomly
+        const bool random_ceil = (_overlap_method == constDegree);
+        std::mt19937 generator(RandomSeed::get_instance().get_next_seed());
+        std::uniform_real_distribution<float> fdis;
+        auto adapt_to_mixing = [&] (const NodeDegreeMembership& ndm) {
+            if (same_mixing)
+                return ndm;
+
+            bool ceil = false;
+            if (random_ceil) {
+                float ceil_prob = ndm.degree() * _mixing;
+                ceil_prob -= std::floor(ceil_prob);
+                ceil = fdis(generator) < ceil_prob;
+            }
+
+            return NodeDegreeMembership(ndm.degree(), ndm.memberships(), ceil);
+        };
+
+        // nodes; if the mixing changed, the order of _node_sorter may change as well,
+        // so we sort (node, old id) and derive the new ids from the result
+        struct RelabelNode {
+            NodeDegreeMembership ndm;
+            node_t old_id;
+        };
+
+        struct RelabelNodeComparator {
+            NodeDegreeMembershipInternalDegComparator comp;
+
+            bool operator()(const RelabelNode& a, const RelabelNode& b) const {
+                if (comp(a.ndm, b.ndm)) return true;
+                if (comp(b.ndm, a.ndm)) return false;
+                return a.old_id < b.old_id;
+            }
+
+            RelabelNode min_value() const { return {comp.min_value(), std::numeric_limits<node_t>::min()}; }
+            RelabelNode max_value() const { return {comp.max_value(), std::numeric_limits<node_t>::max()}; }
+        };
+
+        _degree_sum = 0;
+        edgeid_t membership_sum = 0;
+        _overlap_max_memberships = 1;
+
+        using relabel_sorter_t = stxxl::sorter<RelabelNode, RelabelNodeComparator>;
+        std::unique_ptr<relabel_sorter_t> relabel_sorter;
+        if (!same_mixing)
+            relabel_sorter.reset(new relabel_sorter_t(RelabelNodeComparator{NodeDegreeMembershipInternalDegComparator(_mixing, true)},
+                                                      _memory_plan.node_sorter()));
+
+        for (node_t nid = 0; nid < _number_of_nodes; ++nid) {
+            const auto ndm = adapt_to_mixing(read_node(is));
+
+            _degree_sum += ndm.degree();
+            membership_sum += ndm.memberships();
+            _overlap_max_memberships = std::max(_overlap_max_memberships, ndm.memberships());
+
+            if (same_mixing) {
+                _node_sorter.push(ndm);
+            } else {
+                relabel_sorter->push(RelabelNode{ndm, nid});
+            }
+        }
+
+        if (_overlap_max_memberships > 1 && _overlap_method == constDegree && !_overlap_config.constDegree.overlappingNodes)
+            throw std::runtime_error("[LFR checkpoint] Checkpoint contains overlapping communities, but no overlap was requested");
+
+        if (membership_sum != number_of_assignments)
+            throw std::runtime_error("[LFR checkpoint] Number of memberships does not match number of assignments");
+
+        // community sizes
+        _community_cumulative_sizes.resize(number_of_communities + 1);
+        for (auto& s : _community_cumulative_sizes)
+            s = read_pod<node_t>(is);
+
+        node_t max_community_size = 0;
+        for (community_t c = 0; c < number_of_communities; ++c)
+            max_community_size = std::max(max_community_size, _community_size(c));
+
+        _number_of_communities = static_cast<community_t>(number_of_communities);
+        _memory_plan.set_communities(_number_of_communities);
+
+        // now the volumes of all phases are known
+        _memory_plan.plan(membership_sum, _degree_sum, _mixing, max_community_size, _overlap_max_memberships > 1);
+        _memory_plan.report(std::cout);
+
+        _community_assignments.clear();
+        _internal_assignments.clear();
+
+        if (same_mixing) {
+            // node ids and degrees remain valid; read assignments as they are
+            _node_sorter.sort();
+
+            if (_internal_memory) {
+                _internal_assignments.reserve(number_of_assignments);
+                for (int64_t i = 0; i < number_of_assignments; ++i) {
+                    const auto com = read_pod<community_t>(is);
+                    const auto degree = read_pod<degree_t>(is);
+                    const auto node = read_pod<node_t>(is);
+                    _internal_assignments.emplace_back(com, degree, node);
+                }
+
+                return;
+            }
+
+            _community_assignments.resize(number_of_assignments);
+            {
+                typename decltype(_community_assignments)::bufwriter_type writer(_community_assignments);
+                for (int64_t i = 0; i < number_of_assignments; ++i) {
+                    const auto com = read_pod<community_t>(is);
+                    const auto degree = read_pod<degree_t>(is);
+                    const auto node = read_pod<node_t>(is);
+                    writer << CommunityAssignment(com, degree, node);
+                }
+                writer.finish();
+            }
+
+            return;
+        }
+
+        // relabel the assignment; fails if a larger intra-community degree does not fit anymore
+        bool fits = true;
+        {
+            // derive new ids and keep (old id, new id, node) sorted by old id
+            using relabel_t = std::tuple<node_t, node_t, degree_t, community_t, bool>;
+            using relabel_comp_t = GenericComparatorTuple<relabel_t>::Ascending;
+            stxxl::sorter<relabel_t, relabel_comp_t> by_old_id(relabel_comp_t(), _memory_plan[MemoryPlanner::AssignmentSorter] / 3);
+
+            relabel_sorter->sort();
+            for (node_t new_id = 0; !relabel_sorter->empty(); ++(*relabel_sorter), ++new_id) {
+                const auto& rn = **relabel_sorter;
+                _node_sorter.push(rn.ndm);
+                by_old_id.push(relabel_t{rn.old_id, new_id, rn.ndm.degree(), rn.ndm.memberships(), rn.ndm.ceil()});
+            }
+            relabel_sorter.reset();
+            _node_sorter.sort();
+            by_old_id.sort();
+
+            // group communities by (old) node; communities are sorted by decreasing size
+            using node_com_t = std::tuple<node_t, community_t>;
+            using node_com_comp_t = GenericComparatorTuple<node_com_t>::Ascending;
+            stxxl::sorter<node_com_t, node_com_comp_t> node_coms(node_com_comp_t(), _memory_plan[MemoryPlanner::AssignmentSorter] / 3);
+            for (int64_t i = 0; i < number_of_assignments; ++i) {
+                const auto com = read_pod<community_t>(is);
+                read_pod<degree_t>(is);
+                const auto node = read_pod<node_t>(is);
+                node_coms.push(node_com_t{node, com});
+            }
+            node_coms.sort();
+
+            // hand the largest share of the intra-community degree to the largest community
+            stxxl::sorter<CommunityAssignment, GenericComparatorStruct<CommunityAssignment>::Ascending>
+                assignments(GenericComparatorStruct<CommunityAssignment>::Ascending(), _memory_plan[MemoryPlanner::AssignmentSorter] / 3);
+
+            for (; fits && !by_old_id.empty(); ++by_old_id) {
+                const auto& rn = *by_old_id;
+                const NodeDegreeMembership ndm(std::get<2>(rn), std::get<3>(rn), std::get<4>(rn));
+
+                for (community_t mem = 0; mem < ndm.memberships(); ++mem, ++node_coms) {
+                    assert(!node_coms.empty());
+                    assert(std::get<0>(*node_coms) == std::get<0>(rn));
+
+                    const community_t com = std::get<1>(*node_coms);
+                    const degree_t degree = ndm.intraCommunityDegree(_mixing, mem);
+
+                    if (degree >= _community_size(com)) {
+                        std::cout << "Intra-community degree " << degree << " of node " << std::get<1>(rn)
+                                  << " exceeds the size of its community " << com
+                                  << "; recomputing the community assignment" << std::endl;
+                        fits = false;
+                        break;
+                    }
+
+                    assignments.push(CommunityAssignment(com, degree, std::get<1>(rn)));
+                }
+            }
+            if (fits) {
+                assert(node_coms.empty());
+
+                assignments.sort();
+                if (_internal_memory) {
+                    _internal_assignments.resize(assignments.size());
+                    stxxl::stream::materialize(assignments, _internal_assignments.begin(), _internal_assignments.end());
+                } else {
+                    _community_assignments.resize(assignments.size());
+                    stxxl::stream::materialize(assignments, _community_assignments.begin(), _community_assignments.end());
+                }
+            }
+        }
+
+        if (fits)
+            return;
+
+        // keep the node degrees and community sizes, but redo the phases depending on the mixing
+        {
+            std::vector<node_t> sizes(number_of_communities);
+            for (community_t c = 0; c < number_of_communities; ++c)
+                sizes[c] = _community_size(c);
+            _community_cumulative_sizes.swap(sizes);
+        }
+
+        _correct_community_sizes();
+        _compute_community_assignments();
+    }
+}
@@ -126,9 +126,21 @@ void LFR::_correct_community_sizes() {
 void LFR::_compute_community_assignments() {
     auto & com_sizes = _community_cumulative_sizes;
 
-    // keep results (and sort them lexicographically, so edge switches are possible)
-    stxxl::sorter<CommunityAssignment, GenericComparatorStruct<CommunityAssignment>::Ascending>
-          assignments(GenericComparatorStruct<CommunityAssignment>::Ascending(), SORTER_MEM);
+    // keep results (and sort them lexicographically, so edge switches are possible);
+    // the internal memory backend collects them in _internal_assignments instead
+    using assignment_comp_t = GenericComparatorStruct<CommunityAssignment>::Ascending;
+    std::unique_ptr<stxxl::sorter<CommunityAssignment, assignment_comp_t>> assignment_sorter;
+    _internal_assignments.clear();
+    if (!_internal_memory)
+        assignment_sorter.reset(new stxxl::sorter<CommunityAssignment, assignment_comp_t>(
+            assignment_comp_t(), _memory_plan[MemoryPlanner::AssignmentSorter]));
+
+    auto push_assignment = [&] (const CommunityAssignment& a) {
+        if (assignment_sorter)
+            assignment_sorter->push(a);
+        else
+            _internal_assignments.push_back(a);
+    };
 
 
     const node_t offline_alloc = (_overlap_max_memberships == 1) ? 0 : std::min<node_t>(1024*1024, _number_of_nodes / 10);
@@ -184,8 +196,146 @@ void LFR::_compute_community_assignments() {
     };
 
 
+    node_t nid = 0;
+
+    // Parallel online allocation: nodes are processed in batches. Each batch is cut
+    // into fixed chunks of consecutive nodes, each with its own generator seeded
+    // from randGen, so the outcome does not depend on the number of threads or the
+    // schedule. All chunks sample from the tree as it was at the beginning of the
+    // batch; afterwards the samples claim the remaining capacities sequentially in
+    // node order and those hitting a community that filled up during the batch are
+    // redrawn from randGen. A batch consumes at most 1/32 of the remaining capacity,
+    // so the sampling distribution stays close to the sequential one and redraws
+    // are rare. The tree is rebuilt in linear time after each batch and the tail
+    // is assigned sequentially.
+    {
+        constexpr edgeid_t max_batch_memberships = 1 << 22;
+        constexpr edgeid_t min_batch_memberships = 1 << 16;
+        constexpr size_t chunk_size = 1 << 12;
+
+        std::vector<node_t> remaining(com_sizes.cbegin(), com_sizes.cbegin() + number_of_communities);
+
+        // number of communities large enough for a membership of the given degree;
+        // communities are sorted by decreasing size, so the legal ones form a prefix
+        auto legal_communities = [&] (const degree_t required_size) {
+            return static_cast<community_t>(std::distance(com_sizes.cbegin(),
+                std::partition_point(com_sizes.cbegin(), com_sizes.cbegin() + number_of_communities,
+                                     [required_size] (const node_t& size) {return size > required_size;})));
+        };
+
+        std::vector<NodeDegreeMembership> batch_nodes;
+        std::vector<edgeid_t> batch_offsets;
+        std::vector<CommunityAssignment> batch_assignments;
+        std::vector<std::mt19937::result_type> chunk_seeds;
+
+        while (nid < online_alloc) {
+            const edgeid_t batch_size = std::min<edgeid_t>(max_batch_memberships, tree.total_weight() / 32);
+            if (batch_size < min_batch_memberships)
+                break;
+
+            // load batch
+            const node_t batch_first = nid;
+            edgeid_t batch_memberships = 0;
+            batch_nodes.clear();
+            batch_offsets.clear();
+            for (; nid < online_alloc && batch_memberships < batch_size; ++nid, ++_node_sorter) {
+                assert(!_node_sorter.empty());
+                batch_nodes.push_back(*_node_sorter);
+                batch_offsets.push_back(batch_memberships);
+                batch_memberships += _node_sorter->memberships();
+            }
+            batch_offsets.push_back(batch_memberships);
+            batch_assignments.resize(batch_memberships);
+
+            const size_t number_of_chunks = (batch_nodes.size() + chunk_size - 1) / chunk_size;
+            chunk_seeds.resize(number_of_chunks);
+            for (auto & seed : chunk_seeds)
+                seed = randGen();
+
+            // sample all memberships from the tree of the batch start; a node may
+            // still get the same community twice, which is resolved below
+            #pragma omp parallel for schedule(dynamic)
+            for (size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+                std::mt19937 chunkRandGen(chunk_seeds[chunk]);
+                degree_t cached_degree = -1;
+                node_t cached_legal_weight = 0;
+
+                const size_t chunk_end = std::min(batch_nodes.size(), (chunk + 1) * chunk_size);
+                for (size_t i = chunk * chunk_size; i < chunk_end; ++i) {
+                    const auto &dgm = batch_nodes[i];
+                    for (community_t mem = 0; mem < dgm.memberships(); mem++) {
+                        const auto required_size = dgm.intraCommunityDegree(_mixing, mem);
+                        if (required_size != cached_degree) {
+                            const community_t legal = legal_communities(required_size);
+                            assert(legal > 0);
+                            cached_legal_weight = tree.prefixsum(legal - 1);
+                            cached_degree = required_size;
+                        }
+
+                        const community_t community_selected = LIKELY(cached_legal_weight > 0)
+                            ? tree.getLeaf(std::uniform_int_distribution<node_t>(0, cached_legal_weight - 1)(chunkRandGen))
+                            : number_of_communities;
+                        batch_assignments[batch_offsets[i] + mem] =
+                            CommunityAssignment(community_selected, required_size, batch_first + static_cast<node_t>(i));
+                    }
+                }
+            }
+
+            // claim the capacities in node order and redraw rejected samples
+            std::set<community_t> communities;
+            for (size_t i = 0; i < batch_nodes.size(); ++i) {
+                const auto &dgm = batch_nodes[i];
+                communities.clear();
+
+                for (edgeid_t j = batch_offsets[i]; j < batch_offsets[i + 1]; ++j) {
+                    auto & assignment = batch_assignments[j];
+                    community_t community_selected = assignment.community_id;
+
+                    if (UNLIKELY(community_selected >= number_of_communities
+                                 || !remaining[community_selected]
+                                 || communities.count(community_selected))) {
+                        const community_t legal = legal_communities(assignment.degree);
+                        const node_t legal_weight = legal ? tree.prefixsum(legal - 1) : 0;
+
+                        unsigned int retries = legal_weight ? 100 * dgm.memberships() : 0;
+                        std::uniform_int_distribution<node_t> distr(0, std::max<node_t>(1, legal_weight) - 1);
+                        for (community_selected = number_of_communities; retries--; ) {
+                            const community_t candidate = tree.getLeaf(distr(randGen));
+                            if (remaining[candidate] && !communities.count(candidate)) {
+                                community_selected = candidate;
+                                break;
+                            }
+                        }
+
+                        if (UNLIKELY(community_selected == number_of_communities)) {
+                            std::cerr << "Failed to assigned node " << (batch_first + i)
+                                      << " to its " << (j - batch_offsets[i]) << " of " << dgm.memberships()
+                                      << " memberships. Start over." << std::endl;
+                            _node_sorter.rewind();
+                            _compute_community_assignments();
+                            return;
+                        }
+
+                        assignment.community_id = community_selected;
+                    }
+
+                    assert(assignment.degree < com_sizes[community_selected]);
+                    communities.insert(community_selected);
+                    --remaining[community_selected];
+                }
+            }
+
+            for (const auto &a : batch_assignments)
+                push_assignment(a);
+
+            membership_sum += batch_memberships;
+            tree.rebuild(remaining);
+        }
+    }
+
+    // sequential online allocation of the remaining nodes
     std::set<community_t> communities;
-    for (node_t nid = 0; nid < online_alloc ; ++nid, ++_node_sorter) {
+    for (; nid < online_alloc ; ++nid, ++_node_sorter) {
         assert(!_node_sorter.empty());
         const auto &dgm = *_node_sorter;
 
@@ -208,7 +358,7 @@ void LFR::_compute_community_assignments() {
                 if (communities.insert(community_selected).second) {
                     // found a non-empty community
                     assert(required_size <= com_sizes.at(community_selected));
-                    assignments.push(CommunityAssignment(community_selected, required_size, nid));
+                    push_assignment(CommunityAssignment(community_selected, required_size, nid));
                     tree.decreaseLeaf(community_selected);
                     //com_sizes[community_selected]++;
                     --legal_weight;
@@ -351,14 +501,18 @@ void LFR::_compute_community_assignments() {
         for(auto & a : off_assignments) {
             assert(a.degree <= com_sizes.at(a.community_id));
             a.node_id += online_alloc;
-            assignments.push(a);
+            push_assignment(a);
         }
     }
 
 
-    assignments.sort();
-    _community_assignments.resize(assignments.size());
-    stxxl::stream::materialize(assignments, _community_assignments.begin(), _community_assignments.end());
+    if (assignment_sorter) {
+        assignment_sorter->sort();
+        _community_assignments.resize(assignment_sorter->size());
+        stxxl::stream::materialize(*assignment_sorter, _community_assignments.begin(), _community_assignments.end());
+    } else {
+        SEQPAR::sort(_internal_assignments.begin(), _internal_assignments.end(), assignment_comp_t());
+    }
 
     {
         _community_cumulative_sizes.push_back(0);
@@ -12,6 +12,7 @@
 #include <Utils/StreamPusher.h>
 
 #include <Utils/RandomSeed.h>
+#include <Utils/Progress.h>
 
 namespace LFR {
     namespace {
@@ -44,12 +45,14 @@ namespace LFR {
     void LFR::_generate_community_graphs() {
         using community_edge_t = typename std::conditional<is_disjoint, edge_t, CommunityEdge>::type;
         using community_edge_comparator_t = typename std::conditional<is_disjoint, GenericComparator<edge_t>::Ascending, GenericComparatorStruct<CommunityEdge>::Ascending>::type;
-        stxxl::sorter<community_edge_t, community_edge_comparator_t> edgeSorter(community_edge_comparator_t(), SORTER_MEM);
+        stxxl::sorter<community_edge_t, community_edge_comparator_t> edgeSorter(community_edge_comparator_t(), _memory_plan[MemoryPlanner::CommunityEdgeSorter]);
         auto push_com_edge = [&edgeSorter](community_t com, const edge_t &e) {
             edgeSorter.push(construct_community_edge_t(com, e, std::integral_constant<bool, is_disjoint>()));
         };
         const uint_t n_threads = omp_get_max_threads();
-        const uint_t memory_per_thread = _max_memory_usage / n_threads;
+        const uint_t memory_per_thread = _memory_plan.community_worker();
+
+        ProgressTask progress("LFR communities", _community_cumulative_sizes.size() - 1);
 
         #pragma omp parallel shared(edgeSorter), num_threads(n_threads)
         {
@@ -65,6 +68,7 @@ namespace LFR {
                 std::vector<degree_t> node_degrees;
 
                 if (com_size < 2) {
+                    progress.advance();
                     continue; // no edges to create
                 }
 
@@ -168,8 +172,12 @@ namespace LFR {
 
                     uint_t run_length = intra_edges.size() / 8;
 
-                    // perform swaps
-                    EdgeSwapTFP::EdgeSwapTFP swap_algo(intra_edges, run_length, _number_of_nodes, memory_per_thread);
+                    // perform swaps; the id mapping below needs a sorter while swap_algo is alive
+                    const uint_t mapping_sorter_mem = _memory_plan.community_worker_sorter();
+                    const uint_t swap_mem = available_memory > mapping_sorter_mem + MemoryPlanner::min_swap_mem
+                                          ? available_memory - mapping_sorter_mem
+                                          : MemoryPlanner::min_swap_mem;
+                    EdgeSwapTFP::EdgeSwapTFP swap_algo(intra_edges, run_length, _number_of_nodes, swap_mem);
 
                     StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
 
@@ -186,7 +194,7 @@ namespace LFR {
                             ++intra_edges;
                         }
                     } else { // external memory mapping with an additional sort step
-                        stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> intra_edgeSorter(GenericComparator<edge_t>::Ascending(), SORTER_MEM);
+                        stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> intra_edgeSorter(GenericComparator<edge_t>::Ascending(), _memory_plan.community_worker_sorter());
 
                         {
                             decltype(external_node_ids)::bufreader_type node_id_reader(external_node_ids);
@@ -225,6 +233,8 @@ namespace LFR {
 
                     }
                 }
+
+                progress.advance();
             }
         }
 
@@ -248,7 +258,8 @@ namespace LFR {
                 writer.finish();
             }
 
-            CommunityEdgeRewiringSwaps rewiringSwaps(intra_com_edges, _intra_community_edges.size() / 3, _community_rewiring_random);
+            CommunityEdgeRewiringSwaps rewiringSwaps(intra_com_edges, intra_com_edges.size() / 3, _community_rewiring_random,
+                                                     _memory_plan.community_rewiring_sorter());
             rewiringSwaps.run();
 
             for (stxxl::vector<CommunityEdge>::bufreader_type reader(intra_com_edges); !reader.empty(); ++reader) {
@@ -1,12 +1,15 @@
 #include "LFR.h"
 #include "GlobalRewiringSwapGenerator.h"
+#include "SparseGlobalRewiring.h"
 #include <LFR/GlobalRewiringSwapGenerator.h>
 #include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <HavelHakimi/HavelHakimiParallelGenerator.h>
 #include <EdgeSwaps/SemiLoadedEdgeSwapTFP.h>
 #include <SwapGenerator.h>
 #include <Utils/AsyncStream.h>
 #include <Utils/StreamPusher.h>
 #include <Utils/IOStatistics.h>
+#include <Utils/Progress.h>
 #include <DegreeStream.h>
 #include <Utils/NodeHash.h>
 #include <Curveball/EMCurveball.h>
@@ -17,14 +20,22 @@ namespace LFR {
 		#ifdef CURVEBALL_RAND
 		HavelHakimiIMGeneratorWithDegrees gen(HavelHakimiIMGeneratorWithDegrees::DecreasingDegree);
 		#else
-		HavelHakimiIMGenerator gen(HavelHakimiIMGenerator::DecreasingDegree);
+		HavelHakimiParallelGenerator gen(HavelHakimiParallelGenerator::DecreasingDegree);
 		#endif
 		{
             using deg_node_t = std::pair<degree_t, node_t>;
-            stxxl::sorter<deg_node_t, GenericComparator<deg_node_t>::Descending> extDegree(GenericComparator<deg_node_t>::Descending(), SORTER_MEM);
+            stxxl::sorter<deg_node_t, GenericComparator<deg_node_t>::Descending> extDegree(GenericComparator<deg_node_t>::Descending(), _memory_plan[MemoryPlanner::GlobalDegreeSorter]);
 
             int_t degree_sum = 0;
 
+            // if the rank -> node permutation fits into the memory of the (then unused) source
+            // sorter, both endpoints are translated in a single pass followed by a single sort
+            const bool translate_internal = static_cast<uint_t>(_number_of_nodes) * sizeof(node_t)
+                                            <= _memory_plan[MemoryPlanner::GlobalEdgeSorterSource];
+            std::vector<node_t> rank_to_node;
+            if (translate_internal)
+                rank_to_node.reserve(_number_of_nodes);
+
             { // push node degrees in descending order in generator
                 _node_sorter.rewind();
 
@@ -38,6 +49,8 @@ namespace LFR {
                     degree_t deg = (*extDegree).first;
                     gen.push(deg);
                     degree_sum += deg;
+                    if (translate_internal)
+                        rank_to_node.push_back((*extDegree).second);
                     ++extDegree;
                 }
             }
@@ -49,11 +62,19 @@ namespace LFR {
 
             // translate target node id's
             // the sorter is in the outer scope as it is needed for longer
-            stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> edge_sorter2(GenericComparator<edge_t>::Ascending(), SORTER_MEM);
+            stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> edge_sorter2(GenericComparator<edge_t>::Ascending(), _memory_plan[MemoryPlanner::GlobalEdgeSorterTarget]);
 
-            {
+            if (translate_internal) {
+                for (; !gen.empty(); ++gen) {
+                    edge_t e = {rank_to_node[gen->first], rank_to_node[gen->second]};
+                    e.normalize();
+                    edge_sorter2.push(e);
+                }
+
+                std::vector<node_t>().swap(rank_to_node);
+            } else {
                 // translate source node id's
-                stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> edge_sorter1(GenericComparator<edge_t>::Ascending(), SORTER_MEM);
+                stxxl::sorter<edge_t, GenericComparator<edge_t>::Ascending> edge_sorter1(GenericComparator<edge_t>::Ascending(), _memory_plan[MemoryPlanner::GlobalEdgeSorterSource]);
 
                 extDegree.rewind();
                 for (node_t i = 0; !gen.empty(); ++gen) {
@@ -87,7 +108,7 @@ namespace LFR {
         {
 			#ifdef CURVEBALL_RAND
 				gen.finalize();
-				DegreeStream& degs = gen.get_degree_stream();
+				RLEDegreeStream& degs = gen.get_degree_stream();
 				degs.rewind();
 
 				Curveball::EMCurveball<Curveball::ModHash> randAlgo(_inter_community_edges,
@@ -96,13 +117,13 @@ namespace LFR {
                                                                     20,
                                                                     _inter_community_edges,
                                                                     omp_get_max_threads(),
-                                                                    _max_memory_usage);
+                                                                    _memory_plan[MemoryPlanner::GlobalSwaps]);
 
                 randAlgo.run();
                 _inter_community_edges.rewind();
 
 				// regular edge swaps
-				EdgeSwapTFP::SemiLoadedEdgeSwapTFP swapAlgo(_inter_community_edges, globalSwapsPerIteration, _number_of_nodes, _max_memory_usage);
+				EdgeSwapTFP::SemiLoadedEdgeSwapTFP swapAlgo(_inter_community_edges, globalSwapsPerIteration, _number_of_nodes, _memory_plan[MemoryPlanner::GlobalSwaps]);
 				// Generate swaps
 				uint_t numSwaps = 1*_inter_community_edges.size();
 				SwapGenerator swapGen(numSwaps, _inter_community_edges.size(), RandomSeed::get_instance().get_next_seed());
@@ -114,7 +135,7 @@ namespace LFR {
 				}
 			#else
 				// regular edge swaps
-				EdgeSwapTFP::SemiLoadedEdgeSwapTFP swapAlgo(_inter_community_edges, globalSwapsPerIteration, _number_of_nodes, _max_memory_usage);
+				EdgeSwapTFP::SemiLoadedEdgeSwapTFP swapAlgo(_inter_community_edges, globalSwapsPerIteration, _number_of_nodes, _memory_plan[MemoryPlanner::GlobalSwaps]);
 				// Generate swaps
 				uint_t numSwaps = 10*_inter_community_edges.size();
 				SwapGenerator swapGen(numSwaps, _inter_community_edges.size(), RandomSeed::get_instance().get_next_seed());
@@ -133,7 +154,8 @@ namespace LFR {
                 IOStatistics ios("GlobalGenRewire");
 
                 // rewiring in order to not to generate new intra-community edges
-                GlobalRewiringSwapGenerator rewiringSwapGenerator(_community_assignments, _inter_community_edges.size(), RandomSeed::get_instance().get_next_seed());
+                GlobalRewiringSwapGenerator rewiringSwapGenerator(_community_assignments, _inter_community_edges.size(), RandomSeed::get_instance().get_next_seed(),
+                                                                  _memory_plan.global_rewiring_sorter());
                 _inter_community_edges.rewind();
                 rewiringSwapGenerator.pushEdges(_inter_community_edges);
                 _inter_community_edges.rewind();
@@ -146,27 +168,66 @@ namespace LFR {
                     rewiringSwapGenerator.pushEdges(updatedEdges);
                 });
 
+                // Once a round has only few swaps, the remaining conflicts are resolved by
+                // SparseGlobalRewiring which avoids processing all edges in every round
+                const edgeid_t sparseThreshold = std::min<edgeid_t>(_inter_community_edges.size() / 16 + 1,
+                                                                    _memory_plan[MemoryPlanner::GlobalSwaps] / SparseGlobalRewiring::bytes_per_swap);
+                std::vector<SemiLoadedSwapDescriptor> bufferedSwaps;
+                bool sparseTail = false;
+                ProgressTask progress("LFR global rewiring rounds");
+
                 while (!rewiringSwapGenerator.empty()) {
                     int_t numSwaps = 0;
+                    bool buffering = true;
+                    bufferedSwaps.clear();
+
                     // Execute all generated swaps. Some edges might not exist in the second round anymore.
                     // Then these edges have been part of a swap already so they might not be a problem anymore.
                     // If the target edges should still be a problem we will add them again
                     while (!rewiringSwapGenerator.empty()) {
-                        swapAlgo.push(*rewiringSwapGenerator);
+                        if (buffering && static_cast<edgeid_t>(bufferedSwaps.size()) == sparseThreshold) {
+                            for (const auto& swap : bufferedSwaps)
+                                swapAlgo.push(swap);
+                            bufferedSwaps.clear();
+                            buffering = false;
+                        }
+
+                        if (buffering) {
+                            bufferedSwaps.push_back(*rewiringSwapGenerator);
+                        } else {
+                            swapAlgo.push(*rewiringSwapGenerator);
+                        }
+
                         ++numSwaps;
                         ++rewiringSwapGenerator;
                     }
 
+                    if (buffering && numSwaps > 0) {
+                        sparseTail = true;
+                        break;
+                    }
+
                     if (numSwaps > 0) {
                         STXXL_MSG("Executing global rewiring phase with " << numSwaps << " swaps.");
 
                         swapAlgo.process_swaps(); // this triggers the callback and thus pushes new edges in the generator
                         rewiringSwapGenerator.generate();
+                        progress.advance();
                     }
                 }
 
                 // flush any swaps that have not been processed yet, writes edges vector
                 swapAlgo.run();
+
+                if (sparseTail) {
+                    STXXL_MSG("Resolving remaining " << bufferedSwaps.size() << " conflicts with sparse rewiring.");
+
+                    SparseGlobalRewiring sparseRewiring(_inter_community_edges, _community_assignments, RandomSeed::get_instance().get_next_seed(),
+                                                        _memory_plan.global_rewiring_sorter());
+                    for (const auto& swap : bufferedSwaps)
+                        sparseRewiring.push(swap);
+                    sparseRewiring.run();
+                }
             }
 
         }
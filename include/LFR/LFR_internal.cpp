@@ -0,0 +1,476 @@
+#include "LFR.h"
+
+#include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <IMGraph.h>
+#include <EdgeSwaps/IMEdgeSwap.h>
+#include <SwapGenerator.h>
+#include <Utils/IntSort.h>
+#include <Utils/IOStatistics.h>
+#include <Utils/RandomSeed.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <omp.h>
+
+/*
+ * Internal memory backend of the graph generation phases. The nodes and the community
+ * assignment are already kept in std::vectors (see LFR::setInternalMemory()); the
+ * community graphs, the global graph and its rewiring are carried out on IMGraphs and
+ * all sorting is done by the parallel intsort::sort. The random processes are the same
+ * as in the EM phases (Havel-Hakimi followed by 10m random swaps; rewiring of every
+ * conflicting edge with a random partner until no conflict remains), so the output
+ * follows the same distribution. The final graph is written into _edges, which keeps
+ * it in IM as well.
+ */
+
+namespace LFR {
+    namespace {
+        //! Key of a normalized edge which is monotone in the lexicographic order
+        struct EdgeKey {
+            const uint64_t n;
+
+            uint64_t operator()(const edge_t& e) const {
+                return static_cast<uint64_t>(e.first) * n + static_cast<uint64_t>(e.second);
+            }
+
+            uint64_t operator()(const CommunityEdge& e) const {
+                return (*this)(e.edge);
+            }
+
+            uint64_t max_key() const {
+                return n * n - 1;
+            }
+        };
+
+        //! Communities of every node in CSR representation; each list is sorted
+        class NodeCommunities {
+            std::vector<edgeid_t> _begin;
+            std::vector<community_t> _communities;
+
+        public:
+            NodeCommunities(node_t n, const std::vector<CommunityAssignment>& assignments)
+                : _begin(n + 1, 0), _communities(assignments.size())
+            {
+                for (const auto& a : assignments)
+                    ++_begin[a.node_id + 1];
+
+                for (node_t u = 0; u < n; ++u)
+                    _begin[u + 1] += _begin[u];
+
+                // assignments are sorted by community, so the lists are sorted as well
+                std::vector<edgeid_t> pos(_begin.begin(), _begin.end() - 1);
+                for (const auto& a : assignments)
+                    _communities[pos[a.node_id]++] = a.community_id;
+            }
+
+            bool share_community(node_t u, node_t v) const {
+                auto iu = _communities.cbegin() + _begin[u];
+                auto iv = _communities.cbegin() + _begin[v];
+                const auto eu = _communities.cbegin() + _begin[u + 1];
+                const auto ev = _communities.cbegin() + _begin[v + 1];
+
+                while (iu != eu && iv != ev) {
+                    if (*iu == *iv) return true;
+                    if (*iu < *iv) ++iu; else ++iv;
+                }
+                return false;
+            }
+        };
+
+        std::pair<edge_t, edge_t> swap_edges(const edge_t& e0, const edge_t& e1, bool direction) {
+            edge_t t0, t1;
+            if (direction) {
+                t0 = {e0.first, e1.second};
+                t1 = {e1.first, e0.second};
+            } else {
+                t0 = {e0.first, e1.first};
+                t1 = {e0.second, e1.second};
+            }
+            t0.normalize();
+            t1.normalize();
+            return {t0, t1};
+        }
+    }
+
+    void LFR::_check_internal_memory() {
+        edgeid_t memberships = 0;
+        edgeid_t external_degree_sum = 0;
+        for (_node_sorter.rewind(); !_node_sorter.empty(); ++_node_sorter) {
+            memberships += _node_sorter->memberships();
+            external_degree_sum += _node_sorter->externalDegree(_mixing);
+        }
+        _node_sorter.rewind();
+
+        const uint_t inter_edges = static_cast<uint_t>(external_degree_sum / 2);
+        const uint_t intra_edges = static_cast<uint_t>(_degree_sum / 2) - inter_edges;
+
+        if (inter_edges > static_cast<uint_t>(IMGraph::maxEdges()))
+            throw std::runtime_error("[LFR::internal] The global graph has " + std::to_string(inter_edges)
+                                     + " edges, but IMGraph supports at most " + std::to_string(IMGraph::maxEdges())
+                                     + "; use the external memory phases instead");
+
+        // nodes and assignments, the CSR copy of the assignments, the intra-community
+        // edges including the sort buffer, the global graph and its edge list including
+        // the sort buffer, and the resulting edges
+        const uint_t required_memory =
+               static_cast<uint_t>(_number_of_nodes) * (sizeof(NodeDegreeMembership) + sizeof(edgeid_t) + sizeof(std::pair<degree_t, node_t>))
+             + static_cast<uint_t>(memberships) * (sizeof(CommunityAssignment) + sizeof(community_t))
+             + 2 * intra_edges * sizeof(CommunityEdge)
+             + IMGraph::memoryUsage(_number_of_nodes, inter_edges)
+             + 2 * inter_edges * sizeof(edge_t)
+             + (intra_edges + inter_edges + _number_of_nodes) * sizeof(node_t);
+
+        std::cout << "Internal memory backend requires about " << (required_memory / UIntScale::Mi) << " MiB" << std::endl;
+        if (required_memory > _memory_plan.budget())
+            throw std::runtime_error("[LFR::internal] Requires " + std::to_string(required_memory / UIntScale::Mi)
+                                     + " MiB, which exceeds the memory budget; use the external memory phases instead");
+    }
+
+    void LFR::_generate_graph_internal() {
+        assert(_internal_memory);
+
+        const EdgeKey edge_key{static_cast<uint64_t>(_number_of_nodes)};
+        const community_t number_of_communities = static_cast<community_t>(_community_cumulative_sizes.size()) - 1;
+        const auto& assignments = _internal_assignments;
+
+        // each community graph is an IMGraph as well
+        for (community_t com = 0; com < number_of_communities; ++com) {
+            edgeid_t degree_sum = 0;
+            for (edgeid_t i = _community_cumulative_sizes[com]; i < _community_cumulative_sizes[com + 1]; ++i)
+                degree_sum += assignments[i].degree;
+
+            if (degree_sum / 2 > IMGraph::maxEdges())
+                throw std::runtime_error("[LFR::internal] Community " + std::to_string(com) + " has "
+                                         + std::to_string(degree_sum / 2) + " edges, but IMGraph supports at most "
+                                         + std::to_string(IMGraph::maxEdges()) + "; use the external memory phases instead");
+        }
+
+        const NodeCommunities node_communities(_number_of_nodes, assignments);
+
+        // community graphs
+        std::vector<CommunityEdge> intra_edges;
+        {
+            IOStatistics ios("GenCommGraphsIM");
+
+            std::vector<std::vector<CommunityEdge>> thread_edges(omp_get_max_threads());
+
+            #pragma omp parallel
+            {
+                auto& local_edges = thread_edges[omp_get_thread_num()];
+                std::vector<degree_t> degrees;
+
+                #pragma omp for schedule(dynamic, 1)
+                for (community_t com = 0; com < number_of_communities; ++com) {
+                    const node_t com_size = _community_size(com);
+                    if (com_size < 2)
+                        continue; // no edges to create
+
+                    const auto first = assignments.cbegin() + _community_cumulative_sizes[com];
+
+                    degrees.clear();
+                    HavelHakimiIMGenerator gen(HavelHakimiIMGenerator::DecreasingDegree);
+                    for (node_t i = 0; i < com_size; ++i) {
+                        degrees.push_back(first[i].degree);
+                        gen.push(first[i].degree);
+                    }
+                    gen.generate();
+
+                    IMGraph graph(degrees);
+                    for (; !gen.empty(); ++gen)
+                        graph.addEdge(*gen);
+
+                    if (graph.numEdges() > 1) {
+                        IMEdgeSwap swapAlgo(graph);
+                        for (SwapGenerator swapGen(10 * graph.numEdges(), graph.numEdges(), RandomSeed::get_instance().get_seed(com)); !swapGen.empty(); ++swapGen)
+                            swapAlgo.push(*swapGen);
+                        swapAlgo.run();
+                    }
+
+                    for (auto it = graph.getEdges(); !it.empty(); ++it) {
+                        edge_t e = {first[it->first].node_id, first[it->second].node_id};
+                        e.normalize();
+                        local_edges.emplace_back(com, e);
+                    }
+                }
+            }
+
+            size_t total = 0;
+            for (const auto& v : thread_edges)
+                total += v.size();
+
+            intra_edges.reserve(total);
+            for (auto& v : thread_edges) {
+                intra_edges.insert(intra_edges.end(), v.begin(), v.end());
+                std::vector<CommunityEdge>().swap(v);
+            }
+
+            if (_overlap_max_memberships > 1)
+                _rewire_community_duplicates_internal(intra_edges);
+
+            intsort::sort(intra_edges, edge_key, edge_key.max_key());
+        }
+
+        // global graph
+        std::vector<edge_t> inter_edges;
+        {
+            IOStatistics ios("GenGlobGraphIM");
+
+            // rank nodes by decreasing external degree; nodes without external degree are omitted
+            std::vector<std::pair<degree_t, node_t>> ext_degrees;
+            ext_degrees.reserve(_number_of_nodes);
+            degree_t max_degree = 0;
+            _node_sorter.rewind();
+            for (node_t u = 0; u < _number_of_nodes; ++u, ++_node_sorter) {
+                const degree_t d = _node_sorter->externalDegree(_mixing);
+                if (d) ext_degrees.emplace_back(d, u);
+                max_degree = std::max(max_degree, d);
+            }
+            _node_sorter.rewind();
+
+            intsort::sort(ext_degrees, [max_degree] (const std::pair<degree_t, node_t>& x) {
+                return static_cast<uint64_t>(max_degree - x.first);
+            }, static_cast<uint64_t>(max_degree));
+
+            std::vector<degree_t> degrees(ext_degrees.size());
+            std::vector<node_t> rank_to_node(ext_degrees.size());
+            HavelHakimiIMGenerator gen(HavelHakimiIMGenerator::DecreasingDegree);
+            for (size_t i = 0; i < ext_degrees.size(); ++i) {
+                degrees[i] = ext_degrees[i].first;
+                rank_to_node[i] = ext_degrees[i].second;
+                gen.push(degrees[i]);
+            }
+            std::vector<std::pair<degree_t, node_t>>().swap(ext_degrees);
+
+            const bool has_edges = !degrees.empty();
+            if (has_edges)
+                gen.generate();
+
+            IMGraph graph(degrees);
+            std::vector<degree_t>().swap(degrees);
+            for (; has_edges && !gen.empty(); ++gen)
+                graph.addEdge(*gen);
+
+            // global edges still connecting nodes of a common community (by edge id)
+            std::vector<edgeid_t> conflicts;
+
+            if (graph.numEdges() > 1) {
+                IMEdgeSwap swapAlgo(graph);
+                for (SwapGenerator swapGen(10 * graph.numEdges(), graph.numEdges(), RandomSeed::get_instance().get_next_seed()); !swapGen.empty(); ++swapGen)
+                    swapAlgo.push(*swapGen);
+                swapAlgo.run();
+
+                // rewiring in order to not to generate new intra-community edges
+                std::mt19937_64 gen64(RandomSeed::get_instance().get_next_seed());
+                std::uniform_int_distribution<edgeid_t> partner_distr(0, graph.numEdges() - 1);
+                std::vector<std::vector<edgeid_t>> thread_conflicts(omp_get_max_threads());
+
+                // if the conflicts stop decreasing (e.g. almost all nodes share a community),
+                // the remaining conflicting edges are dropped
+                constexpr unsigned int max_stalled_iterations = 10;
+                size_t min_conflicts = std::numeric_limits<size_t>::max();
+                unsigned int stalled_iterations = 0;
+
+                for (unsigned int iteration = 1; ; ++iteration) {
+                    #pragma omp parallel
+                    {
+                        auto& local = thread_conflicts[omp_get_thread_num()];
+                        local.clear();
+
+                        #pragma omp for schedule(static)
+                        for (edgeid_t eid = 0; eid < static_cast<edgeid_t>(graph.numEdges()); ++eid) {
+                            const edge_t e = graph.getEdge(eid);
+                            if (node_communities.share_community(rank_to_node[e.first], rank_to_node[e.second]))
+                                local.push_back(eid);
+                        }
+                    }
+
+                    conflicts.clear();
+                    for (const auto& v : thread_conflicts)
+                        conflicts.insert(conflicts.end(), v.begin(), v.end());
+
+                    if (conflicts.empty())
+                        break;
+
+                    if (conflicts.size() < min_conflicts) {
+                        min_conflicts = conflicts.size();
+                        stalled_iterations = 0;
+                    } else if (++stalled_iterations == max_stalled_iterations) {
+                        std::cout << "Global rewiring does not converge; give up and delete " << conflicts.size()
+                                  << " conflicting edges" << std::endl;
+                        break;
+                    }
+
+                    STXXL_MSG("Executing global rewiring phase " << iteration << " with " << conflicts.size() << " swaps.");
+
+                    for (const edgeid_t eid : conflicts)
+                        graph.swapEdges(eid, partner_distr(gen64), gen64() & 1);
+                }
+            }
+
+            // conflicts is sorted by edge id and only non-empty if the rewiring gave up
+            inter_edges.reserve(graph.numEdges());
+            auto conflict = conflicts.cbegin();
+            edgeid_t eid = 0;
+            for (auto it = graph.getEdges(); !it.empty(); ++it, ++eid) {
+                if (conflict != conflicts.cend() && *conflict == eid) {
+                    ++conflict;
+                    continue;
+                }
+
+                edge_t e = {rank_to_node[it->first], rank_to_node[it->second]};
+                e.normalize();
+                inter_edges.push_back(e);
+            }
+
+            intsort::sort(inter_edges, edge_key, edge_key.max_key());
+        }
+
+        // merge
+        {
+            IOStatistics ios("MergeGraphsIM");
+
+            _edges.clear();
+
+            edge_t cur_edge = edge_t::invalid();
+            int_t discarded_edges = 0;
+
+            auto intra = intra_edges.cbegin();
+            auto inter = inter_edges.cbegin();
+            while (intra != intra_edges.cend() || inter != inter_edges.cend()) {
+                if (inter == inter_edges.cend() || (intra != intra_edges.cend() && intra->edge <= *inter)) {
+                    if (cur_edge != intra->edge) {
+                        cur_edge = intra->edge;
+                        _edges.push(cur_edge);
+                    } else {
+                        ++discarded_edges;
+                    }
+                    ++intra;
+                } else {
+                    assert(cur_edge != *inter && "Global edges should have been rewired to not to conflict with any internal edge!");
+                    cur_edge = *inter;
+                    _edges.push(cur_edge);
+                    ++inter;
+                }
+            }
+
+            if (discarded_edges > 0)
+                STXXL_MSG("Discarded " << discarded_edges << " internal edges that were in multiple communities of in total " << _edges.size() << " edges.");
+        }
+
+        std::cout << "Resulting graph has " << _edges.size() << " edges, " << intra_edges.size() << " of them are intra-community edges and " <<
+                  inter_edges.size() << " of them are inter-community edges. Mixing: "
+                  << (static_cast<double>(inter_edges.size()) / _edges.size())
+                  << std::endl;
+    }
+
+    /*
+     * Internal counterpart of CommunityEdgeRewiringSwaps: an edge contained in several
+     * communities is kept once (chosen uniformly at random) and all other copies are swapped
+     * with a random edge of their community. Swaps creating a loop or an edge that already
+     * exists are rejected; every edge takes part in at most one swap per round.
+     */
+    void LFR::_rewire_community_duplicates_internal(std::vector<CommunityEdge>& edges) {
+        const community_t number_of_communities = static_cast<community_t>(_community_cumulative_sizes.size()) - 1;
+        const EdgeKey edge_key{static_cast<uint64_t>(_number_of_nodes)};
+
+        // group edges by community
+        intsort::sort(edges, [] (const CommunityEdge& e) {return static_cast<uint64_t>(e.community_id);},
+                      static_cast<uint64_t>(std::max<community_t>(1, number_of_communities - 1)));
+
+        std::vector<edgeid_t> com_begin(number_of_communities + 1, 0);
+        for (const auto& e : edges)
+            ++com_begin[e.community_id + 1];
+        for (community_t c = 0; c < number_of_communities; ++c)
+            com_begin[c + 1] += com_begin[c];
+
+        std::mt19937_64 gen(RandomSeed::get_instance().get_next_seed());
+
+        std::vector<std::pair<uint64_t, edgeid_t>> keys(edges.size());
+        std::vector<edgeid_t> duplicates;
+        std::vector<bool> touched(edges.size());
+
+        size_t last_duplicates = std::numeric_limits<size_t>::max();
+        unsigned int retry_count = 0;
+
+        for (unsigned int iteration = 1; ; ++iteration) {
+            #pragma omp parallel for schedule(static)
+            for (edgeid_t i = 0; i < static_cast<edgeid_t>(edges.size()); ++i)
+                keys[i] = {edge_key(edges[i]), i};
+
+            intsort::sort(keys, [] (const std::pair<uint64_t, edgeid_t>& x) {return x.first;}, edge_key.max_key());
+
+            // all copies but a random one of each duplicate edge
+            duplicates.clear();
+            for (size_t i = 0; i < keys.size(); ) {
+                size_t j = i + 1;
+                for (; j < keys.size() && keys[j].first == keys[i].first; ++j);
+
+                if (j - i > 1) {
+                    const size_t keep = std::uniform_int_distribution<size_t>(i, j - 1)(gen);
+                    for (size_t k = i; k < j; ++k)
+                        if (k != keep) duplicates.push_back(keys[k].second);
+                }
+
+                i = j;
+            }
+
+            std::cout << "---- Rewiring Iteration: " << iteration
+                      << " duplicates: " << duplicates.size()
+                      << " edges: " << edges.size()
+                      << " fraction: " << (100. * duplicates.size() / edges.size())
+                      << std::endl;
+
+            if (duplicates.empty())
+                break;
+
+            if (duplicates.size() == last_duplicates && last_duplicates < edges.size() * 1e-3) {
+                if (++retry_count == 5) {
+                    std::cout << "Community rewiring does not converge; give up and delete duplicates" << std::endl;
+                    break;
+                }
+            } else {
+                retry_count = 0;
+                last_duplicates = duplicates.size();
+            }
+
+            auto exists = [&] (const edge_t& e) {
+                const uint64_t k = edge_key(e);
+                auto it = std::lower_bound(keys.cbegin(), keys.cend(), std::make_pair(k, edgeid_t(0)));
+                return it != keys.cend() && it->first == k;
+            };
+
+            std::fill(touched.begin(), touched.end(), false);
+
+            auto try_swap = [&] (edgeid_t i, edgeid_t j) {
+                if (i == j || touched[i] || touched[j])
+                    return;
+
+                const auto t = swap_edges(edges[i].edge, edges[j].edge, gen() & 1);
+                if (t.first.is_loop() || t.second.is_loop() || t.first == t.second || exists(t.first) || exists(t.second))
+                    return;
+
+                edges[i].edge = t.first;
+                edges[j].edge = t.second;
+                touched[i] = touched[j] = true;
+            };
+
+            for (const edgeid_t i : duplicates) {
+                const community_t com = edges[i].community_id;
+                std::uniform_int_distribution<edgeid_t> partner(com_begin[com], com_begin[com + 1] - 1);
+                try_swap(i, partner(gen));
+
+                // additional random swaps within the same community
+                if (std::uniform_real_distribution<double>()(gen) < _community_rewiring_random)
+                    try_swap(partner(gen), partner(gen));
+            }
+        }
+
+        // sort by edge and drop remaining duplicates (only if the rewiring did not converge)
+        intsort::sort(edges, edge_key, edge_key.max_key());
+        edges.erase(std::unique(edges.begin(), edges.end(), [] (const CommunityEdge& a, const CommunityEdge& b) {
+            return a.edge == b.edge;
+        }), edges.end());
+    }
+}
@@ -31,18 +31,23 @@ namespace LFR {
 
         using node_deg_t = std::pair<node_t, degree_t>;
         using ndcompare_t = GenericComparator<node_deg_t>::Ascending;
-        stxxl::sorter<node_deg_t, ndcompare_t> nds(ndcompare_t{}, SORTER_MEM);
+        using nds_sorter_t = stxxl::sorter<node_deg_t, ndcompare_t>;
 
-        using reader_t = typename decltype(_community_assignments)::bufreader_type;
+        // the internal memory backend sorts the (node, degree) pairs in a vector
+        std::unique_ptr<nds_sorter_t> nds;
+        std::vector<node_deg_t> nds_internal;
+        if (!_internal_memory)
+            nds.reset(new nds_sorter_t(ndcompare_t{}, _memory_plan[MemoryPlanner::VerifyMembershipSorter]));
 
 
         node_t last_node = INVALID_NODE;
         // check that community capacity is not exceeded and that all node
         // have sufficiently many neighbors
-        for (reader_t reader(_community_assignments); !reader.empty(); ++reader) {
-            const CommunityAssignment &a = *reader;
-
-            nds.push({a.node_id, a.degree});
+        _for_each_assignment([&] (const CommunityAssignment &a) {
+            if (nds)
+                nds->push({a.node_id, a.degree});
+            else
+                nds_internal.push_back({a.node_id, a.degree});
 
             if (a.community_id == com) {
                 size++;
@@ -69,15 +74,19 @@ namespace LFR {
             }
 
             last_node = a.node_id;
-        }
+        });
 
         STABLE_EXPECT_EQ(size, _community_size(com));
         STABLE_EXPECT_GE(size, max_deg);
 
         // check that intra-degree of every node is met
         {
-            nds.sort();
-            node_t cur_node = (*nds).first;
+            if (nds)
+                nds->sort();
+            else
+                SEQPAR::sort(nds_internal.begin(), nds_internal.end(), ndcompare_t{});
+
+            node_t cur_node = nds ? (**nds).first : nds_internal.front().first;
             degree_t degree = 0;
             _node_sorter.rewind();
             node_t nid = 0;
@@ -97,9 +106,7 @@ namespace LFR {
                 }
             };
 
-            for (; !nds.empty(); ++nds) {
-                const node_deg_t &nd = *nds;
-
+            auto visit = [&] (const node_deg_t &nd) {
                 if (cur_node == nd.first) {
                     degree += nd.second;
                     memberships++;
@@ -109,6 +116,14 @@ namespace LFR {
                     degree = nd.second;
                     memberships = 1;
                 }
+            };
+
+            if (nds) {
+                for (; !nds->empty(); ++(*nds))
+                    visit(**nds);
+            } else {
+                for (const auto& nd : nds_internal)
+                    visit(nd);
             }
             check_node();
             ++_node_sorter;
@@ -128,7 +143,15 @@ namespace LFR {
         //  - node deg. distribution matches request
 
         _edges.consume();
-        stxxl::sorter<node_t, GenericComparator<node_t>::Ascending> nodes(GenericComparator<node_t>::Ascending(), SORTER_MEM);
+        using nodes_sorter_t = stxxl::sorter<node_t, GenericComparator<node_t>::Ascending>;
+
+        // the internal memory backend counts the degrees directly instead of sorting the endpoints
+        std::unique_ptr<nodes_sorter_t> nodes;
+        std::vector<degree_t> internal_degrees;
+        if (_internal_memory)
+            internal_degrees.assign(_number_of_nodes, 0);
+        else
+            nodes.reset(new nodes_sorter_t(GenericComparator<node_t>::Ascending(), _memory_plan[MemoryPlanner::VerifyDegreeSorter]));
 
         edge_t last_edge = edge_t::invalid();
         for(_edges.consume(); !_edges.empty(); ++_edges) {
@@ -137,15 +160,18 @@ namespace LFR {
             STABLE_EXPECT_NE(last_edge, edge);
             STABLE_EXPECT(!edge.is_loop());
 
-            nodes.push(edge.first);
-            nodes.push(edge.second);
+            if (nodes) {
+                nodes->push(edge.first);
+                nodes->push(edge.second);
+            } else {
+                internal_degrees[edge.first]++;
+                internal_degrees[edge.second]++;
+            }
         }
 
         std::vector<degree_t> node_degrees;
 
-        nodes.sort();
         {
-            DistributionCount<decltype(nodes), node_t> dc(nodes);
             _node_sorter.rewind();
 
             if (use_im_checks) {
@@ -160,8 +186,7 @@ namespace LFR {
             node_t nodes_ceiled = 0;
 
             edgeid_t total_degree = 0;
-            for(; !dc.empty(); ++dc) {
-                const auto & cur = *dc;
+            auto check_degree = [&] (const DistributionBlockDescriptor<node_t>& cur) {
                 total_degree += cur.count;
 
                 if (use_im_checks)
@@ -184,6 +209,17 @@ namespace LFR {
                     unmaterialized += degree - count;
                     not_matching++;
                 }
+            };
+
+            if (nodes) {
+                nodes->sort();
+                for(DistributionCount<nodes_sorter_t, node_t> dc(*nodes); !dc.empty(); ++dc)
+                    check_degree(*dc);
+            } else {
+                for(node_t u = 0; u < _number_of_nodes; ++u)
+                    if (internal_degrees[u])
+                        check_degree({u, static_cast<stxxl::uint64>(internal_degrees[u]), 0});
+                std::vector<degree_t>().swap(internal_degrees);
             }
 
             std::cout << "Found " << not_matching << " nodes with too low degree. "
@@ -223,16 +259,13 @@ namespace LFR {
                            [&memberships] (const edgeid_t & off) {return memberships.begin() + off;}
             );
 
-            for(typename decltype(_community_assignments)::bufreader_type reader(_community_assignments);
-                !reader.empty(); ++reader) {
-                const CommunityAssignment& as = *reader;
-
+            _for_each_assignment([&] (const CommunityAssignment& as) {
                 auto & ptr = node_writers.at(as.node_id);
                 auto dist = std::distance(memberships.begin(), ptr);
                 STABLE_EXPECT_LS(dist, member_offset.at(as.node_id+1));
                 *ptr = as.community_id;
                 ++ptr;
-            }
+            });
 
             for(node_t nid=0; nid < _number_of_nodes; ++nid) {
                 auto begin = memberships.begin() + member_offset[nid  ];
@@ -0,0 +1,233 @@
+#include "LFR.h"
+
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <omp.h>
+
+namespace LFR {
+    /*
+     * Semi-external verification: the community of every node (plus the lists of the
+     * few overlapping nodes) and the realised intra/inter degrees are kept in IM, while
+     * the edges, the assignment and the requested degrees are streamed exactly once.
+     * Edges and nodes are read in chunks which are processed in parallel; each thread
+     * accumulates its own report which are merged at the end of the chunk. Per-thread
+     * degree arrays would multiply the memory by the number of threads, hence the
+     * degrees are shared atomics (see the edge scan for how contention is avoided).
+     */
+    VerificationReport LFR::verify_graph() {
+        constexpr size_t chunk_size = 1 << 20;
+        constexpr community_t no_community = std::numeric_limits<community_t>::max();
+
+        const uint_t required_memory = static_cast<uint_t>(_number_of_nodes) * (sizeof(community_t) + 2 * sizeof(degree_t));
+        if (required_memory > _memory_plan.budget())
+            throw std::runtime_error("[LFR::verify_graph] Requires " + std::to_string(required_memory / UIntScale::Mi)
+                                     + " MiB, which exceeds the memory budget");
+
+        VerificationReport report;
+        report.requested_mixing = _mixing;
+
+        // load memberships: a non-negative value is the only community of the node,
+        // a negative value -(i+1) refers to the i-th list of an overlapping node
+        std::vector<community_t> primary(_number_of_nodes, no_community);
+        std::vector<std::vector<community_t>> overlapping;
+        {
+            const community_t number_of_communities = static_cast<community_t>(_community_cumulative_sizes.size()) - 1;
+            community_t com = 0;
+            node_t com_size = 0;
+
+            auto finish_community = [&] () {
+                report.communities++;
+                report.empty_communities += !com_size;
+                report.community_size_mismatches += (com_size != _community_size(com));
+            };
+
+            _for_each_assignment([&] (const CommunityAssignment& a) {
+                for (; com < a.community_id; ++com, com_size = 0)
+                    finish_community();
+                ++com_size;
+
+                if (UNLIKELY(a.node_id < 0 || a.node_id >= _number_of_nodes)) {
+                    report.membership_mismatches++;
+                    return;
+                }
+
+                auto& p = primary[a.node_id];
+                if (p == no_community) {
+                    p = a.community_id;
+                } else {
+                    if (p >= 0) {
+                        overlapping.push_back({p});
+                        p = -static_cast<community_t>(overlapping.size());
+                    }
+                    // assignments are sorted by community, so the lists are sorted as well
+                    overlapping[-p - 1].push_back(a.community_id);
+                }
+            });
+
+            for (; com < number_of_communities; ++com, com_size = 0)
+                finish_community();
+        }
+
+        using range_t = std::pair<const community_t*, const community_t*>;
+        auto communities_of = [&] (const node_t u) -> range_t {
+            const community_t& p = primary[u];
+            if (p == no_community)
+                return {&p, &p};
+            if (p >= 0)
+                return {&p, &p + 1};
+
+            const auto& list = overlapping[-p - 1];
+            return {list.data(), list.data() + list.size()};
+        };
+
+        auto is_intra_edge = [&] (const edge_t& e) {
+            const community_t cu = primary[e.first];
+            const community_t cv = primary[e.second];
+            if (LIKELY(cu >= 0 && cv >= 0))
+                return cu == cv && cu != no_community;
+
+            range_t ru = communities_of(e.first);
+            range_t rv = communities_of(e.second);
+            while (ru.first != ru.second && rv.first != rv.second) {
+                if (*ru.first == *rv.first) return true;
+                if (*ru.first < *rv.first) ++ru.first; else ++rv.first;
+            }
+            return false;
+        };
+
+        // single scan over the edges
+        std::vector<std::atomic<degree_t>> intra_degree(_number_of_nodes);
+        std::vector<std::atomic<degree_t>> inter_degree(_number_of_nodes);
+        for (node_t u = 0; u < _number_of_nodes; ++u) {
+            intra_degree[u].store(0, std::memory_order_relaxed);
+            inter_degree[u].store(0, std::memory_order_relaxed);
+        }
+
+        {
+            std::vector<edge_t> chunk;
+            chunk.reserve(chunk_size);
+            edge_t last_edge = edge_t::invalid();
+
+            for (_edges.rewind(); !_edges.empty(); ) {
+                chunk.clear();
+                for (; !_edges.empty() && chunk.size() < chunk_size; ++_edges)
+                    chunk.push_back(*_edges);
+
+                #pragma omp parallel
+                {
+                    VerificationReport local;
+
+                    // The edges are sorted, so the degrees of first endpoints are accumulated
+                    // per run and only added once per node. As nodes are ordered by decreasing
+                    // degree, hubs mostly are first endpoints and rarely contend on the atomics.
+                    node_t run_node = -1;
+                    degree_t run_intra = 0;
+                    degree_t run_inter = 0;
+                    auto flush_run = [&] () {
+                        if (run_node < 0)
+                            return;
+                        if (run_intra)
+                            intra_degree[run_node].fetch_add(run_intra, std::memory_order_relaxed);
+                        if (run_inter)
+                            inter_degree[run_node].fetch_add(run_inter, std::memory_order_relaxed);
+                    };
+
+                    #pragma omp for schedule(static)
+                    for (size_t i = 0; i < chunk.size(); ++i) {
+                        const edge_t& e = chunk[i];
+                        const edge_t& prev = i ? chunk[i - 1] : last_edge;
+
+                        local.edges++;
+
+                        if (!prev.is_invalid()) {
+                            local.multi_edges += (e == prev);
+                            local.unsorted_edges += (e < prev);
+                        }
+
+                        if (UNLIKELY(e.first < 0 || e.second < 0 || e.first >= _number_of_nodes || e.second >= _number_of_nodes)) {
+                            local.invalid_edges++;
+                            continue;
+                        }
+
+                        if (UNLIKELY(e.is_loop())) {
+                            local.self_loops++;
+                            continue;
+                        }
+
+                        if (e.first != run_node) {
+                            flush_run();
+                            run_node = e.first;
+                            run_intra = run_inter = 0;
+                        }
+
+                        const bool intra = is_intra_edge(e);
+                        (intra ? local.intra_edges : local.inter_edges)++;
+                        (intra ? run_intra : run_inter)++;
+                        (intra ? intra_degree : inter_degree)[e.second].fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    flush_run();
+
+                    #pragma omp critical (_verify_graph_merge)
+                    report.merge(local);
+                }
+
+                last_edge = chunk.back();
+            }
+            _edges.rewind();
+        }
+
+        // compare with the requested degrees and memberships
+        {
+            std::vector<NodeDegreeMembership> chunk;
+            chunk.reserve(chunk_size);
+
+            node_t first_node = 0;
+            for (_node_sorter.rewind(); !_node_sorter.empty(); first_node += static_cast<node_t>(chunk.size())) {
+                chunk.clear();
+                for (; !_node_sorter.empty() && chunk.size() < chunk_size; ++_node_sorter)
+                    chunk.push_back(*_node_sorter);
+
+                #pragma omp parallel
+                {
+                    VerificationReport local;
+
+                    #pragma omp for schedule(static)
+                    for (size_t i = 0; i < chunk.size(); ++i) {
+                        const NodeDegreeMembership& ndm = chunk[i];
+                        const node_t u = first_node + static_cast<node_t>(i);
+
+                        local.nodes++;
+
+                        const degree_t intra = intra_degree[u].load(std::memory_order_relaxed);
+                        const degree_t degree = intra + inter_degree[u].load(std::memory_order_relaxed);
+
+                        const int64_t missing = static_cast<int64_t>(ndm.degree()) - degree;
+                        local.degree_mismatches += (missing != 0);
+                        local.degree_overassigned += (missing < 0);
+                        local.missing_degree += missing;
+                        local.degree_deviation[VerificationReport::deviation_bucket(missing)]++;
+
+                        const int64_t missing_intra = static_cast<int64_t>(ndm.totalInternalDegree(_mixing)) - intra;
+                        local.intra_degree_mismatches += (missing_intra != 0);
+                        local.missing_intra_degree += missing_intra;
+
+                        const range_t coms = communities_of(u);
+                        const auto memberships = std::distance(coms.first, coms.second);
+                        local.uncovered_nodes += !memberships;
+                        local.membership_mismatches += (memberships != ndm.memberships());
+                    }
+
+                    #pragma omp critical (_verify_graph_merge)
+                    report.merge(local);
+                }
+            }
+            _node_sorter.rewind();
+
+            report.node_count_mismatch = (static_cast<node_t>(report.nodes) != _number_of_nodes);
+        }
+
+        return report;
+    }
+}
@@ -0,0 +1,337 @@
+#include <LFR/SparseGlobalRewiring.h>
+
+#include <GenericComparator.h>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <unordered_set>
+
+namespace {
+    uint64_t edge_key(const edge_t& e) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(e.first)) << 32) | static_cast<uint32_t>(e.second);
+    }
+
+    //! see SemiLoadedSwapDescriptor::direction
+    std::pair<edge_t, edge_t> swap_edges(const edge_t& e0, const edge_t& e1, bool direction) {
+        edge_t t0, t1;
+        if (direction) {
+            t0 = {e0.first, e1.second};
+            t1 = {e1.first, e0.second};
+        } else {
+            t0 = {e0.first, e1.first};
+            t1 = {e0.second, e1.second};
+        }
+        t0.normalize();
+        t1.normalize();
+        return {t0, t1};
+    }
+}
+
+void SparseGlobalRewiring::_build_node_communities() {
+    stxxl::sorter<NodeCommunity, GenericComparatorStruct<NodeCommunity>::Ascending> sorter(GenericComparatorStruct<NodeCommunity>::Ascending(), _sorter_mem);
+
+    #pragma omp critical (_community_assignment)
+    for (stxxl::vector<LFR::CommunityAssignment>::bufreader_type reader(_community_assignments); !reader.empty(); ++reader)
+        sorter.push(NodeCommunity {reader->node_id, reader->community_id});
+
+    sorter.sort();
+    _node_communities.resize(sorter.size());
+    stxxl::stream::materialize(sorter, _node_communities.begin(), _node_communities.end());
+}
+
+void SparseGlobalRewiring::_scan(const std::vector<edge_t>& queries, std::vector<bool>& exists,
+                                 const std::vector<std::pair<edgeid_t, size_t>>& requests, std::vector<edge_t>& loaded) {
+    auto q = queries.cbegin();
+    auto req = requests.cbegin();
+    edgeid_t pos = 0;
+    for (_edges.rewind(); !_edges.empty() && (q != queries.cend() || req != requests.cend()); ++_edges, ++pos) {
+        const edge_t e = *_edges;
+
+        for (; q != queries.cend() && *q < e; ++q);
+        if (q != queries.cend() && *q == e)
+            exists[std::distance(queries.cbegin(), q)] = true;
+
+        for (; req != requests.cend() && req->first == pos; ++req)
+            loaded[req->second] = e;
+    }
+}
+
+edge_t SparseGlobalRewiring::_current(const edge_t& e) const {
+    auto it = _replaced_index.find(edge_key(e));
+    return it == _replaced_index.cend() ? e : _replacements[it->second];
+}
+
+void SparseGlobalRewiring::_replace(const edge_t& e, const edge_t& t) {
+    size_t slot;
+
+    auto it = _replacement_index.find(edge_key(e));
+    if (it != _replacement_index.end()) {
+        // e was created by an earlier swap
+        slot = it->second;
+        _replacement_index.erase(it);
+    } else {
+        slot = _replaced.size();
+        _replaced.push_back(e);
+        _replacements.push_back(e);
+        _replaced_index.emplace(edge_key(e), slot);
+    }
+
+    _replacements[slot] = t;
+    _replacement_index.emplace(edge_key(t), slot);
+}
+
+void SparseGlobalRewiring::_remove(const edge_t& e) {
+    auto it = _replacement_index.find(edge_key(e));
+    if (it != _replacement_index.end()) {
+        // e was created by an earlier swap
+        _replacements[it->second] = edge_t::invalid();
+        _replacement_index.erase(it);
+    } else {
+        _replaced_index.emplace(edge_key(e), _replaced.size());
+        _replaced.push_back(e);
+        _replacements.push_back(edge_t::invalid());
+    }
+}
+
+void SparseGlobalRewiring::_fetch_communities(std::vector<node_t> nodes) {
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    const auto& node_communities = _node_communities;
+    for (const node_t u : nodes) {
+        if (_community_cache.count(u))
+            continue;
+
+        auto& communities = _community_cache[u];
+        for (auto it = std::lower_bound(node_communities.cbegin(), node_communities.cend(), NodeCommunity {u, 0});
+             it != node_communities.cend() && (*it).node == u; ++it)
+            communities.push_back((*it).community);
+    }
+}
+
+std::vector<edge_t> SparseGlobalRewiring::_conflicting(const std::vector<edge_t>& edges) {
+    {
+        std::vector<node_t> nodes;
+        nodes.reserve(2 * edges.size());
+        for (const auto& e : edges) {
+            nodes.push_back(e.first);
+            nodes.push_back(e.second);
+        }
+        _fetch_communities(std::move(nodes));
+    }
+
+    std::vector<edge_t> result;
+    for (const auto& e : edges) {
+        const auto& cu = _community_cache.at(e.first);
+        const auto& cv = _community_cache.at(e.second);
+
+        auto iu = cu.cbegin();
+        auto iv = cv.cbegin();
+        while (iu != cu.cend() && iv != cv.cend()) {
+            if (*iu == *iv) {
+                result.push_back(e);
+                break;
+            }
+            if (*iu < *iv) ++iu; else ++iv;
+        }
+    }
+
+    return result;
+}
+
+void SparseGlobalRewiring::_merge() {
+    if (_replaced.empty())
+        return;
+
+    std::vector<edge_t> removed(_replaced);
+    std::vector<edge_t> added;
+    added.reserve(_replacements.size());
+    for (const auto& e : _replacements)
+        if (!e.is_invalid())
+            added.push_back(e);
+    std::sort(removed.begin(), removed.end());
+    std::sort(added.begin(), added.end());
+
+    EdgeStream output;
+    {
+        auto rem = removed.cbegin();
+        auto add = added.cbegin();
+        for (_edges.rewind(); !_edges.empty(); ++_edges) {
+            const edge_t e = *_edges;
+            for (; add != added.cend() && *add < e; ++add)
+                output.push(*add);
+
+            if (rem != removed.cend() && *rem == e) {
+                ++rem;
+                continue;
+            }
+
+            output.push(e);
+        }
+
+        for (; add != added.cend(); ++add)
+            output.push(*add);
+
+        assert(rem == removed.cend());
+    }
+
+    // the reader has to be released before its buffer
+    _edges.clear();
+    _edges = std::move(output);
+}
+
+void SparseGlobalRewiring::run() {
+    const edgeid_t num_edges = _edges.size();
+    if (num_edges < 2) {
+        _swaps.clear();
+        _edges.rewind();
+        return;
+    }
+
+    std::uniform_int_distribution<edgeid_t> partner_distr(0, num_edges - 1);
+    std::bernoulli_distribution direction_distr;
+
+    _build_node_communities();
+
+    { // partners of the swaps pushed
+        std::vector<std::pair<edgeid_t, size_t>> requests(_swaps.size());
+        for (size_t i = 0; i < _swaps.size(); ++i)
+            requests[i] = {_swaps[i].eid(), i};
+        std::sort(requests.begin(), requests.end());
+
+        std::vector<bool> no_exists;
+        _partners.assign(_swaps.size(), edge_t::invalid());
+        _scan({}, no_exists, requests, _partners);
+    }
+
+    size_t min_conflicts = std::numeric_limits<size_t>::max();
+    unsigned int stalled_rounds = 0;
+
+    for (unsigned int round = 1; !_swaps.empty(); ++round) {
+        if (_swaps.size() < min_conflicts) {
+            min_conflicts = _swaps.size();
+            stalled_rounds = 0;
+        } else if (++stalled_rounds == max_stalled_rounds) {
+            std::cout << "Sparse global rewiring does not converge; give up and delete " << _swaps.size()
+                      << " conflicting edges" << std::endl;
+            for (const auto& swap : _swaps)
+                _remove(swap.edge());
+            _swaps.clear();
+            _partners.clear();
+            break;
+        }
+
+        STXXL_MSG("Sparse global rewiring round " << round << " with " << _swaps.size() << " conflicting edges");
+
+        struct Candidate {
+            edge_t edges[2];
+            edge_t targets[2];
+        };
+
+        // select swaps with disjoint edges
+        std::vector<Candidate> candidates;
+        std::vector<edge_t> deferred; // conflicting edges to be retried in the next round
+        {
+            std::unordered_set<uint64_t> used;
+            for (size_t i = 0; i < _swaps.size(); ++i) {
+                const edge_t& e0 = _swaps[i].edge();
+                const edge_t e1 = _current(_partners[i]);
+
+                if (e0 == e1 || used.count(edge_key(e0)) || used.count(edge_key(e1))) {
+                    deferred.push_back(e0);
+                    continue;
+                }
+
+                const auto t = swap_edges(e0, e1, _swaps[i].direction());
+                if (t.first.is_loop() || t.second.is_loop()) {
+                    deferred.push_back(e0);
+                    continue;
+                }
+
+                used.insert(edge_key(e0));
+                used.insert(edge_key(e1));
+                candidates.push_back(Candidate{{e0, e1}, {t.first, t.second}});
+            }
+        }
+
+        // only targets not decided by the delta are looked up in the stream
+        std::vector<edge_t> queries;
+        for (const auto& c : candidates) {
+            for (const auto& t : c.targets) {
+                if (!_replacement_index.count(edge_key(t)) && !_replaced_index.count(edge_key(t)))
+                    queries.push_back(t);
+            }
+        }
+        std::sort(queries.begin(), queries.end());
+        queries.erase(std::unique(queries.begin(), queries.end()), queries.end());
+
+        // every swap yields at most two conflicts in the next round, so draw as many partners
+        std::vector<edgeid_t> positions(2 * _swaps.size());
+        std::vector<std::pair<edgeid_t, size_t>> requests(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            positions[i] = partner_distr(_gen);
+            requests[i] = {positions[i], i};
+        }
+        std::sort(requests.begin(), requests.end());
+
+        std::vector<bool> exists(queries.size(), false);
+        std::vector<edge_t> next_partners(positions.size(), edge_t::invalid());
+        _scan(queries, exists, requests, next_partners);
+
+        // decided before any swap of this round changes the delta
+        auto existing = [&] (const edge_t& e) {
+            if (_replacement_index.count(edge_key(e)))
+                return true;
+            if (_replaced_index.count(edge_key(e)))
+                return false;
+            return static_cast<bool>(exists[std::distance(queries.cbegin(), std::lower_bound(queries.cbegin(), queries.cend(), e))]);
+        };
+
+        std::vector<bool> rejected(candidates.size());
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            const auto& c = candidates[i];
+            rejected[i] = existing(c.targets[0]) || existing(c.targets[1]) || c.targets[0] == c.targets[1];
+        }
+
+        // perform swaps
+        std::vector<edge_t> removed;
+        std::vector<edge_t> added;
+        {
+            std::unordered_set<uint64_t> created;
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                const auto& c = candidates[i];
+                if (rejected[i] || created.count(edge_key(c.targets[0])) || created.count(edge_key(c.targets[1]))) {
+                    deferred.push_back(c.edges[0]);
+                    continue;
+                }
+
+                for (unsigned int j = 0; j < 2; ++j) {
+                    _replace(c.edges[j], c.targets[j]);
+                    removed.push_back(c.edges[j]);
+                    added.push_back(c.targets[j]);
+                    created.insert(edge_key(c.targets[j]));
+                }
+            }
+        }
+        std::sort(removed.begin(), removed.end());
+
+        // conflicts of the next round: new edges within a community and deferred edges still present
+        std::vector<edge_t> conflicts = _conflicting(added);
+        for (const auto& e : deferred)
+            if (!std::binary_search(removed.cbegin(), removed.cend(), e))
+                conflicts.push_back(e);
+        std::sort(conflicts.begin(), conflicts.end());
+        conflicts.erase(std::unique(conflicts.begin(), conflicts.end()), conflicts.end());
+        assert(conflicts.size() <= positions.size());
+
+        _swaps.clear();
+        _partners.clear();
+        for (size_t i = 0; i < conflicts.size(); ++i) {
+            _swaps.emplace_back(conflicts[i], positions[i], direction_distr(_gen));
+            _partners.push_back(next_partners[i]);
+        }
+    }
+
+    _merge();
+    _edges.rewind();
+}
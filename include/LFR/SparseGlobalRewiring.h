@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Rewiring of the last few conflicting global edges without a swap engine over all edges
+ */
+#pragma once
+
+#include <LFR/LFR.h>
+#include <LFR/GlobalRewiringSwapGenerator.h>
+#include <Swaps.h>
+#include <EdgeStream.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Sparse engine for the tail of the global rewiring
+ *
+ * Once only few global edges connect nodes sharing a community, a round of
+ * SemiLoadedEdgeSwapTFP is dominated by processing all edges although only the
+ * conflicting edges and their random partners are touched. This class leaves the
+ * edge stream untouched until all conflicts are resolved and keeps the changes
+ * as a delta in IM: every edge removed from the stream is paired with the edge
+ * currently replacing it. Existence queries are answered by the delta, and only
+ * those not decided by it are looked up in the stream. A round thus consists of a
+ * single read-only scan which answers these queries and loads the partners of the
+ * next round. The delta is merged into the stream once at the end.
+ *
+ * The communities of the nodes involved are looked up in a copy of the community
+ * assignment sorted by node, which is built once; nodes already looked up are cached.
+ *
+ * Within a round every edge takes part in at most one swap; swaps overlapping with
+ * an earlier one are deferred to the next round with a new random partner.
+ * If the number of conflicts does not decrease for max_stalled_rounds rounds
+ * (e.g. if almost all nodes share a community), the remaining conflicting edges
+ * are removed from the graph.
+ */
+class SparseGlobalRewiring {
+    //! Approximate overhead of an entry of std::unordered_map/set besides its value
+    //! (next pointer, cached hash and bucket pointer)
+    static constexpr uint_t _hash_entry_overhead = 3 * sizeof(void*);
+
+public:
+    //! Rounds without fewer conflicts than before until the remaining conflicting edges are removed
+    static constexpr unsigned int max_stalled_rounds = 10;
+
+    /**
+     * Approximate IM consumption per conflicting edge, summed over the structures of run():
+     * - the swap and its loaded partner,
+     * - two partner draws for the next round (position, request and loaded edge each),
+     * - the candidate swap (two edges and two targets) with two entries in the set of used edges,
+     * - two existence queries, two removed and two added edges with two entries in the set of
+     *   created edges, two conflicts of the next round and one deferred edge,
+     * - the delta of a performed swap: per edge the replaced edge, its replacement, the index
+     *   entries of both and their sorted copies in _merge(),
+     * - the community cache entries of the four endpoints with two communities each.
+     */
+    static constexpr uint_t bytes_per_swap =
+          sizeof(SemiLoadedSwapDescriptor) + sizeof(edge_t)
+        + 2 * (sizeof(edgeid_t) + sizeof(std::pair<edgeid_t, size_t>) + sizeof(edge_t))
+        + 4 * sizeof(edge_t) + 2 * (sizeof(uint64_t) + _hash_entry_overhead)
+        + 2 * sizeof(edge_t) + 4 * sizeof(edge_t) + 2 * (sizeof(uint64_t) + _hash_entry_overhead) + 3 * sizeof(edge_t)
+        + 2 * (4 * sizeof(edge_t) + 2 * (sizeof(std::pair<const uint64_t, size_t>) + _hash_entry_overhead))
+        + 4 * (sizeof(std::pair<const node_t, std::vector<community_t>>) + _hash_entry_overhead + 2 * sizeof(community_t));
+
+private:
+    using NodeCommunity = GlobalRewiringSwapGenerator::NodeCommunity;
+
+    EdgeStream& _edges;
+    const stxxl::vector<LFR::CommunityAssignment>& _community_assignments;
+    const uint_t _sorter_mem;
+
+    //! Community assignment sorted by node, see _communities_of()
+    stxxl::vector<NodeCommunity> _node_communities;
+    std::unordered_map<node_t, std::vector<community_t>> _community_cache;
+
+    //! Delta to _edges: the stream edge _replaced[i] is replaced by _replacements[i]
+    std::vector<edge_t> _replaced;
+    std::vector<edge_t> _replacements;
+    std::unordered_map<uint64_t, size_t> _replaced_index;    //!< edge -> slot in _replaced
+    std::unordered_map<uint64_t, size_t> _replacement_index; //!< edge -> slot in _replacements
+
+    std::vector<SemiLoadedSwapDescriptor> _swaps;
+    std::vector<edge_t> _partners; //!< stream edge at the position _swaps[i].eid()
+
+    std::mt19937_64 _gen;
+
+    //! Sorts the community assignment by node into _node_communities
+    void _build_node_communities();
+
+    /**
+     * Single scan over the stream: sets exists[i] iff queries[i] (sorted) is part of the
+     * stream and stores the edge at position requests[j].first into loaded[requests[j].second].
+     */
+    void _scan(const std::vector<edge_t>& queries, std::vector<bool>& exists,
+               const std::vector<std::pair<edgeid_t, size_t>>& requests, std::vector<edge_t>& loaded);
+
+    //! Edge currently taking the place of the stream edge e
+    edge_t _current(const edge_t& e) const;
+
+    //! Replaces the current edge e by t in the delta
+    void _replace(const edge_t& e, const edge_t& t);
+
+    //! Removes the current edge e from the graph, i.e. replaces it by an invalid edge in the delta
+    void _remove(const edge_t& e);
+
+    //! Looks up the communities of all given nodes which are not cached yet
+    void _fetch_communities(std::vector<node_t> nodes);
+
+    //! Returns those of @a edges whose endpoints share a community
+    std::vector<edge_t> _conflicting(const std::vector<edge_t>& edges);
+
+    //! Rewrites the stream with the delta applied
+    void _merge();
+
+public:
+    SparseGlobalRewiring(EdgeStream& edges, const stxxl::vector<LFR::CommunityAssignment>& community_assignments, seed_t seed,
+                         uint_t sorter_mem = SORTER_MEM)
+        : _edges(edges), _community_assignments(community_assignments), _sorter_mem(sorter_mem), _gen(seed)
+    {}
+
+    //! Add a conflicting edge (as produced by GlobalRewiringSwapGenerator) with its random partner
+    void push(const SemiLoadedSwapDescriptor& swap) {
+        _swaps.push_back(swap);
+    }
+
+    /**
+     * Resolve all conflicts; the edge stream is rewritten and rewound afterwards.
+     * Conflicting edges remaining after max_stalled_rounds rounds without progress are removed.
+     */
+    void run();
+};
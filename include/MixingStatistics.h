@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Statistics to assess the mixing of randomisation chains from snapshots
+ *
+ * EdgeIndicatorStatistics consumes, edge by edge, the presence of the edge in
+ * T snapshots x_0, ..., x_{T-1} of a randomisation chain. For each thinning
+ * k it reports
+ *  - the mean lag-k autocorrelation of the indicator series over all edges
+ *    whose presence changes at least once, and
+ *  - the fraction of edges whose k-thinned series x_0, x_k, x_2k, ... is
+ *    better explained by a first-order Markov chain than by independent
+ *    draws according to the Bayesian information criterion
+ *    (cf. Ray et al., "A stopping criterion for Markov chains when generating
+ *    independent random graphs", J. Complex Networks, 2015).
+ * Only O(T) words are kept per thinning, so the edges may be streamed.
+ *
+ * DegreeAssortativity computes the degree correlation of the endpoints of the
+ * edges pushed.
+ */
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <defs.h>
+
+class EdgeIndicatorStatistics {
+public:
+    EdgeIndicatorStatistics(unsigned int num_snapshots, unsigned int max_thinning)
+        : _num_snapshots(num_snapshots)
+        , _max_thinning(max_thinning)
+        , _num_edges(0)
+        , _num_varying_edges(0)
+        , _non_independent(max_thinning + 1, 0)
+        , _autocorrelation_sum(max_thinning + 1, 0.0)
+    {
+        assert(num_snapshots > 1);
+        assert(max_thinning > 0);
+    }
+
+    //! Accounts an edge; presence[t] is non-zero iff the edge is contained in snapshot t
+    void push(const std::vector<uint8_t> & presence) {
+        assert(presence.size() == _num_snapshots);
+        ++_num_edges;
+
+        unsigned int ones = 0;
+        for (auto x : presence)
+            ones += !!x;
+
+        // constant series are neither correlated nor better explained by a Markov chain
+        if (!ones || ones == _num_snapshots)
+            return;
+
+        ++_num_varying_edges;
+
+        const double mean = static_cast<double>(ones) / _num_snapshots;
+        const double variance = ones * (1.0 - mean) * (1.0 - mean) + (_num_snapshots - ones) * mean * mean;
+
+        for (unsigned int k = 1; k <= _max_thinning && k < _num_snapshots; ++k) {
+            // autocorrelation at lag k
+            double cov = 0.0;
+            for (unsigned int t = 0; t + k < _num_snapshots; ++t)
+                cov += (!!presence[t] - mean) * (!!presence[t + k] - mean);
+            _autocorrelation_sum[k] += cov / variance;
+
+            // transitions of the thinned series
+            uint64_t transitions[2][2] = {{0, 0}, {0, 0}};
+            for (unsigned int t = 0; t + k < _num_snapshots; t += k)
+                transitions[!!presence[t]][!!presence[t + k]]++;
+
+            if (_prefers_markov(transitions))
+                ++_non_independent[k];
+        }
+    }
+
+    //! Number of edges pushed, i.e. contained in at least one snapshot
+    uint64_t num_edges() const {
+        return _num_edges;
+    }
+
+    //! Number of edges whose presence changes at least once
+    uint64_t num_varying_edges() const {
+        return _num_varying_edges;
+    }
+
+    //! Fraction of all edges whose k-thinned series is classified as dependent
+    double non_independent_fraction(unsigned int k) const {
+        assert(1 <= k && k <= _max_thinning);
+        return _num_edges ? static_cast<double>(_non_independent[k]) / _num_edges : 0.0;
+    }
+
+    //! Mean lag-k autocorrelation over all varying edges
+    double mean_autocorrelation(unsigned int k) const {
+        assert(1 <= k && k <= _max_thinning);
+        return _num_varying_edges ? _autocorrelation_sum[k] / _num_varying_edges : 0.0;
+    }
+
+protected:
+    const unsigned int _num_snapshots;
+    const unsigned int _max_thinning;
+
+    uint64_t _num_edges;
+    uint64_t _num_varying_edges;
+    std::vector<uint64_t> _non_independent;
+    std::vector<double> _autocorrelation_sum;
+
+    static double _xlogy(double x, double y) {
+        return x > 0 ? x * std::log(y) : 0.0;
+    }
+
+    //! Compares the BIC of a first-order Markov chain (2 parameters) to an independent model (1 parameter)
+    static bool _prefers_markov(const uint64_t n[2][2]) {
+        const double total = n[0][0] + n[0][1] + n[1][0] + n[1][1];
+        if (total < 2)
+            return false;
+
+        double log_markov = 0.0;
+        for (unsigned int i = 0; i < 2; ++i) {
+            const double row = n[i][0] + n[i][1];
+            for (unsigned int j = 0; j < 2; ++j)
+                log_markov += _xlogy(n[i][j], n[i][j] / row);
+        }
+
+        double log_independent = 0.0;
+        for (unsigned int j = 0; j < 2; ++j) {
+            const double col = n[0][j] + n[1][j];
+            log_independent += _xlogy(col, col / total);
+        }
+
+        const double bic_markov = -2.0 * log_markov + 2.0 * std::log(total);
+        const double bic_independent = -2.0 * log_independent + std::log(total);
+
+        return bic_markov < bic_independent;
+    }
+};
+
+class DegreeAssortativity {
+public:
+    DegreeAssortativity()
+        : _num_edges(0), _sum_product(0), _sum_mean(0), _sum_squares(0)
+    {}
+
+    void push(degree_t du, degree_t dv) {
+        ++_num_edges;
+        _sum_product += static_cast<double>(du) * dv;
+        _sum_mean += 0.5 * (static_cast<double>(du) + dv);
+        _sum_squares += 0.5 * (static_cast<double>(du) * du + static_cast<double>(dv) * dv);
+    }
+
+    //! Pearson correlation of the degrees at both ends of an edge (Newman 2002); 0 if undefined
+    double value() const {
+        if (!_num_edges)
+            return 0.0;
+
+        const double mean = _sum_mean / _num_edges;
+        const double denominator = _sum_squares / _num_edges - mean * mean;
+        if (denominator <= 0)
+            return 0.0;
+
+        return (_sum_product / _num_edges - mean * mean) / denominator;
+    }
+
+protected:
+    uint64_t _num_edges;
+    double _sum_product;
+    double _sum_mean;
+    double _sum_squares;
+};
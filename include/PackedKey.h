@@ -0,0 +1,234 @@
+/**
+ * @file
+ * @brief Order-preserving integer keys for message types
+ *
+ * PackedKey<T>::pack(msg) maps a message onto an unsigned integer of 64 or
+ * 128 bits, such that a < b iff pack(a) < pack(b). Hence messages can be radix
+ * sorted by their packed key (see intsort::sort_packed), which is considerably
+ * faster than a comparison sort with the lexicographic std::tie comparator.
+ *
+ * PackedKeyComparator compares packed keys instead of tuples. As both keys are
+ * packed on every call, it only pays off if the leading members are mostly
+ * equal (see microbench/BenchComparators.cpp).
+ *
+ * By default the key is derived from the members returned by to_tuple()
+ * (i.e. the order of DECL_LEX_COMPARE). Types with a hand-written operator<
+ * declare their order with DECL_PACKED_KEY, e.g.
+ *
+ *   DECL_PACKED_KEY(edge, packed_key::descending(flagged_swap_id));
+ *
+ * Supported members are integers, bools, std::pair (and thus edge_t) and
+ * nested types with to_tuple(). The number of bits of all members has to be
+ * at most 128, which is checked at compile time.
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "GenericComparator.h"
+#include "TupleHelper.h"
+
+namespace packed_key {
+
+using uint128_t = unsigned __int128;
+
+//! Marks a member that is compared in descending order
+template <typename U>
+struct Descending {
+    U value;
+};
+
+template <typename U>
+Descending<U> descending(const U& value) {
+    return {value};
+}
+
+namespace internal {
+
+//! Appends the lowest bits of value to key; a shift by the full width is undefined, hence the case distinction
+template <unsigned int bits, typename Key>
+Key append(Key key, Key value) {
+    return bits >= 8 * sizeof(Key) ? value : (key << (bits % (8 * sizeof(Key)))) | value;
+}
+
+// detect std::pair and types derived from it (e.g. edge_t)
+template <typename A, typename B>
+std::true_type is_pair_test(const std::pair<A, B>*);
+std::false_type is_pair_test(...);
+
+template <typename U>
+using is_pair = decltype(is_pair_test(std::declval<const U*>()));
+
+template <typename U, typename = void>
+struct has_to_tuple : std::false_type {};
+
+template <typename U>
+struct has_to_tuple<U, decltype(void(std::declval<const U&>().to_tuple()))> : std::true_type {};
+
+template <typename U, typename = void>
+struct has_packed_key_tuple : std::false_type {};
+
+template <typename U>
+struct has_packed_key_tuple<U, decltype(void(std::declval<const U&>().packed_key_tuple()))> : std::true_type {};
+
+template <typename U>
+struct is_struct : std::integral_constant<bool, has_to_tuple<U>::value || has_packed_key_tuple<U>::value> {};
+
+template <typename U, typename Enable = void>
+struct Component;
+
+template <typename... Ts>
+struct TupleComponent;
+
+template <>
+struct TupleComponent<> {
+    static constexpr unsigned int bits = 0;
+
+    template <typename Key, typename Tuple>
+    static Key pack(const Tuple&, Key key) {return key;}
+};
+
+//! Appends the members of a tuple to key from left to right
+template <typename T, typename... Ts>
+struct TupleComponent<T, Ts...> {
+    using head = Component<typename std::decay<T>::type>;
+    using tail = TupleComponent<Ts...>;
+
+    static constexpr unsigned int bits = head::bits + tail::bits;
+
+    template <typename Key, typename... Args>
+    static Key pack(const std::tuple<Args...>& t, Key key) {
+        key = head::template pack<Key>(std::get<sizeof...(Args) - sizeof...(Ts) - 1>(t), key);
+        return tail::template pack<Key>(t, key);
+    }
+};
+
+template <typename Tuple>
+struct TupleOf;
+
+template <typename... Ts>
+struct TupleOf<std::tuple<Ts...>> {
+    using type = TupleComponent<Ts...>;
+};
+
+template <>
+struct Component<bool> {
+    static constexpr unsigned int bits = 1;
+
+    template <typename Key>
+    static Key pack(const bool& x, Key key) {return append<bits>(key, Key(x));}
+};
+
+//! Signed integers are shifted by flipping the sign bit
+template <typename U>
+struct Component<U, typename std::enable_if<std::is_integral<U>::value && !std::is_same<U, bool>::value>::type> {
+    static constexpr unsigned int bits = 8 * sizeof(U);
+
+    template <typename Key>
+    static Key pack(const U& x, Key key) {
+        using UU = typename std::make_unsigned<U>::type;
+        UU ux = static_cast<UU>(x);
+        if (std::is_signed<U>::value)
+            ux ^= UU(1) << (bits - 1);
+        return append<bits>(key, Key(ux));
+    }
+};
+
+//! The complement within the lowest bits reverses the order
+template <typename U>
+struct Component<Descending<U>> {
+    static constexpr unsigned int bits = Component<U>::bits;
+
+    template <typename Key>
+    static Key pack(const Descending<U>& x, Key key) {
+        const Key mask = (Key(1) << (bits - 1) << 1) - 1;
+        return append<bits>(key, ~Component<U>::template pack<Key>(x.value, Key(0)) & mask);
+    }
+};
+
+template <typename U>
+struct Component<U, typename std::enable_if<is_pair<U>::value && !is_struct<U>::value>::type> {
+    using first_type = typename std::decay<decltype(std::declval<U>().first)>::type;
+    using second_type = typename std::decay<decltype(std::declval<U>().second)>::type;
+
+    static constexpr unsigned int bits = Component<first_type>::bits + Component<second_type>::bits;
+
+    template <typename Key>
+    static Key pack(const U& x, Key key) {
+        key = Component<first_type>::template pack<Key>(x.first, key);
+        return Component<second_type>::template pack<Key>(x.second, key);
+    }
+};
+
+//! Structs contribute the members of packed_key_tuple() or else to_tuple()
+template <typename U>
+struct Component<U, typename std::enable_if<is_struct<U>::value>::type> {
+    template <typename V>
+    static auto tuple_of(const V& x, std::true_type) {return x.packed_key_tuple();}
+    template <typename V>
+    static auto tuple_of(const V& x, std::false_type) {return x.to_tuple();}
+
+    static auto tuple_of(const U& x) {return tuple_of(x, has_packed_key_tuple<U>());}
+
+    using tuple_type = typename std::decay<decltype(tuple_of(std::declval<const U&>()))>::type;
+    using members = typename TupleOf<tuple_type>::type;
+
+    static constexpr unsigned int bits = members::bits;
+
+    template <typename Key>
+    static Key pack(const U& x, Key key) {
+        return members::template pack<Key>(tuple_of(x), key);
+    }
+};
+
+} // namespace: internal
+} // namespace: packed_key
+
+/**
+ * Maps T onto an order-preserving unsigned key of the smallest fitting type
+ * (uint64_t or 128 bit); only the lowest PackedKey<T>::bits bits are used.
+ */
+template <typename T>
+struct PackedKey {
+    using component = packed_key::internal::Component<T>;
+
+    static constexpr unsigned int bits = component::bits;
+    static_assert(bits <= 128, "Packed key exceeds 128 bits");
+
+    using type = typename std::conditional<(bits <= 64), uint64_t, packed_key::uint128_t>::type;
+
+    static type pack(const T& x) {
+        return component::template pack<type>(x, type(0));
+    }
+
+    static type max_key() {
+        return (type(1) << (bits - 1) << 1) - 1;
+    }
+};
+
+/**
+ * Drop-in replacement for GenericComparatorStruct<T> comparing packed keys.
+ * The sentinels are the same as GenericComparatorStruct's.
+ */
+template <typename T>
+struct PackedKeyComparator {
+    struct Ascending : public GenericComparatorStruct<T>::Ascending {
+        bool operator()(const T &a, const T &b) const {
+            return PackedKey<T>::pack(a) < PackedKey<T>::pack(b);
+        }
+    };
+
+    struct Descending : public GenericComparatorStruct<T>::Descending {
+        bool operator()(const T &a, const T &b) const {
+            return PackedKey<T>::pack(b) < PackedKey<T>::pack(a);
+        }
+    };
+};
+
+//! Declares the order of PackedKey for types with a hand-written operator<
+#define DECL_PACKED_KEY(...) \
+   auto packed_key_tuple() const -> decltype(std::make_tuple(__VA_ARGS__)) {return std::make_tuple(__VA_ARGS__);}
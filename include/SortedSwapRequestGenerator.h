@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Random swaps emitted as edge requests sorted by edge id
+ */
+
+#pragma once
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include "Swaps.h"
+#include <Utils/MonotonicUniformRandomStream.h>
+#include <Utils/RandomBoolStream.h>
+
+/**
+ * Generates the same kind of random swaps as SwapGenerator, but instead of
+ * emitting swap by swap, it emits the edge requests of all swaps ordered by
+ * (edge_id, swap_id) where swap_id = 2*swap + i addresses the i-th edge of a
+ * swap. This is exactly the order EdgeSwapTFP obtains by sorting its
+ * EdgeSwapMsgs, so the sorter can be skipped.
+ *
+ * The 2k edge ids of k swaps are i.i.d. uniform, hence we draw them in
+ * increasing order (see MonotonicUniformRandomStream) and attach to the j-th
+ * smallest id the request slot perm(j) of a pseudo-random permutation of
+ * [0, 2k). The permutation is a Feistel network with cycle walking, so it
+ * needs constant memory.
+ *
+ * SwapGenerator rejects swaps of an edge with itself. Here, if both requests
+ * of a swap hit the same edge, the second one is moved to the next edge (or
+ * the previous one for the last edge) instead. This affects about k/m of the
+ * k swaps on m edges and hence skews the distribution only by O(1/m).
+ *
+ * The swap directions are not part of the request stream; they are obtained
+ * from directions() in swap order.
+ */
+class SortedSwapRequestGenerator {
+public:
+    struct SwapRequest {
+        edgeid_t edge_id;
+        swapid_t swap_id;
+    };
+
+    using value_type = SwapRequest;
+
+protected:
+    const edgeid_t _number_of_edges;
+    const swapid_t _number_of_swaps;
+    const seed_t _direction_seed;
+
+    // sorted edge ids
+    MonotonicUniformRandomStream<true> _edge_ids;
+    uint64_t _next_rank;
+
+    // Feistel network over [0, 2^(2*_half_bits)) restricted to [0, 2k)
+    static constexpr unsigned int _rounds = 4;
+    unsigned int _half_bits;
+    uint64_t _half_mask;
+    uint64_t _keys[_rounds];
+
+    // requests moved to the edge id following the current group
+    std::vector<swapid_t> _carry;
+
+    // the latest group is held back, as collisions on the last edge are moved to its predecessor
+    bool _has_pending;
+    edgeid_t _pending_edge;
+    std::vector<swapid_t> _pending;
+
+    std::vector<value_type> _ready;
+    size_t _ready_pos;
+
+    std::vector<swapid_t> _group;
+
+    static uint64_t _mix(uint64_t x) {
+        // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9llu;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebllu;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t _feistel(uint64_t x) const {
+        uint64_t left = x >> _half_bits;
+        uint64_t right = x & _half_mask;
+        for (unsigned int r = 0; r < _rounds; ++r) {
+            const uint64_t tmp = right;
+            right = left ^ (_mix(right ^ _keys[r]) & _half_mask);
+            left = tmp;
+        }
+        return (left << _half_bits) | right;
+    }
+
+    swapid_t _permute(uint64_t x) const {
+        const uint64_t n = 2 * static_cast<uint64_t>(_number_of_swaps);
+        do {
+            x = _feistel(x);
+        } while (x >= n);
+        return static_cast<swapid_t>(x);
+    }
+
+    edgeid_t _current_edge_id() const {
+        return std::min<edgeid_t>(_number_of_edges - 1, static_cast<edgeid_t>(*_edge_ids * _number_of_edges));
+    }
+
+    void _flush_pending() {
+        if (!_has_pending)
+            return;
+
+        for (auto slot : _pending)
+            _ready.push_back({_pending_edge, slot});
+
+        _pending.clear();
+        _has_pending = false;
+    }
+
+    //! Collects the requests of the next edge; returns false if all are emitted
+    bool _next_group() {
+        _group.clear();
+        edgeid_t edge;
+
+        if (!_carry.empty()) {
+            edge = _pending_edge + 1;
+            _group.swap(_carry);
+        } else if (!_edge_ids.empty()) {
+            edge = _current_edge_id();
+        } else {
+            return false;
+        }
+
+        for (; !_edge_ids.empty() && _current_edge_id() == edge; ++_edge_ids)
+            _group.push_back(_permute(_next_rank++));
+
+        std::sort(_group.begin(), _group.end());
+
+        // both requests of a swap hit this edge: move the second one
+        std::vector<swapid_t> moved;
+        for (size_t i = 0; i + 1 < _group.size(); ++i) {
+            if (!(_group[i] & 1) && _group[i + 1] == _group[i] + 1) {
+                moved.push_back(_group[i + 1]);
+                _group.erase(_group.begin() + i + 1);
+            }
+        }
+
+        if (!moved.empty()) {
+            if (edge + 1 < _number_of_edges) {
+                _carry.swap(moved);
+            } else if (_has_pending && _pending_edge + 1 == edge) {
+                _pending.insert(_pending.end(), moved.begin(), moved.end());
+                std::sort(_pending.begin(), _pending.end());
+            } else {
+                _flush_pending();
+                _pending.swap(moved);
+                _pending_edge = edge - 1;
+                _has_pending = true;
+            }
+        }
+
+        _flush_pending();
+        _pending.swap(_group);
+        _pending_edge = edge;
+        _has_pending = true;
+
+        return true;
+    }
+
+    void _fill() {
+        _ready.clear();
+        _ready_pos = 0;
+
+        // the pending group is complete once the next one has been processed
+        while (_ready.empty()) {
+            if (!_next_group()) {
+                _flush_pending();
+                return;
+            }
+        }
+    }
+
+public:
+    SortedSwapRequestGenerator(swapid_t number_of_swaps, edgeid_t edges_in_graph, seed_t seed)
+        : _number_of_edges(edges_in_graph)
+        , _number_of_swaps(number_of_swaps)
+        , _direction_seed(static_cast<seed_t>(_mix(seed + 1)))
+        , _edge_ids(2 * static_cast<uint_t>(number_of_swaps), static_cast<seed_t>(_mix(seed)))
+        , _next_rank(0)
+        , _has_pending(false)
+        , _pending_edge(0)
+        , _ready_pos(0)
+    {
+        assert(_number_of_edges > 1);
+        assert(_number_of_swaps > 0);
+
+        unsigned int bits = 2;
+        while ((uint64_t(1) << bits) < 2 * static_cast<uint64_t>(_number_of_swaps))
+            ++bits;
+
+        _half_bits = (bits + 1) / 2;
+        _half_mask = (uint64_t(1) << _half_bits) - 1;
+
+        STDRandomEngine key_gen(seed);
+        for (unsigned int r = 0; r < _rounds; ++r)
+            _keys[r] = key_gen();
+
+        _fill();
+    }
+
+    //! Number of swaps, i.e. half the number of requests emitted
+    swapid_t size() const {
+        return _number_of_swaps;
+    }
+
+    //! Random swap directions in swap order
+    RandomBoolStream directions() const {
+        return RandomBoolStream(_direction_seed);
+    }
+
+//! @name STXXL Streaming Interface
+//! @{
+    bool empty() const {return _ready_pos >= _ready.size();}
+    const value_type & operator*() const {return _ready[_ready_pos];}
+    const value_type * operator->() const {return &_ready[_ready_pos];}
+
+    SortedSwapRequestGenerator& operator++() {
+        if (++_ready_pos >= _ready.size())
+            _fill();
+        return *this;
+    }
+//! @}
+};
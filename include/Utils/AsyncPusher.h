@@ -1,36 +1,34 @@
 #pragma once
 
-#include<vector>
-#include<list>
-#include<thread>
-#include<future>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <stxxl/bits/common/utils.h>
+
+#include <Utils/PipelineStage.h>
 
 #define ASYNC_PUSHER_STATS
 
+/**
+ * Collects pushed items in the batches of an SPSCBatchQueue and forwards them
+ * to target.push() in a persistent worker thread. If the worker falls behind,
+ * push() blocks once all number_of_buffers batches are filled.
+ */
 template <class TargetT, typename T>
 class AsyncPusher {
-    using BufferType = std::vector<T>;
-    using BufIt = typename BufferType::iterator;
+    using Queue = SPSCBatchQueue<T>;
 
     // Target and Parameters
     TargetT & _target;
-    const size_t _buffer_size;
-    const unsigned int _number_of_buffers;
-
-    // Buffer stores
-    std::list<std::unique_ptr<BufferType>> _target_buffers;
-    std::list<std::unique_ptr<BufferType>> _empty_buffers;
+    Queue _queue;
 
     // Push interface
-    BufIt _push_it;
-    BufIt _push_end;
-
-    // Multi-Threading
-    std::future<void> _pusher_done;
-    std::mutex _list_mutex;
-    std::condition_variable _target_cv;
-    std::condition_variable _empty_cv;
-    std::atomic_bool _done_pushing;
+    typename Queue::Batch* _batch;
+    T* _push_it;
+    T* _push_end;
+    bool _done_pushing;
 
     // Statistics
 #ifdef ASYNC_PUSHER_STATS
@@ -44,112 +42,83 @@ class AsyncPusher {
     uint64_t _stat_items_pushed_to_target;
 #endif
 
+    // the worker accesses all of the above; hence it is destroyed first
+    PipelineWorker _worker;
+
     void _fetch_push_buffer(bool push_current) {
+        if (push_current) {
+            _batch->size = _push_it - _batch->begin();
+            _queue.end_produce();
+        }
+
         #ifdef ASYNC_PUSHER_STATS
             auto begin = std::chrono::high_resolution_clock::now();
         #endif
-        { // CRITICAL_SECTION
-            std::unique_lock <std::mutex> lck(_list_mutex);
 
-            if (push_current) {
-                // move the most recently filled buffer into the target list
-                _target_buffers.emplace_back(nullptr);
-                std::swap(_target_buffers.back(), _empty_buffers.front());
-                _empty_buffers.pop_front();
+        _batch = _queue.begin_produce();
+        assert(_batch);
 
-                // wake pusher thread
-                _target_cv.notify_one();
-            }
-
-            // wait for a buffer
-            _empty_cv.wait(lck, [&]() { return !_empty_buffers.empty(); });
-        }
         #ifdef ASYNC_PUSHER_STATS
             auto end = std::chrono::high_resolution_clock::now();
             _stat_wait_for_empty += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
-            _stat_number_pushes+= push_current;
+            _stat_number_pushes += push_current;
         #endif
 
-
-        // fetch the first one
-        BufferType & buf = *_empty_buffers.front();
-        _push_it = buf.begin();
-        _push_end = buf.end();
+        _push_it = _batch->begin();
+        _push_end = _push_it + _queue.capacity();
     }
 
     void _pusher_main() {
-        bool first_iteration = true;
-        while(1) {
+        while (true) {
             #ifdef ASYNC_PUSHER_STATS
                 auto begin = std::chrono::high_resolution_clock::now();
             #endif
-            {
-                std::unique_lock<std::mutex> lck(_list_mutex);
-
-                if (!first_iteration) {
-                    // we need to return the buffer
-                    _empty_buffers.emplace_back(nullptr);
-                    std::swap(_target_buffers.front(), _empty_buffers.back());
-                    _target_buffers.pop_front();
 
-                    // wake a lazy producer
-                    _empty_cv.notify_one();
-                }
+            const auto* batch = _queue.begin_consume();
 
-                // wait for buffer to push
-                _target_cv.wait(lck, [&]() { return !_target_buffers.empty() || _done_pushing; });
-            }
             #ifdef ASYNC_PUSHER_STATS
                 auto end = std::chrono::high_resolution_clock::now();
                 _stat_wait_for_filled += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
             #endif
 
             // stop here
-            if (_target_buffers.empty()) {
-                assert(_done_pushing);
-                assert(_stat_items_received == _stat_items_pushed_to_target);
-
-                std::cout << "Bye" << std::endl;
+            if (!batch)
                 return;
-            }
 
             // push into target
-            for(const auto & e : *_target_buffers.front()) {
+            for(const auto & e : *batch) {
                 _target.push(e);
                 #ifndef NDEBUG
                     _stat_items_pushed_to_target++;
                 #endif
             }
 
-
-            first_iteration = false;
+            _queue.end_consume();
         }
     }
 
+    void _start_pusher() {
+        _worker.run([this] {_pusher_main();});
+    }
+
 public:
     AsyncPusher(TargetT& target, size_t elements_in_buffer = 2llu << 20, unsigned int number_of_buffers = 3)
         : _target(target)
-        , _buffer_size(elements_in_buffer)
-        , _number_of_buffers(number_of_buffers)
+        , _queue(elements_in_buffer, number_of_buffers)
+        , _batch(nullptr)
         , _done_pushing(false)
+#ifdef ASYNC_PUSHER_STATS
         , _stat_wait_for_empty(0)
         , _stat_wait_for_filled(0)
         , _stat_number_pushes(0)
+#endif
 #ifndef NDEBUG
         , _stat_items_received(0)
         , _stat_items_pushed_to_target(0)
 #endif
     {
-        assert(_buffer_size > 0);
-        assert(_number_of_buffers > 1);
-
-        for(; number_of_buffers; number_of_buffers--) {
-            _empty_buffers.emplace_back( new BufferType(elements_in_buffer) );
-        }
-
         _fetch_push_buffer(false);
-
-        _pusher_done = std::async(std::launch::async, &AsyncPusher::_pusher_main, this);
+        _start_pusher();
     }
 
     ~AsyncPusher() {
@@ -175,21 +144,15 @@ public:
 
     void finish(bool wait = true) {
         // push last buffer if necessary
-        {
-            assert(!_empty_buffers.empty());
-            auto & buf = *_empty_buffers.front();
-
-            ptrdiff_t elements_pushed = _push_it - buf.begin();
-            assert(elements_pushed < buf.size());
+        _batch->size = _push_it - _batch->begin();
+        if (_batch->size)
+            _queue.end_produce();
 
-            if (elements_pushed) {
-                buf.resize(elements_pushed);
-                _fetch_push_buffer(true);
-            }
-        }
+        _batch = nullptr;
+        _push_it = _push_end = nullptr;
 
+        _queue.close();
         _done_pushing = true;
-        _target_cv.notify_one();
 
         if (wait)
             waitForPusher();
@@ -197,23 +160,20 @@ public:
 
     void waitForPusher() {
         assert(_done_pushing);
-        if (_pusher_done.valid())
-            _pusher_done.get();
+        _worker.wait();
 
         assert(_stat_items_received == _stat_items_pushed_to_target);
     }
 
+    //! Allows to push again after finish()
     void restart() {
         waitForPusher();
 
-        assert(_target_buffers.empty());
-        assert(_empty_buffers.size() == _number_of_buffers);
+        _queue.reset();
+        _done_pushing = false;
 
-        for(auto & ptr : _empty_buffers) {
-            ptr->resize(_buffer_size);
-        }
-
-        _pusher_done = std::async(std::launch::async, &AsyncPusher::_pusher_main, this);
+        _fetch_push_buffer(false);
+        _start_pusher();
     }
 
     void report_stats(const std::string & name) {
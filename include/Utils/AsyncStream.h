@@ -2,134 +2,150 @@
 
 #include <stxxl/bits/common/utils.h>
 
-#include <thread>
-#include <future>
+#include <algorithm>
 #include <chrono>
-#include <vector>
 #include <iostream>
+#include <string>
+
+#include <Utils/PipelineStage.h>
 
 #define ASYNC_STREAM_STATS
 
+/**
+ * Reads StreamIn in a persistent worker thread and provides the same stream
+ * interface to the consumer. The worker fills the batches of an SPSCBatchQueue
+ * ahead of the consumer and blocks if the consumer falls behind. The first
+ * batch is small and the batch size doubles up to the capacity, so the
+ * consumer can start early.
+ *
+ * Any producer/consumer pair can be decoupled this way, e.g.
+ *   AsyncStream<SwapGenerator> swaps(swap_gen);
+ *   StreamPusher<decltype(swaps), EdgeSwapTFP::EdgeSwapTFP>(swaps, swap_algo);
+ */
 template <typename StreamIn, typename T = typename StreamIn::value_type>
 class AsyncStream {
 public:
     using value_type = T;
 
 protected:
-    using BufferType = std::vector<T>;
-    using Iterator = typename BufferType::const_iterator;
+    using Queue = SPSCBatchQueue<T>;
 
-    constexpr static double initial_batch_time_factor = 0.2;
-    constexpr static double dampening_factor = 8.0;
+    constexpr static unsigned int number_of_batches = 4;
+    constexpr static size_t initial_batch_size = 1024;
 
     // producer port
-    StreamIn &  _producing_stream;
-    BufferType _produce_buffer;
+    StreamIn & _producing_stream;
 
-    const double _target_batch_time;
-    double _batch_time;
-    double _last_rate;
-    std::future<std::pair<Iterator, double>> _producer_future;
+    Queue _queue;
 
     // consume port
-    BufferType _consume_buffer;
-    Iterator _consume_iter;
-    Iterator _consume_end;
-    bool _consume_empty;
+    typename Queue::Batch* _batch;
+    const T* _consume_iter;
+    const T* _consume_end;
 
 #ifdef ASYNC_STREAM_STATS
-    uint64_t _stat_wait_for_future;
+    uint64_t _stat_wait_for_batch;
     uint64_t _stat_received_buffers;
     uint64_t _stat_received_elements;
 #endif
 
+    // the worker accesses all of the above; hence it is destroyed first
+    PipelineWorker _worker;
 
-    // only directly called in the constructor; otherwise invoked in _receive_buffer
-    void _start_producing() {
-       if (UNLIKELY(_producing_stream.empty())) {
-          _consume_empty = true;
-          return;
-       }
+    void _produce() {
+       size_t batch_size = std::min(initial_batch_size, _queue.capacity());
 
-       size_t elements = std::min<size_t>(1 + _last_rate * _batch_time, _produce_buffer.size());
-       _batch_time = _target_batch_time;
-       //std::cout << "Request " << elements << " elements to be produced async" << std::endl;
+       while (true) {
+          auto* batch = _queue.begin_produce();
+          if (!batch) // consumer stopped
+             return;
 
-       _producer_future =  std::async(std::launch::async, [] (StreamIn& stream, BufferType & buf, size_t num) {
-           auto begin = std::chrono::high_resolution_clock::now();
+          T* it = batch->begin();
+          size_t n = 0;
+          for (; n < batch_size && !_producing_stream.empty(); ++n, ++_producing_stream)
+             it[n] = *_producing_stream;
 
-           auto it = buf.begin();
-           for(auto counter=num; counter && !stream.empty(); --counter, ++stream, ++it)
-              *it = *stream;
+          batch->size = n;
+          if (n)
+             _queue.end_produce();
 
-           auto end = std::chrono::high_resolution_clock::now();
+          if (_producing_stream.empty()) {
+             _queue.close();
+             return;
+          }
 
+          batch_size = std::min(2 * batch_size, _queue.capacity());
+       }
+    }
 
-           return std::make_pair(Iterator(it), double(num) * 1.0e9 / std::chrono::duration_cast<std::chrono::nanoseconds>(end-begin).count());
-       }, std::ref(_producing_stream), std::ref(_produce_buffer), elements);
+    void _start_producing() {
+       _worker.run([this] {_produce();});
     }
 
     void _receive_buffer() {
-       if (UNLIKELY(_consume_empty))
-          return;
+       if (_batch)
+          _queue.end_consume();
 
-       double rate;
        {
          #ifdef ASYNC_STREAM_STATS
             auto begin = std::chrono::high_resolution_clock::now();
          #endif
 
-          // wait for produer
-          std::tie(_consume_end, rate) = _producer_future.get();
-
-          #ifdef ASYNC_STREAM_STATS
-             auto end = std::chrono::high_resolution_clock::now();
-             _stat_wait_for_future += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
+          _batch = _queue.begin_consume();
 
-            _stat_received_buffers++;
-            _stat_received_elements += (_consume_end - _produce_buffer.begin());
-          #endif
+         #ifdef ASYNC_STREAM_STATS
+            auto end = std::chrono::high_resolution_clock::now();
+            _stat_wait_for_batch += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
+         #endif
        }
 
+       if (UNLIKELY(!_batch)) {
+          _consume_iter = _consume_end = nullptr;
+          return;
+       }
 
+       _consume_iter = _batch->begin();
+       _consume_end = _batch->end();
 
-       _last_rate = ((dampening_factor-1) * _last_rate + rate) / dampening_factor;
-       //std::cout << "Got buffer produced at rate " << _last_rate << std::endl;
-
-       // swap buffers and begin reading the consume side
-       std::swap(_consume_buffer, _produce_buffer);
-       _consume_iter = _consume_buffer.cbegin();
+      #ifdef ASYNC_STREAM_STATS
+         _stat_received_buffers++;
+         _stat_received_elements += _batch->size;
+      #endif
+    }
 
-       // request the generation of the next buffer
-       _start_producing();
+    void _stop_producing() {
+       _queue.cancel();
+       _worker.wait();
+       _queue.reset();
+       _batch = nullptr;
+       _consume_iter = _consume_end = nullptr;
     }
 
 public:
-    //! The block size of every async computation is defined by batch_time in seconds.
-    //! We try to slowly approach it, but a resonably good estimation should be provided.
-    //! The memory for the two blocks is allocated in the constructor and is by default 
-    //! twice the size requiered to fill a buffer at estimated_rate.
+    //! The worker keeps up to twice max_buffer_size elements in flight. By
+    //! default, max_buffer_size is chosen such that a buffer is produced in
+    //! batch_time seconds at estimated_rate elements per second.
     AsyncStream(StreamIn& stream, bool auto_acquire = true, double estimated_rate = 1.0e7, double batch_time = 0.5, size_t max_buffer_size = 0)
             : _producing_stream(stream)
-            , _target_batch_time(batch_time)
-            , _batch_time(initial_batch_time_factor * batch_time)
-            , _last_rate(estimated_rate)
-            , _consume_empty(false)
+            , _queue(std::max<size_t>(1, (max_buffer_size ? max_buffer_size : static_cast<size_t>(2 * estimated_rate * batch_time))
+                                         * 2 / number_of_batches), number_of_batches)
+            , _batch(nullptr)
+            , _consume_iter(nullptr)
+            , _consume_end(nullptr)
+#ifdef ASYNC_STREAM_STATS
+            , _stat_wait_for_batch(0)
+            , _stat_received_buffers(0)
+            , _stat_received_elements(0)
+#endif
     {
-       if (!max_buffer_size)
-          max_buffer_size = 2 *  estimated_rate * batch_time;
-
-       _consume_buffer.resize(max_buffer_size);
-       _produce_buffer.resize(max_buffer_size);
-
        _start_producing();
        if (auto_acquire)
           acquire();
     }
 
     ~AsyncStream() {
-       if (_producer_future.valid())
-          _producer_future.wait();
+       _queue.cancel();
+       _worker.wait();
     }
 
     //! Needs to be called before the first access to the streaming interface
@@ -142,13 +158,8 @@ public:
     //! Otherwise it is stopped somewhere and restarted.
     //! @warning You have to call acquire again
     void restart(bool auto_acquire) {
-       if (_producer_future.valid())
-          _producer_future.wait();
-
-       _batch_time = _target_batch_time * initial_batch_time_factor;
+       _stop_producing();
        _start_producing();
-       _consume_empty = false;
-
 
        if (auto_acquire)
           acquire();
@@ -173,11 +184,11 @@ public:
     const value_type * operator->() const {
         assert(!empty());
 
-        return &*_consume_iter;
+        return _consume_iter;
     }
 
     bool empty() const {
-       return _consume_empty && _consume_iter == _consume_end;
+       return _consume_iter == _consume_end;
     }
 
     void report_stats(const std::string & name) {
@@ -190,11 +201,15 @@ public:
     void report_stats() {
 #ifdef ASYNC_STREAM_STATS
         std::cout << "AsyncStream received " << _stat_received_elements << " elements in "
-                  << _stat_received_buffers << " buffers. Waited for future " << _stat_wait_for_future << "ms. "
-                     "Last rate: " << _last_rate
+                  << _stat_received_buffers << " buffers. Waited for batches " << _stat_wait_for_batch << "ms. "
+                     "Blocked " << _queue.number_of_blocks() << " times."
         << std::endl;
 #endif
     }
 };
 
-      
+template <typename StreamIn, typename T>
+constexpr unsigned int AsyncStream<StreamIn, T>::number_of_batches;
+
+template <typename StreamIn, typename T>
+constexpr size_t AsyncStream<StreamIn, T>::initial_batch_size;
@@ -0,0 +1,175 @@
+#include "DirectFileReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr size_t DirectFileReader::alignment;
+
+DirectFileReader::DirectFileReader(const std::string& filename, size_t block_size, unsigned int queue_depth)
+    : _filename(filename)
+    , _fd(-1)
+    , _direct(true)
+    , _file_size(0)
+    , _block_size(std::max<size_t>(alignment, (block_size + alignment - 1) / alignment * alignment))
+    , _slots(std::max(1u, queue_depth))
+    , _next_block(0)
+    , _holding(false)
+    , _stop(false)
+{
+    _fd = open(filename.c_str(), O_RDONLY | O_DIRECT);
+    if (_fd < 0 && errno == EINVAL) {
+        _direct = false;
+        _fd = open(filename.c_str(), O_RDONLY);
+    }
+
+    if (_fd < 0)
+        throw std::runtime_error("[DirectFileReader] Cannot open " + filename + ": " + std::strerror(errno));
+
+    struct stat st;
+    if (fstat(_fd, &st)) {
+        close(_fd);
+        throw std::runtime_error("[DirectFileReader] Cannot stat " + filename + ": " + std::strerror(errno));
+    }
+
+    _file_size = st.st_size;
+    _number_of_blocks = (_file_size + _block_size - 1) / _block_size;
+
+    for (auto& slot : _slots) {
+        void* ptr;
+        if (posix_memalign(&ptr, alignment, _block_size)) {
+            close(_fd);
+            throw std::bad_alloc();
+        }
+
+        slot.buffer.reset(static_cast<char*>(ptr));
+        slot.size = 0;
+        slot.filled = false;
+    }
+
+    for (unsigned int i = 0; i < _slots.size(); ++i)
+        _threads.emplace_back(&DirectFileReader::_io_main, this, i);
+}
+
+DirectFileReader::~DirectFileReader() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+
+    for (auto& t : _threads)
+        t.join();
+
+    close(_fd);
+    for (const int fd : _retired_fds)
+        close(fd);
+}
+
+void DirectFileReader::_io_main(unsigned int slot_id) {
+    Slot& slot = _slots[slot_id];
+
+    for (uint64_t block = slot_id; block < _number_of_blocks; block += _slots.size()) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [&] {return !slot.filled || _stop;});
+            if (_stop)
+                return;
+        }
+
+        // O_DIRECT requires aligned lengths, so the last block is requested in full as well
+        const uint64_t offset = block * _block_size;
+        const size_t expected = std::min<uint64_t>(_block_size, _file_size - offset);
+
+        size_t size = 0;
+        std::string error;
+        while (size < expected) {
+            const int fd = _fd;
+            const ssize_t res = pread(fd, slot.buffer.get() + size, _block_size - size, offset + size);
+            if (res < 0 && errno == EINTR)
+                continue;
+
+            // O_DIRECT rejects the unaligned remainder of a short read; retry without it
+            if (res < 0 && errno == EINVAL && _fall_back_to_buffered(fd))
+                continue;
+
+            if (res <= 0) {
+                error = res ? std::strerror(errno) : "unexpected end of file";
+                break;
+            }
+
+            size += res;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!error.empty() && _error.empty())
+                _error = "[DirectFileReader] Cannot read " + _filename + ": " + error;
+
+            slot.size = std::min(size, expected);
+            slot.filled = true;
+        }
+        _cv.notify_all();
+
+        if (!error.empty())
+            return;
+    }
+}
+
+bool DirectFileReader::_fall_back_to_buffered(int failed_fd) {
+    const int error = errno;
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // another I/O thread already switched
+    if (failed_fd != _fd)
+        return true;
+
+    if (!_direct) {
+        errno = error;
+        return false;
+    }
+
+    const int fd = open(_filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        errno = error;
+        return false;
+    }
+
+    // other threads may still read from the old descriptor
+    _retired_fds.push_back(_fd);
+    _fd = fd;
+    _direct = false;
+    return true;
+}
+
+bool DirectFileReader::next(Block& block) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_holding) {
+        _slots[(_next_block - 1) % _slots.size()].filled = false;
+        _holding = false;
+        _cv.notify_all();
+    }
+
+    if (_next_block >= _number_of_blocks)
+        return false;
+
+    Slot& slot = _slots[_next_block % _slots.size()];
+    _cv.wait(lock, [&] {return slot.filled || !_error.empty();});
+
+    if (!_error.empty())
+        throw std::runtime_error(_error);
+
+    block.data = slot.buffer.get();
+    block.size = slot.size;
+    block.offset = _next_block * _block_size;
+
+    _holding = true;
+    ++_next_block;
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Sequential block reader with direct I/O and read-ahead
+ *
+ * DirectFileReader reads a file in large blocks with O_DIRECT, i.e. without
+ * polluting the page cache, and keeps up to queue_depth requests in flight:
+ * I/O thread i reads the blocks i, i + queue_depth, ... into its own aligned
+ * buffer while the consumer still processes the preceding blocks. Blocks are
+ * handed out in file order. If the file system does not support O_DIRECT
+ * (e.g. tmpfs), the file is read with buffered I/O instead. The same holds if
+ * a read is rejected later on, e.g. as the remainder of a short read is not
+ * aligned.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class DirectFileReader {
+public:
+    struct Block {
+        const char* data;
+        size_t size;
+        uint64_t offset; //!< position of data within the file
+    };
+
+    //! block_size is rounded up to a multiple of the alignment required by O_DIRECT
+    explicit DirectFileReader(const std::string& filename, size_t block_size = 8llu << 20, unsigned int queue_depth = 4);
+    ~DirectFileReader();
+
+    DirectFileReader(const DirectFileReader&) = delete;
+    DirectFileReader& operator=(const DirectFileReader&) = delete;
+
+    uint64_t file_size() const {return _file_size;}
+    size_t block_size() const {return _block_size;}
+
+    //! False if the file is read through the page cache
+    bool direct() const {return _direct;}
+
+    //! Returns the next block and releases the previous one; false at the end of the file
+    bool next(Block& block);
+
+protected:
+    constexpr static size_t alignment = 4096;
+
+    struct FreeDeleter {
+        void operator()(char* p) const {free(p);}
+    };
+
+    struct Slot {
+        std::unique_ptr<char, FreeDeleter> buffer;
+        size_t size;
+        bool filled;
+    };
+
+    const std::string _filename;
+    std::atomic<int> _fd;
+    std::atomic<bool> _direct;
+    std::vector<int> _retired_fds; //!< replaced by _fall_back_to_buffered(); closed at destruction
+    uint64_t _file_size;
+    size_t _block_size;
+    uint64_t _number_of_blocks;
+
+    std::vector<Slot> _slots;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    uint64_t _next_block; //!< next block handed out by next()
+    bool _holding;        //!< the consumer holds block _next_block - 1
+    bool _stop;
+    std::string _error;
+
+    std::vector<std::thread> _threads;
+
+    void _io_main(unsigned int slot);
+
+    //! Replaces the O_DIRECT descriptor failed_fd by a buffered one; false if a retry is futile
+    bool _fall_back_to_buffered(int failed_fd);
+};
@@ -92,7 +92,7 @@ stream& PutVarint(stream& s, uint64_t v) {
 	return s;
 };
 
-void export_as_thrillbin(EdgeStream &edges, node_t num_nodes, const std::string& filename) {
+inline void export_as_thrillbin(EdgeStream &edges, node_t num_nodes, const std::string& filename) {
 	edges.rewind();
 
 	std::ofstream out_stream(filename, std::ios::trunc | std::ios::binary);
@@ -294,7 +294,7 @@ void export_as_thrillbin_sorted(EdgeStream &edges, const std::string &filename,
 	out_stream.close();
 };
 
-void export_as_edgelist(EdgeStream &edges, const std::string& filename) {
+inline void export_as_edgelist(EdgeStream &edges, const std::string& filename) {
 	edges.rewind();
 
 	std::ofstream out_stream(filename, std::ios::trunc);
@@ -318,7 +318,7 @@ void export_as_edgelist(EdgeStream &edges, const std::string& filename) {
 	out_stream.close();
 };
 
-void export_as_snap(EdgeStream &edges, node_t num_nodes, const std::string& filename) {
+inline void export_as_snap(EdgeStream &edges, node_t num_nodes, const std::string& filename) {
 	edges.rewind();
 	edgeid_t num_edges = edges.size();
 
@@ -0,0 +1,448 @@
+#include "GraphFileReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <omp.h>
+#include <stxxl/sorter>
+
+#include <GenericComparator.h>
+#include <Utils/DirectFileReader.h>
+#include <Utils/Progress.h>
+#include <Utils/ThrillBinaryReader.h>
+
+namespace {
+    // smaller text ranges are not worth another thread
+    constexpr size_t min_bytes_per_thread = 1llu << 20;
+
+    bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    //! Reads the next number of a line; returns false at its end and clears valid on garbage
+    bool next_uint(const char*& p, const char* end, uint64_t& value, bool& valid) {
+        while (p < end && is_blank(*p))
+            ++p;
+
+        if (p == end)
+            return false;
+
+        // more than 19 digits may overflow
+        const char* q = p;
+        uint64_t v = 0;
+        for (; q < end && *q >= '0' && *q <= '9'; ++q)
+            v = 10 * v + static_cast<uint64_t>(*q - '0');
+
+        if (q == p || q - p > 19 || (q < end && !is_blank(*q))) {
+            valid = false;
+            return false;
+        }
+
+        value = v;
+        p = q;
+        return true;
+    }
+
+    template <typename Callback>
+    void for_each_line(const char* begin, const char* end, Callback callback) {
+        while (begin < end) {
+            const char* nl = static_cast<const char*>(memchr(begin, '\n', end - begin));
+            if (!nl)
+                nl = end;
+
+            callback(begin, nl);
+            begin = nl + 1;
+        }
+    }
+
+    //! Splits [begin, end), which ends with a line break, at line boundaries into one range per thread
+    std::vector<const char*> split_lines(const char* begin, const char* end) {
+        const size_t parts = std::max<size_t>(1, std::min<size_t>(omp_get_max_threads(), (end - begin) / min_bytes_per_thread));
+
+        std::vector<const char*> bounds {begin};
+        for (size_t i = 1; i < parts; ++i) {
+            const char* p = std::max(bounds.back(), begin + (end - begin) * i / parts);
+            if (p >= end) {
+                bounds.push_back(end);
+                continue;
+            }
+
+            bounds.push_back(static_cast<const char*>(memchr(p, '\n', end - p)) + 1);
+        }
+        bounds.push_back(end);
+
+        return bounds;
+    }
+
+    /**
+     * Reads a text file block by block. single_line(begin, end) is called for
+     * each line crossing a block boundary and lines(begin, end) for the runs
+     * of complete lines within a block (each terminated by a line break); both
+     * in file order.
+     */
+    template <typename SingleLine, typename Lines>
+    void for_each_text_block(DirectFileReader& reader, ProgressTask& progress, SingleLine single_line, Lines lines) {
+        std::string carry;
+
+        DirectFileReader::Block block;
+        while (reader.next(block)) {
+            const char* begin = block.data;
+            const char* const end = block.data + block.size;
+
+            const char* last = static_cast<const char*>(memrchr(begin, '\n', block.size));
+            if (!last) {
+                carry.append(begin, end);
+                progress.advance(block.size);
+                continue;
+            }
+
+            if (!carry.empty()) {
+                const char* nl = static_cast<const char*>(memchr(begin, '\n', end - begin));
+                carry.append(begin, nl);
+                single_line(carry.data(), carry.data() + carry.size());
+                begin = nl + 1;
+            }
+
+            if (begin <= last)
+                lines(begin, last + 1);
+
+            carry.assign(last + 1, end);
+            progress.advance(block.size);
+        }
+
+        if (!carry.empty())
+            single_line(carry.data(), carry.data() + carry.size());
+    }
+
+    void report(const std::string& filename, const GraphFileInfo& info, uint64_t bytes, double seconds) {
+        std::cout << "[GraphFileReader] Read " << info.num_edges << " edges with " << info.num_nodes
+                  << " nodes from " << filename << " in " << seconds << "s ("
+                  << (bytes / std::max(seconds, 1e-9) / (1 << 20)) << " MiB/s)" << std::endl;
+    }
+
+    GraphFileInfo load_binary(const std::string& filename, EdgeStream& edges, uint64_t& bytes) {
+        DirectFileReader reader(filename);
+        bytes = reader.file_size();
+        if (reader.file_size() % sizeof(edge_t))
+            throw std::runtime_error("[GraphFileReader] Size of " + filename + " is not a multiple of the edge size");
+
+        static_assert(sizeof(edge_t) == 2 * sizeof(node_t), "Binary format expects packed edges");
+        ProgressTask progress("Read edges", reader.file_size() / sizeof(edge_t));
+
+        GraphFileInfo info {0, 0};
+
+        // the block size is a multiple of the edge size, so no edge crosses a block boundary
+        DirectFileReader::Block block;
+        while (reader.next(block)) {
+            const size_t n = block.size / sizeof(edge_t);
+            for (size_t i = 0; i < n; ++i) {
+                edge_t e;
+                memcpy(&e, block.data + i * sizeof(edge_t), sizeof(edge_t));
+                edges.push(e);
+                info.num_nodes = std::max(info.num_nodes, std::max(e.first, e.second));
+            }
+
+            info.num_edges += n;
+            progress.advance(n);
+        }
+
+        info.num_nodes += !!info.num_edges;
+        return info;
+    }
+
+    GraphFileInfo load_thrillbin(const std::string& filename, EdgeStream& edges, uint64_t& bytes) {
+        // either the parts of export_as_thrillbin_sorted or a single file
+        ThrillBinaryReader reader(filename);
+        bytes = reader.file_size();
+        ProgressTask progress("Read bytes", reader.file_size());
+
+        uint64_t bytes_reported = 0;
+        for (; !reader.empty(); ++reader) {
+            edges.push(*reader);
+
+            if (UNLIKELY(reader.bytes_read() != bytes_reported)) {
+                progress.advance(reader.bytes_read() - bytes_reported);
+                bytes_reported = reader.bytes_read();
+            }
+        }
+
+        return GraphFileInfo {reader.nodes_read(), reader.edges_read()};
+    }
+
+    GraphFileInfo load_metis(const std::string& filename, EdgeStream& edges, uint64_t& bytes) {
+        DirectFileReader reader(filename);
+        bytes = reader.file_size();
+        ProgressTask progress("Read bytes", reader.file_size());
+
+        bool header_read = false;
+        uint64_t num_nodes = 0;
+        uint64_t declared_edges = 0;
+        uint64_t next_node = 0;
+        edgeid_t num_edges = 0;
+
+        auto is_comment = [] (const char* b, const char* e) {return b < e && *b == '%';};
+
+        auto malformed = [&] () {
+            return std::runtime_error("[GraphFileReader] Malformed METIS file " + filename);
+        };
+
+        // appends the edges {u, v} with u < v of node u sorted by v
+        auto parse_node = [&] (const char* b, const char* e, uint64_t u, std::vector<edge_t>& out, std::vector<node_t>& neighbours, bool& valid) {
+            if (u >= num_nodes) {
+                // only blank lines may follow the last node
+                while (b < e && is_blank(*b))
+                    ++b;
+                valid &= (b == e);
+                return;
+            }
+
+            neighbours.clear();
+            uint64_t v;
+            while (next_uint(b, e, v, valid)) {
+                if (v < 1 || v > num_nodes) {
+                    valid = false;
+                    return;
+                }
+
+                if (v - 1 > u)
+                    neighbours.push_back(static_cast<node_t>(v - 1));
+            }
+
+            std::sort(neighbours.begin(), neighbours.end());
+            for (const node_t w : neighbours)
+                out.emplace_back(static_cast<node_t>(u), w);
+        };
+
+        std::vector<edge_t> line_edges;
+        std::vector<node_t> line_neighbours;
+
+        auto single_line = [&] (const char* b, const char* e) {
+            if (is_comment(b, e))
+                return;
+
+            bool valid = true;
+            if (!header_read) {
+                uint64_t fmt = 0;
+                if (!next_uint(b, e, num_nodes, valid) || !next_uint(b, e, declared_edges, valid))
+                    throw malformed();
+                next_uint(b, e, fmt, valid);
+                if (!valid || num_nodes >= static_cast<uint64_t>(INVALID_NODE))
+                    throw malformed();
+                if (fmt)
+                    throw std::runtime_error("[GraphFileReader] Weighted METIS graphs are not supported: " + filename);
+
+                header_read = true;
+                return;
+            }
+
+            line_edges.clear();
+            parse_node(b, e, next_node++, line_edges, line_neighbours, valid);
+            if (!valid)
+                throw malformed();
+
+            for (const auto& edge : line_edges)
+                edges.push(edge);
+            num_edges += line_edges.size();
+        };
+
+        std::vector<std::vector<edge_t>> parsed;
+        std::vector<std::vector<node_t>> parsed_neighbours;
+
+        auto lines = [&] (const char* begin, const char* end) {
+            while (!header_read && begin < end) {
+                const char* nl = static_cast<const char*>(memchr(begin, '\n', end - begin));
+                single_line(begin, nl);
+                begin = nl + 1;
+            }
+
+            const auto bounds = split_lines(begin, end);
+            const int parts = static_cast<int>(bounds.size() - 1);
+            parsed.resize(std::max<size_t>(parsed.size(), parts));
+            parsed_neighbours.resize(parsed.size());
+
+            // the id of a node is the number of node lines before it
+            std::vector<uint64_t> first_node(parts + 1, 0);
+            #pragma omp parallel for num_threads(parts) schedule(static, 1)
+            for (int i = 0; i < parts; ++i) {
+                for_each_line(bounds[i], bounds[i + 1], [&] (const char* b, const char* e) {
+                    first_node[i + 1] += !is_comment(b, e);
+                });
+            }
+
+            first_node[0] = next_node;
+            for (int i = 0; i < parts; ++i)
+                first_node[i + 1] += first_node[i];
+
+            std::vector<char> valid(parts, true);
+            #pragma omp parallel for num_threads(parts) schedule(static, 1)
+            for (int i = 0; i < parts; ++i) {
+                parsed[i].clear();
+                uint64_t u = first_node[i];
+                bool ok = true;
+                for_each_line(bounds[i], bounds[i + 1], [&] (const char* b, const char* e) {
+                    if (!is_comment(b, e))
+                        parse_node(b, e, u++, parsed[i], parsed_neighbours[i], ok);
+                });
+                valid[i] = ok;
+            }
+
+            for (int i = 0; i < parts; ++i) {
+                if (!valid[i])
+                    throw malformed();
+
+                for (const auto& edge : parsed[i])
+                    edges.push(edge);
+                num_edges += parsed[i].size();
+            }
+
+            next_node = first_node[parts];
+        };
+
+        for_each_text_block(reader, progress, single_line, lines);
+
+        if (!header_read)
+            throw malformed();
+
+        if (static_cast<uint64_t>(num_edges) != declared_edges)
+            throw std::runtime_error("[GraphFileReader] " + filename + " declares " + std::to_string(declared_edges)
+                                     + " edges but contains " + std::to_string(num_edges));
+
+        return GraphFileInfo {static_cast<node_t>(num_nodes), num_edges};
+    }
+
+    GraphFileInfo load_snap(const std::string& filename, EdgeStream& edges, uint64_t& bytes) {
+        DirectFileReader reader(filename);
+        bytes = reader.file_size();
+        ProgressTask progress("Read bytes", reader.file_size());
+
+        using EdgeComparator = typename GenericComparator<edge_t>::Ascending;
+        stxxl::sorter<edge_t, EdgeComparator> sorter(EdgeComparator(), SORTER_MEM);
+
+        uint64_t max_id = 0;
+        uint64_t edge_lines = 0;
+
+        auto malformed = [&] () {
+            return std::runtime_error("[GraphFileReader] Malformed SNAP file " + filename);
+        };
+
+        // further columns (e.g. timestamps) are ignored
+        auto parse_line = [] (const char* b, const char* e, std::vector<edge_t>& out, uint64_t& max_id, uint64_t& edge_lines, bool& valid) {
+            while (b < e && is_blank(*b))
+                ++b;
+            if (b == e || *b == '#')
+                return;
+
+            uint64_t u, v;
+            if (!next_uint(b, e, u, valid) || !next_uint(b, e, v, valid)
+                || u >= static_cast<uint64_t>(INVALID_NODE) || v >= static_cast<uint64_t>(INVALID_NODE)) {
+                valid = false;
+                return;
+            }
+
+            max_id = std::max(max_id, std::max(u, v));
+            ++edge_lines;
+
+            if (u != v)
+                out.emplace_back(static_cast<node_t>(std::min(u, v)), static_cast<node_t>(std::max(u, v)));
+        };
+
+        std::vector<edge_t> line_edges;
+        auto single_line = [&] (const char* b, const char* e) {
+            bool valid = true;
+            line_edges.clear();
+            parse_line(b, e, line_edges, max_id, edge_lines, valid);
+            if (!valid)
+                throw malformed();
+
+            for (const auto& edge : line_edges)
+                sorter.push(edge);
+        };
+
+        std::vector<std::vector<edge_t>> parsed;
+        auto lines = [&] (const char* begin, const char* end) {
+            const auto bounds = split_lines(begin, end);
+            const int parts = static_cast<int>(bounds.size() - 1);
+            parsed.resize(std::max<size_t>(parsed.size(), parts));
+
+            std::vector<uint64_t> max_ids(parts, 0);
+            std::vector<uint64_t> counts(parts, 0);
+            std::vector<char> valid(parts, true);
+
+            #pragma omp parallel for num_threads(parts) schedule(static, 1)
+            for (int i = 0; i < parts; ++i) {
+                parsed[i].clear();
+                bool ok = true;
+                for_each_line(bounds[i], bounds[i + 1], [&] (const char* b, const char* e) {
+                    parse_line(b, e, parsed[i], max_ids[i], counts[i], ok);
+                });
+                valid[i] = ok;
+            }
+
+            for (int i = 0; i < parts; ++i) {
+                if (!valid[i])
+                    throw malformed();
+
+                for (const auto& edge : parsed[i])
+                    sorter.push(edge);
+                max_id = std::max(max_id, max_ids[i]);
+                edge_lines += counts[i];
+            }
+        };
+
+        for_each_text_block(reader, progress, single_line, lines);
+
+        sorter.sort();
+
+        GraphFileInfo info {edge_lines ? static_cast<node_t>(max_id + 1) : 0, 0};
+        edge_t last = edge_t::invalid();
+        for (; !sorter.empty(); ++sorter) {
+            if (*sorter == last)
+                continue;
+
+            last = *sorter;
+            edges.push(last);
+            ++info.num_edges;
+        }
+
+        if (static_cast<uint64_t>(info.num_edges) != edge_lines) {
+            std::cout << "[GraphFileReader] Dropped " << (edge_lines - info.num_edges)
+                      << " self-loops and multi-edges of " << filename << std::endl;
+        }
+
+        return info;
+    }
+}
+
+GraphFileFormat parse_graph_file_format(const std::string& name) {
+    if (name == "binary")    return GraphFileFormat::Binary;
+    if (name == "thrillbin") return GraphFileFormat::ThrillBin;
+    if (name == "metis")     return GraphFileFormat::Metis;
+    if (name == "snap")      return GraphFileFormat::Snap;
+
+    throw std::runtime_error("[GraphFileReader] Unknown graph format " + name + "; expected binary, thrillbin, metis or snap");
+}
+
+GraphFileInfo load_graph_file(const std::string& filename, GraphFileFormat format, EdgeStream& edges) {
+    const auto begin = std::chrono::steady_clock::now();
+
+    edges.clear();
+
+    GraphFileInfo info;
+    uint64_t bytes = 0;
+    switch (format) {
+        case GraphFileFormat::Binary:    info = load_binary(filename, edges, bytes); break;
+        case GraphFileFormat::ThrillBin: info = load_thrillbin(filename, edges, bytes); break;
+        case GraphFileFormat::Metis:     info = load_metis(filename, edges, bytes); break;
+        case GraphFileFormat::Snap:      info = load_snap(filename, edges, bytes); break;
+    }
+
+    edges.consume();
+
+    report(filename, info, bytes, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    return info;
+}
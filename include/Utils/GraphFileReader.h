@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @brief Loads graph files into an EdgeStream
+ *
+ * Supported formats:
+ *  - binary:    pairs of int32 as written by stxxl::vector<edge_t>; pushed as stored,
+ *               i.e. the file has to be sorted
+ *  - thrillbin: as written by export_as_thrillbin_sorted; either a single file or
+ *               the parts "<filename>.part-XXXXX"
+ *  - metis:     header "n m", followed by the 1-based neighbours of each node per line
+ *  - snap:      one edge "u v" per line and '#' comments; the edges are normalised and
+ *               sorted, self-loops and multi-edges are dropped
+ *
+ * All files are read with DirectFileReader, so decoding overlaps with the reads
+ * of the next blocks. Text blocks are split at line boundaries and parsed in
+ * parallel; the edges are then pushed in file order.
+ */
+#pragma once
+
+#include <string>
+
+#include <defs.h>
+#include <EdgeStream.h>
+
+enum class GraphFileFormat {
+    Binary,
+    ThrillBin,
+    Metis,
+    Snap
+};
+
+//! Accepts "binary", "thrillbin", "metis" and "snap"; throws std::runtime_error otherwise
+GraphFileFormat parse_graph_file_format(const std::string& name);
+
+struct GraphFileInfo {
+    node_t num_nodes;   //!< as declared in the file, or the largest id + 1
+    edgeid_t num_edges; //!< number of edges pushed
+};
+
+/**
+ * Clears edges, pushes the edges of the file and switches edges to reading mode.
+ * Throws std::runtime_error if the file cannot be read or is malformed.
+ */
+GraphFileInfo load_graph_file(const std::string& filename, GraphFileFormat format, EdgeStream& edges);
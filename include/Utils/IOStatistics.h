@@ -1,15 +1,34 @@
 #pragma once
 
+#include <atomic>
+#include <iostream>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <stxxl/stats>
 
 class IOStatistics {
+public:
+    /**
+     * Called for each named phase; the object returned lives as long as the phase.
+     * Telemetry installs a hook recording a span while a trace is open. The header
+     * thus stays self-contained and does not require linking Telemetry.
+     */
+    using phase_hook_t = std::shared_ptr<void> (*)(const std::string& name);
+
+    static std::atomic<phase_hook_t>& phase_hook() {
+        static std::atomic<phase_hook_t> hook(nullptr);
+        return hook;
+    }
+
+private:
     std::string _prefix;
 
     stxxl::stats& _stats;
     stxxl::stats_data _begin;
 
+    std::shared_ptr<void> _phase;
+
 public:
     IOStatistics(stxxl::stats & stats = *stxxl::stats::get_instance())
           : _stats(stats), _begin(stats)
@@ -19,6 +38,9 @@ public:
           : _prefix(prefix), _stats(stats), _begin(stats)
     {
         std::cout << "Begin IOStatistics [" << prefix << "]" << std::endl;
+
+        if (const phase_hook_t hook = phase_hook().load(std::memory_order_relaxed))
+            _phase = hook(prefix);
     }
 
     ~IOStatistics() {
@@ -3,12 +3,15 @@
 #include <limits>
 #include <array>
 #include <vector>
+#include <iterator>
 #include <tuple>
 #include <algorithm>
 #include <type_traits>
 #include <cassert>
 #include <omp.h>
 
+#include <PackedKey.h>
+
 namespace intsort {
 namespace internal {
 
@@ -270,5 +273,297 @@ inline void sort(std::vector<T> &input, KeyExtract key_extract,
     if (need_buffer) input.swap(buffer);
 }
 
+namespace internal {
+
+/**
+ * In-place MSD radix sort. Each level distributes the range into up to 2^RADIX_WIDTH
+ * buckets by the next digit of the key and recurses into the buckets.
+ *
+ * Large ranges are distributed in parallel as in PARADIS (Cho et al., VLDB'15):
+ * every thread permutes its stripe of each bucket speculatively, then each bucket
+ * moves its correctly placed elements to the front; the remaining elements are
+ * redistributed in the next round. The resulting buckets are sorted independently;
+ * buckets too large for a single thread recurse into the parallel distribution.
+ */
+template <typename Iter, typename KeyExtract, typename Key, size_t RADIX_WIDTH>
+class InplaceSorter {
+public:
+    constexpr static size_t no_buckets = 1 << RADIX_WIDTH;
+    using BucketArray = std::array<size_t, no_buckets>;
+
+    InplaceSorter(KeyExtract key_extract) : _key_extract(key_extract) {}
+
+    void sort(Iter begin, Iter end, const Key max_key, int max_threads) {
+        unsigned int bits = 0;
+        while (bits < 8 * sizeof(Key) && (max_key >> bits))
+            bits++;
+
+        if (!bits)
+            return;
+
+        const unsigned int shift = _next_shift(bits);
+        _sort_parallel(begin, end, shift, bits - shift, max_threads);
+    }
+
+protected:
+    // ranges below are sorted by insertion sort ...
+    constexpr static size_t insertion_threshold = 32;
+    // ... and below this per thread distributed sequentially
+    constexpr static size_t parallel_threshold = 1 << 17;
+
+    KeyExtract _key_extract;
+
+    static unsigned int _next_shift(unsigned int shift) {
+        return shift > RADIX_WIDTH ? shift - RADIX_WIDTH : 0;
+    }
+
+    size_t _digit(const Key key, unsigned int shift, unsigned int width) const {
+        return (key >> shift) & ((Key(1) << width) - 1);
+    }
+
+    void _insertion_sort(Iter begin, Iter end) const {
+        for (Iter it = begin + 1; it < end; ++it) {
+            auto value = std::move(*it);
+            const Key key = _key_extract(value);
+
+            Iter hole = it;
+            for (; hole != begin && key < _key_extract(*(hole - 1)); --hole)
+                *hole = std::move(*(hole - 1));
+
+            *hole = std::move(value);
+        }
+    }
+
+    //! Moves the elements in [heads[b], tails[b]) into bucket b (American flag sort)
+    void _permute_sequential(Iter begin, BucketArray& heads, const BucketArray& tails,
+                             unsigned int shift, unsigned int width) const {
+        for (size_t b = 0; b < (size_t(1) << width); ++b) {
+            while (heads[b] < tails[b]) {
+                auto value = std::move(begin[heads[b]]);
+                size_t c = _digit(_key_extract(value), shift, width);
+                while (c != b) {
+                    std::swap(value, begin[heads[c]++]);
+                    c = _digit(_key_extract(value), shift, width);
+                }
+                begin[heads[b]++] = std::move(value);
+            }
+        }
+    }
+
+    //! Recurses into the buckets [bounds[b], bounds[b+1]) sequentially
+    void _sort_sequential(Iter begin, Iter end, unsigned int shift, unsigned int width) const {
+        const size_t n = std::distance(begin, end);
+        if (n < 2)
+            return;
+
+        if (n < insertion_threshold) {
+            _insertion_sort(begin, end);
+            return;
+        }
+
+        const size_t buckets = size_t(1) << width;
+
+        BucketArray counts;
+        std::fill_n(counts.begin(), buckets, 0);
+        for (Iter it = begin; it != end; ++it)
+            counts[_digit(_key_extract(*it), shift, width)]++;
+
+        BucketArray heads, tails;
+        size_t index = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            heads[b] = index;
+            index += counts[b];
+            tails[b] = index;
+        }
+
+        // a digit shared by all keys (e.g. leading zeros) needs no permutation
+        if (counts[_digit(_key_extract(*begin), shift, width)] != n)
+            _permute_sequential(begin, heads, tails, shift, width);
+
+        if (!shift)
+            return;
+
+        const unsigned int next_shift = _next_shift(shift);
+        for (size_t b = 0; b < buckets; ++b) {
+            const size_t lo = tails[b] - counts[b];
+            if (counts[b] > 1)
+                _sort_sequential(begin + lo, begin + tails[b], next_shift, shift - next_shift);
+        }
+    }
+
+    void _sort_parallel(Iter begin, Iter end, unsigned int shift, unsigned int width, int max_threads) {
+        const size_t n = std::distance(begin, end);
+        const int no_threads = std::min<int>(max_threads, idiv_ceil(n, parallel_threshold));
+        if (no_threads < 2) {
+            _sort_sequential(begin, end, shift, width);
+            return;
+        }
+
+        const size_t buckets = size_t(1) << width;
+
+        // count keys per bucket; padding avoids false sharing
+        std::vector< std::array<size_t, no_buckets + 64 / sizeof(size_t)> > thread_counts(no_threads);
+        #pragma omp parallel num_threads(no_threads)
+        {
+            const int tid = omp_get_thread_num();
+            const size_t chunk_size = idiv_ceil(n, no_threads);
+            const size_t lo = std::min(n, chunk_size * tid);
+            const size_t hi = std::min(n, chunk_size * (tid + 1));
+
+            auto& counts = thread_counts[tid];
+            std::fill_n(counts.begin(), buckets, 0);
+            for (Iter it = begin + lo; it != begin + hi; ++it)
+                counts[_digit(_key_extract(*it), shift, width)]++;
+        }
+
+        BucketArray heads, tails;
+        {
+            size_t index = 0;
+            for (size_t b = 0; b < buckets; ++b) {
+                heads[b] = index;
+                for (int t = 0; t < no_threads; ++t)
+                    index += thread_counts[t][b];
+                tails[b] = index;
+            }
+        }
+        const BucketArray bucket_begin = heads;
+
+        // buckets [heads[b], tails[b]) still contain misplaced elements;
+        // a digit shared by all keys needs no permutation
+        size_t remaining = n;
+        for (size_t b = 0; b < buckets; ++b) {
+            if (tails[b] - heads[b] == n) {
+                heads[b] = tails[b];
+                remaining = 0;
+            }
+        }
+
+        while (remaining) {
+            // if the speculative rounds stop paying off, finish sequentially
+            if (remaining < parallel_threshold) {
+                _permute_sequential(begin, heads, tails, shift, width);
+                break;
+            }
+
+            #pragma omp parallel num_threads(no_threads)
+            {
+                const int tid = omp_get_thread_num();
+
+                // thread tid owns the tid-th stripe of every bucket
+                BucketArray stripe_head, stripe_tail;
+                for (size_t b = 0; b < buckets; ++b) {
+                    const size_t size = tails[b] - heads[b];
+                    stripe_head[b] = heads[b] + size * tid / no_threads;
+                    stripe_tail[b] = heads[b] + size * (tid + 1) / no_threads;
+                }
+
+                // afterwards [stripe_begin, stripe_head) of each stripe is placed correctly
+                for (size_t b = 0; b < buckets; ++b) {
+                    size_t scan = stripe_head[b];
+                    while (scan < stripe_tail[b]) {
+                        auto value = std::move(begin[scan]);
+                        size_t c = _digit(_key_extract(value), shift, width);
+                        while (c != b && stripe_head[c] < stripe_tail[c]) {
+                            std::swap(value, begin[stripe_head[c]++]);
+                            c = _digit(_key_extract(value), shift, width);
+                        }
+
+                        if (c == b) {
+                            if (scan != stripe_head[b])
+                                begin[scan] = std::move(begin[stripe_head[b]]);
+                            begin[stripe_head[b]++] = std::move(value);
+                            scan++;
+                        } else {
+                            begin[scan++] = std::move(value);
+                        }
+                    }
+                }
+
+                #pragma omp barrier
+
+                // collect the correctly placed elements at the front of each bucket
+                #pragma omp for schedule(dynamic, 1)
+                for (size_t b = 0; b < buckets; ++b) {
+                    auto first_misplaced = std::partition(begin + heads[b], begin + tails[b], [&] (const auto& x) {
+                        return _digit(_key_extract(x), shift, width) == b;
+                    });
+                    heads[b] = std::distance(begin, first_misplaced);
+                }
+            }
+
+            size_t new_remaining = 0;
+            for (size_t b = 0; b < buckets; ++b)
+                new_remaining += tails[b] - heads[b];
+
+            if (new_remaining > remaining / 2) {
+                _permute_sequential(begin, heads, tails, shift, width);
+                break;
+            }
+
+            remaining = new_remaining;
+        }
+
+        if (!shift)
+            return;
+
+        // sort buckets independently; large ones use all threads themselves
+        const unsigned int next_shift = _next_shift(shift);
+        const unsigned int next_width = shift - next_shift;
+        const size_t large_bucket = n / no_threads;
+
+        for (size_t b = 0; b < buckets; ++b) {
+            if (tails[b] - bucket_begin[b] > large_bucket)
+                _sort_parallel(begin + bucket_begin[b], begin + tails[b], next_shift, next_width, max_threads);
+        }
+
+        #pragma omp parallel for num_threads(no_threads) schedule(dynamic, 1)
+        for (size_t b = 0; b < buckets; ++b) {
+            const size_t size = tails[b] - bucket_begin[b];
+            if (size > 1 && size <= large_bucket)
+                _sort_sequential(begin + bucket_begin[b], begin + tails[b], next_shift, next_width);
+        }
+    }
+};
+
+} // namespace: internal
+
+/**
+ * Sorts [begin, end) by key_extract in-place, i.e. without the buffer of sort().
+ * The sort is not stable; all keys have to be in [0, max_key].
+ */
+template<typename Iter, typename KeyExtract, typename Key, size_t RADIX_WIDTH = 8>
+inline void sort_inplace(const Iter begin, const Iter end, KeyExtract key_extract,
+                         const Key max_key = std::numeric_limits<Key>::max()) {
+    #ifndef NDEBUG
+    for (auto it = begin; it != end; ++it)
+        assert(key_extract(*it) <= max_key);
+    #endif
+
+    internal::InplaceSorter<Iter, KeyExtract, Key, RADIX_WIDTH> sorter(key_extract);
+    sorter.sort(begin, end, max_key, omp_get_max_threads());
+}
+
+template<typename T, typename KeyExtract, typename Key, size_t RADIX_WIDTH = 8>
+inline void sort_inplace(std::vector<T> &input, KeyExtract key_extract,
+                         const Key max_key = std::numeric_limits<Key>::max()) {
+    sort_inplace<typename std::vector<T>::iterator, KeyExtract, Key, RADIX_WIDTH>
+        (input.begin(), input.end(), key_extract, max_key);
+}
+
+
+/**
+ * Sorts messages in-place by their PackedKey, i.e. in the order of operator<
+ * of DECL_LEX_COMPARE / DECL_PACKED_KEY types; not stable.
+ */
+template<typename Iter, typename T = typename std::iterator_traits<Iter>::value_type>
+inline void sort_packed(const Iter begin, const Iter end) {
+    sort_inplace<Iter>(begin, end, [] (const T& x) {return PackedKey<T>::pack(x);}, PackedKey<T>::max_key());
+}
+
+template<typename T>
+inline void sort_packed(std::vector<T> &input) {
+    sort_packed(input.begin(), input.end());
+}
+
 } // namespace: intsort
 
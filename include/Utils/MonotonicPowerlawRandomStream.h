@@ -11,24 +11,32 @@
 #include <defs.h>
 #include <cmath>
 #include "MonotonicUniformRandomStream.h"
+#include "ParallelMonotonicUniformRandomStream.h"
 
-template <bool Increasing = true>
+struct PowerlawDistributionParameters {
+    int_t minDegree;
+    int_t maxDegree;
+    int_t numberOfNodes;
+    double scale;
+
+    double exponent;
+};
+
+/**
+ * Sorted power-law distributed degrees obtained by inversion of sorted uniform
+ * variates. The UniformStream may be replaced by
+ * ParallelMonotonicUniformRandomStream<true> to sample the variates in parallel.
+ */
+template <bool Increasing = true, typename UniformStream = MonotonicUniformRandomStream<true>>
 class MonotonicPowerlawRandomStream {
 public:
     using value_type = degree_t;
 
-    struct Parameters {
-        int_t minDegree;
-        int_t maxDegree;
-        int_t numberOfNodes;
-        double scale;
-
-        double exponent;
-    };
+    using Parameters = PowerlawDistributionParameters;
 
 
 protected:
-    MonotonicUniformRandomStream<true> _uniform_random;
+    UniformStream _uniform_random;
 
     const degree_t _min_degree;
     const degree_t _max_degree;
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Power-Law degree sequence as stream of runs of equal degrees
+ */
+#pragma once
+
+#include <defs.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <DistributionCount.h>
+#include "MonotonicPowerlawRandomStream.h"
+#include <stxxl/bits/common/seed.h>
+
+/**
+ * Run-length encoded counterpart of MonotonicPowerlawRandomStream.
+ *
+ * Instead of sampling each node's degree, the number of nodes of each degree
+ * is drawn directly: sorting n i.i.d. samples yields a multinomial distribution
+ * of the counts, which is sampled as a sequence of binomials, each conditioned
+ * on the nodes and the probability mass remaining. Hence the work is linear in
+ * the number of distinct degrees rather than in the number of nodes.
+ *
+ * The stream yields DistributionBlockDescriptor items (as DistributionCount
+ * does), so it can be fed directly into HavelHakimiGeneratorRLE or into an
+ * RLEDegreeStream. Degrees without any node are skipped; consecutive degrees
+ * collapsing due to scaling are merged into a single run.
+ */
+template <bool Increasing = true>
+class MonotonicPowerlawRunStream {
+public:
+    using value_type = DistributionBlockDescriptor<degree_t>;
+    using Parameters = typename MonotonicPowerlawRandomStream<Increasing>::Parameters;
+
+protected:
+    STDRandomEngine _rand_gen;
+
+    const degree_t _min_degree;
+    const degree_t _max_degree;
+    const double _scale;
+
+    //! _weights[i] is the unnormalized probability of the i-th degree in stream order,
+    //! _tail_weights[i] the sum of all weights from i on
+    std::vector<double> _weights;
+    std::vector<double> _tail_weights;
+
+    size_t _next_index;
+    int_t _nodes_left;
+    stxxl::uint64 _nodes_emitted;
+
+    value_type _current;
+    bool _empty;
+
+    degree_t _degree_at(size_t i) const {
+        return Increasing ? static_cast<degree_t>(_min_degree + i)
+                          : static_cast<degree_t>(_max_degree - i);
+    }
+
+    //! Draws the number of nodes of the next degree; returns false if no degree is left
+    bool _sample_degree(degree_t &degree, int_t &count) {
+        if (_next_index >= _weights.size() || !_nodes_left)
+            return false;
+
+        const size_t i = _next_index++;
+        degree = static_cast<degree_t>(_degree_at(i) * _scale);
+
+        if (i + 1 == _weights.size()) {
+            count = _nodes_left;
+        } else {
+            const double p = std::min(1.0, _weights[i] / _tail_weights[i]);
+            std::binomial_distribution<int_t> distr(_nodes_left, p);
+            count = distr(_rand_gen);
+        }
+
+        _nodes_left -= count;
+        return true;
+    }
+
+    void _next_run() {
+        degree_t degree;
+        int_t count = 0;
+
+        // skip degrees without nodes
+        do {
+            if (!_sample_degree(degree, count)) {
+                _empty = true;
+                return;
+            }
+        } while (!count);
+
+        // merge subsequent degrees mapped onto the same value by scaling
+        while (_next_index < _weights.size() && _nodes_left
+               && static_cast<degree_t>(_degree_at(_next_index) * _scale) == degree) {
+            degree_t next_degree;
+            int_t next_count;
+            _sample_degree(next_degree, next_count);
+            count += next_count;
+        }
+
+        _nodes_emitted += count;
+        _current = {degree, static_cast<stxxl::uint64>(count), _nodes_emitted};
+    }
+
+public:
+    MonotonicPowerlawRunStream(int_t minDegree, int_t maxDegree, double gamma, int_t numberOfNodes, double scale = 1.0, seed_t seed = stxxl::get_next_seed())
+        : _rand_gen(seed)
+        , _min_degree(minDegree)
+        , _max_degree(maxDegree)
+        , _scale(scale)
+        , _next_index(0)
+        , _nodes_left(numberOfNodes)
+        , _nodes_emitted(0)
+        , _current({0, 0, 0})
+        , _empty(false)
+    {
+        assert(minDegree > 0);
+        assert(minDegree < maxDegree);
+        assert(numberOfNodes > 1);
+        assert(scale > 0);
+
+        const size_t num_degrees = static_cast<size_t>(maxDegree - minDegree + 1);
+        _weights.resize(num_degrees);
+        for (size_t i = 0; i < num_degrees; ++i)
+            _weights[i] = std::pow(double(_degree_at(i)), gamma);
+
+        // remaining probability mass is precomputed instead of subtracted to avoid cancellation
+        _tail_weights.resize(num_degrees);
+        double sum = 0.0;
+        for (size_t i = num_degrees; i--;) {
+            sum += _weights[i];
+            _tail_weights[i] = sum;
+        }
+
+        _next_run();
+    }
+
+    MonotonicPowerlawRunStream(const Parameters& p, seed_t seed = stxxl::get_next_seed()) :
+        MonotonicPowerlawRunStream(p.minDegree, p.maxDegree, p.exponent, p.numberOfNodes, p.scale, seed)
+    {}
+
+    bool empty() const {
+        return _empty;
+    }
+
+    const value_type& operator*() const {
+        return _current;
+    }
+
+    const value_type* operator->() const {
+        return &_current;
+    }
+
+    MonotonicPowerlawRunStream& operator++() {
+        _next_run();
+        return *this;
+    }
+};
@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @brief Sorted uniform variates generated in parallel segments
+ */
+#pragma once
+
+#include <random>
+#include <vector>
+#include <omp.h>
+#include <defs.h>
+#include <stxxl/bits/common/utils.h>
+#include <stxxl/bits/common/seed.h>
+#include "MonotonicUniformRandomStream.h"
+
+/**
+ * Drop-in replacement for MonotonicUniformRandomStream using all threads.
+ *
+ * The unit interval is split into K segments of equal width. The number of
+ * variates falling into each segment is drawn upfront by a multinomial split
+ * (a sequence of conditional binomials) from the master seed, which also
+ * yields one seed per segment. The segments are then sampled independently
+ * with a MonotonicUniformRandomStream each, several segments at a time in
+ * parallel, and emitted in order.
+ *
+ * The output only depends on the seed and the number of segments, i.e. it is
+ * reproducible independently of the number of threads. By default, the number
+ * of segments is derived from the number of elements such that each segment
+ * holds about segment_size variates.
+ */
+template <bool Increasing = true>
+class ParallelMonotonicUniformRandomStream {
+public:
+    using value_type = double;
+
+    //! Default number of variates per segment
+    static constexpr uint_t segment_size = uint_t(1) << 20;
+
+private:
+    struct Segment {
+        uint_t count;
+        seed_t seed;
+    };
+
+    std::vector<Segment> _segments;
+    size_t _next_segment;
+
+    //! Variates of the segments currently buffered, in output order
+    std::vector<std::vector<value_type>> _buffers;
+    size_t _buffer_idx;
+    size_t _buffer_pos;
+
+    bool _empty;
+    value_type _current;
+
+    //! Interval [lower, lower + width) of the segment with the given output position
+    void _segment_interval(size_t segment, double &lower, double &width) const {
+        const double K = static_cast<double>(_segments.size());
+        const size_t k = Increasing ? segment : _segments.size() - 1 - segment;
+        lower = k / K;
+        width = 1.0 / K;
+    }
+
+    void _fill_buffers() {
+        const size_t first = _next_segment;
+        const size_t num = std::min<size_t>(omp_get_max_threads(), _segments.size() - first);
+
+        _buffers.resize(num);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < num; ++i) {
+            const Segment &seg = _segments[first + i];
+            auto &buffer = _buffers[i];
+            buffer.clear();
+            buffer.reserve(seg.count);
+
+            double lower, width;
+            _segment_interval(first + i, lower, width);
+
+            if (!seg.count)
+                continue;
+
+            MonotonicUniformRandomStream<Increasing> rs(seg.count, seg.seed);
+            for (; !rs.empty(); ++rs)
+                buffer.push_back(lower + width * (*rs));
+        }
+
+        _next_segment += num;
+        _buffer_idx = 0;
+        _buffer_pos = 0;
+    }
+
+    void _advance() {
+        while (_buffer_idx < _buffers.size() && _buffer_pos >= _buffers[_buffer_idx].size()) {
+            ++_buffer_idx;
+            _buffer_pos = 0;
+        }
+
+        if (_buffer_idx >= _buffers.size()) {
+            if (_next_segment >= _segments.size()) {
+                _empty = true;
+                return;
+            }
+
+            _fill_buffers();
+            _advance();
+            return;
+        }
+
+        _current = _buffers[_buffer_idx][_buffer_pos];
+    }
+
+public:
+    ParallelMonotonicUniformRandomStream(uint_t elements, seed_t seed = stxxl::get_next_seed(), uint_t segments = 0)
+        : _next_segment(0)
+        , _buffer_idx(0)
+        , _buffer_pos(0)
+        , _empty(!elements)
+        , _current(Increasing ? 0.0 : 1.0)
+    {
+        if (!segments)
+            segments = std::max<uint_t>(1, (elements + segment_size - 1) / segment_size);
+
+        // multinomial split of the elements among equally sized segments
+        STDRandomEngine master(seed);
+        _segments.resize(segments);
+        uint_t remaining = elements;
+        for (uint_t k = 0; k < segments; ++k) {
+            uint_t count = remaining;
+            if (k + 1 < segments) {
+                std::binomial_distribution<uint_t> distr(remaining, 1.0 / (segments - k));
+                count = distr(master);
+            }
+
+            _segments[k] = {count, static_cast<seed_t>(master())};
+            remaining -= count;
+        }
+
+        if (!_empty)
+            _advance();
+    }
+
+    ParallelMonotonicUniformRandomStream& operator++() {
+        assert(!_empty);
+        ++_buffer_pos;
+        _advance();
+        return *this;
+    }
+
+    const value_type& operator * () const {
+        return _current;
+    };
+
+    bool empty() const {
+        return _empty;
+    };
+};
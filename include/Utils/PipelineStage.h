@@ -0,0 +1,233 @@
+/**
+ * @file
+ * @brief Building blocks to decouple a producer from a consumer thread
+ *
+ * SPSCBatchQueue is a bounded single-producer/single-consumer ring of
+ * fixed-capacity buffers ("batches"). The producer fills a batch in place and
+ * publishes it; the consumer reads it in place and hands it back. All memory is
+ * allocated in the constructor. If the ring is full, the producer blocks
+ * (back-pressure); if it is empty, the consumer blocks. A handoff only touches
+ * two atomics; a thread spins briefly before it sleeps on a condition variable,
+ * and the other side only takes the mutex if somebody actually sleeps.
+ *
+ * PipelineWorker is a persistent thread executing one job at a time, so that a
+ * stage can be restarted without spawning a new thread.
+ *
+ * AsyncStream (producer side in a worker) and AsyncPusher (consumer side in a
+ * worker) are built on top of these.
+ */
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <typename T>
+class SPSCBatchQueue {
+public:
+    struct Batch {
+        std::unique_ptr<T[]> data; //!< holds capacity() elements
+        size_t size;               //!< number of valid elements
+
+        T* begin() {return data.get();}
+        T* end() {return data.get() + size;}
+        const T* begin() const {return data.get();}
+        const T* end() const {return data.get() + size;}
+    };
+
+    SPSCBatchQueue(size_t batch_capacity, unsigned int number_of_batches)
+        : _batches(number_of_batches)
+        , _capacity(batch_capacity)
+    {
+        assert(batch_capacity > 0);
+        assert(number_of_batches > 1);
+
+        // default-initialised, so that the pages of trivial types are only
+        // touched once they are filled
+        for (auto& b : _batches) {
+            b.data.reset(new T[batch_capacity]);
+            b.size = 0;
+        }
+
+        reset();
+    }
+
+    SPSCBatchQueue(const SPSCBatchQueue&) = delete;
+    SPSCBatchQueue& operator=(const SPSCBatchQueue&) = delete;
+
+    size_t capacity() const {return _capacity;}
+    unsigned int number_of_batches() const {return _batches.size();}
+
+    //! Reopens the queue; only valid while neither side holds a batch
+    void reset() {
+        _head = 0;
+        _tail = 0;
+        _closed = false;
+        _cancelled = false;
+    }
+
+// Producer interface
+    //! Returns an empty batch to fill; blocks while all batches are in use; nullptr after cancel()
+    Batch* begin_produce() {
+        const uint64_t tail = _tail.load(std::memory_order_relaxed);
+        _wait([&] {return tail - _head.load() < _batches.size() || _cancelled.load();});
+
+        if (_cancelled.load())
+            return nullptr;
+
+        Batch& b = _batches[tail % _batches.size()];
+        b.size = 0;
+        return &b;
+    }
+
+    //! Publishes the batch obtained by begin_produce()
+    void end_produce() {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1);
+        _notify();
+    }
+
+    //! Signals that no more batches follow
+    void close() {
+        _closed = true;
+        _notify();
+    }
+
+// Consumer interface
+    //! Returns the next filled batch; blocks until one is available; nullptr if closed and drained, or cancelled
+    Batch* begin_consume() {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        _wait([&] {return _tail.load() != head || _closed.load() || _cancelled.load();});
+
+        if (_cancelled.load() || _tail.load() == head)
+            return nullptr;
+
+        return &_batches[head % _batches.size()];
+    }
+
+    //! Hands the batch obtained by begin_consume() back to the producer
+    void end_consume() {
+        _head.store(_head.load(std::memory_order_relaxed) + 1);
+        _notify();
+    }
+
+    //! Aborts both sides, e.g. if the consumer stops early
+    void cancel() {
+        _cancelled = true;
+        _notify();
+    }
+
+    //! Number of times a side had to sleep because the queue was full or empty
+    uint64_t number_of_blocks() const {
+        return _stat_blocks.load(std::memory_order_relaxed);
+    }
+
+protected:
+    constexpr static unsigned int spin_iterations = 128;
+
+    std::vector<Batch> _batches;
+    const size_t _capacity;
+
+    // batches [_head, _tail) are filled; both only grow
+    alignas(64) std::atomic<uint64_t> _head;
+    alignas(64) std::atomic<uint64_t> _tail;
+    alignas(64) std::atomic<bool> _closed;
+    std::atomic<bool> _cancelled;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::atomic<unsigned int> _sleepers {0};
+    std::atomic<uint64_t> _stat_blocks {0};
+
+    template <typename Pred>
+    void _wait(Pred ready) {
+        for (unsigned int i = 0; i < spin_iterations; ++i) {
+            if (ready())
+                return;
+            if (i > spin_iterations / 2)
+                std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _sleepers++;
+        _stat_blocks.fetch_add(1, std::memory_order_relaxed);
+        _cv.wait(lock, ready);
+        _sleepers--;
+    }
+
+    void _notify() {
+        // the seq_cst store of the index/flag before and this load pair with
+        // the increment of _sleepers and the predicate check in _wait
+        if (_sleepers.load()) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.notify_all();
+        }
+    }
+};
+
+class PipelineWorker {
+public:
+    PipelineWorker()
+        : _has_job(false)
+        , _shutdown(false)
+        , _thread(&PipelineWorker::_main, this)
+    {}
+
+    ~PipelineWorker() {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [&] {return !_has_job;});
+            _shutdown = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    PipelineWorker(const PipelineWorker&) = delete;
+    PipelineWorker& operator=(const PipelineWorker&) = delete;
+
+    //! Executes job asynchronously; waits for the previous job to finish
+    void run(std::function<void()> job) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [&] {return !_has_job;});
+        _job = std::move(job);
+        _has_job = true;
+        _cv.notify_all();
+    }
+
+    //! Blocks until the current job (if any) has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [&] {return !_has_job;});
+    }
+
+protected:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::function<void()> _job;
+    bool _has_job;
+    bool _shutdown;
+    std::thread _thread;
+
+    void _main() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _cv.wait(lock, [&] {return _has_job || _shutdown;});
+            if (!_has_job)
+                return;
+
+            lock.unlock();
+            _job();
+            lock.lock();
+
+            _job = nullptr;
+            _has_job = false;
+            _cv.notify_all();
+        }
+    }
+};
@@ -0,0 +1,188 @@
+#include "Progress.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <stxxl/bits/mng/block_manager.h>
+
+// this introduces a memory leak; the reporter is stopped by an atexit handler
+Progress* Progress::_instance = new Progress();
+std::atomic<bool> Progress::_enabled(false);
+
+namespace {
+    std::string format_duration(double seconds) {
+        const uint64_t s = static_cast<uint64_t>(std::max(0.0, seconds));
+        std::ostringstream oss;
+        oss << std::setfill('0') << std::setw(2) << (s / 3600) << ":"
+            << std::setw(2) << (s / 60 % 60) << ":"
+            << std::setw(2) << (s % 60);
+        return oss.str();
+    }
+
+    std::string format_bytes(double bytes) {
+        static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        unsigned int unit = 0;
+        for (; bytes >= 1024.0 && unit < 4; ++unit)
+            bytes /= 1024.0;
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << bytes << " " << units[unit];
+        return oss.str();
+    }
+
+    uint64_t resident_set_bytes() {
+        std::ifstream statm("/proc/self/statm");
+        uint64_t size = 0, resident = 0;
+        if (!(statm >> size >> resident))
+            return 0;
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+}
+
+void Progress::start(double interval_seconds, const std::string& status_filename) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_thread.joinable())
+        throw std::runtime_error("[Progress] Reporter is already running");
+
+    if (interval_seconds <= 0)
+        throw std::runtime_error("[Progress] Report interval has to be positive");
+
+    _interval = std::chrono::duration<double>(interval_seconds);
+    _status_filename = status_filename;
+    _stop = false;
+
+    _origin = Clock::now();
+    _last_report = _origin;
+    _last_io = stxxl::stats_data(*stxxl::stats::get_instance());
+
+    static bool registered = false;
+    if (!registered) {
+        std::atexit([] {Progress::get_instance().stop();});
+        registered = true;
+    }
+
+    _enabled = true;
+    _thread = std::thread(&Progress::_run, this);
+}
+
+void Progress::stop() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_thread.joinable())
+            return;
+
+        _stop = true;
+    }
+
+    _wakeup.notify_all();
+    _thread.join();
+    _enabled = false;
+}
+
+void Progress::_register(ProgressTask* task) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _tasks.push_back(task);
+
+    if (!_aggregates.count(task->name()))
+        _aggregates[task->name()].first_seen = Clock::now();
+}
+
+void Progress::_unregister(ProgressTask* task) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _tasks.erase(std::remove(_tasks.begin(), _tasks.end(), task), _tasks.end());
+
+    Aggregate& agg = _aggregates[task->name()];
+    agg.retired_done += task->done();
+    agg.retired_total += task->total();
+}
+
+void Progress::_run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_stop) {
+        _wakeup.wait_for(lock, _interval, [this] {return _stop;});
+        _report();
+    }
+}
+
+void Progress::_report() {
+    // called with _mutex held
+    const Clock::time_point now = Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - _last_report).count();
+    const double elapsed_total = std::chrono::duration<double>(now - _origin).count();
+    if (elapsed <= 0)
+        return;
+
+    std::ostringstream line;
+    line << std::setprecision(3);
+    line << "[Progress] " << format_duration(elapsed_total);
+
+    // tasks in order of their first appearance
+    std::vector<std::string> names;
+    for (const auto* task : _tasks) {
+        if (std::find(names.begin(), names.end(), task->name()) == names.end())
+            names.push_back(task->name());
+    }
+
+    for (const auto& name : names) {
+        Aggregate& agg = _aggregates[name];
+
+        uint64_t done = agg.retired_done;
+        uint64_t total = agg.retired_total;
+        for (const auto* task : _tasks) {
+            if (task->name() == name) {
+                done += task->done();
+                total += task->total();
+            }
+        }
+
+        const double rate = (done - std::min(done, agg.last_done)) / elapsed;
+        agg.last_done = done;
+
+        line << " | " << name << " " << done;
+        if (total) {
+            line << "/" << total << " (" << std::fixed << std::setprecision(1)
+                 << (100.0 * done / total) << "%)" << std::defaultfloat << std::setprecision(3);
+        }
+        line << " " << rate << "/s";
+
+        // the average rate since the task appeared is more stable than the current one
+        const double avg_rate = done / std::chrono::duration<double>(now - agg.first_seen).count();
+        if (total && done < total && avg_rate > 0)
+            line << " ETA " << format_duration((total - done) / avg_rate);
+    }
+
+    const stxxl::stats_data io(*stxxl::stats::get_instance());
+    const stxxl::stats_data io_delta = io - _last_io;
+    _last_io = io;
+
+    line << " | IO r " << format_bytes(io_delta.get_read_volume() / elapsed) << "/s"
+         << " w " << format_bytes(io_delta.get_written_volume() / elapsed) << "/s"
+         << " | EM " << format_bytes(stxxl::block_manager::get_instance()->get_current_allocation())
+         << " | RSS " << format_bytes(resident_set_bytes());
+
+    _last_report = now;
+
+    if (_status_filename.empty()) {
+        std::cerr << line.str() << std::endl;
+    } else {
+        // replace the file atomically, so readers never see a partial line
+        const std::string tmp = _status_filename + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << line.str() << "\n";
+        }
+        std::rename(tmp.c_str(), _status_filename.c_str());
+    }
+}
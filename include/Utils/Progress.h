@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Periodic progress and throughput reports for long runs
+ *
+ * Long-running loops create a ProgressTask and advance() it once per unit of
+ * work (a swap run, a macrochunk, a community, ...). Advancing is a single
+ * relaxed atomic addition, so tasks may be shared by OpenMP workers.
+ *
+ * Once Progress::get_instance().start(interval) was called, a background
+ * thread prints one status line per interval containing, for each task name,
+ * the work done, the current rate and (if the total is known) an ETA,
+ * followed by the current I/O bandwidth and the EM and RSS memory usage, e.g.
+ *
+ *   [Progress] 00:12:31 | TFP swaps 4.2e+08/1e+09 (42.0%) 6.1e+05/s ETA 00:15:50 | IO r 310.2 MiB/s w 290.7 MiB/s | EM 18.3 GiB | RSS 2.1 GiB
+ *
+ * Tasks of the same name (e.g. the community workers) are aggregated, also
+ * over tasks that have already been destroyed. If a status file is given, it
+ * is overwritten with the latest line instead of printing to stderr. While the
+ * reporter is not running, tasks are not registered and advance() only
+ * updates an unused counter.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stxxl/stats>
+
+class ProgressTask;
+
+class Progress {
+public:
+    static Progress& get_instance() {
+        return *_instance;
+    }
+
+    static bool enabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Starts the reporter thread; throws if it already runs
+     * @param interval_seconds  Time between two reports
+     * @param status_filename   If non-empty, the file is overwritten with the latest report instead of printing to stderr
+     */
+    void start(double interval_seconds, const std::string& status_filename = "");
+
+    //! Prints a final report and joins the reporter thread; called automatically at exit
+    void stop();
+
+    ~Progress() {
+        stop();
+    }
+
+protected:
+    friend class ProgressTask;
+
+    using Clock = std::chrono::steady_clock;
+
+    static Progress* _instance;
+    static std::atomic<bool> _enabled;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::thread _thread;
+    bool _stop {false};
+
+    std::chrono::duration<double> _interval;
+    std::string _status_filename;
+
+    std::vector<ProgressTask*> _tasks;
+
+    //! Per task name: work of tasks already destroyed and the state at the previous report
+    struct Aggregate {
+        uint64_t retired_done {0};
+        uint64_t retired_total {0};
+        uint64_t last_done {0};
+        Clock::time_point first_seen;
+    };
+    std::map<std::string, Aggregate> _aggregates;
+
+    stxxl::stats_data _last_io;
+    Clock::time_point _origin;
+    Clock::time_point _last_report;
+
+    void _register(ProgressTask* task);
+    void _unregister(ProgressTask* task);
+
+    void _run();
+    void _report();
+};
+
+class ProgressTask {
+public:
+    /**
+     * @param name   Tasks of the same name are reported as one
+     * @param total  Expected amount of work; 0 if unknown (no ETA is reported)
+     */
+    explicit ProgressTask(const std::string& name, uint64_t total = 0)
+        : _name(name)
+        , _done(0)
+        , _total(total)
+        , _registered(Progress::enabled())
+    {
+        if (_registered)
+            Progress::get_instance()._register(this);
+    }
+
+    ~ProgressTask() {
+        if (_registered)
+            Progress::get_instance()._unregister(this);
+    }
+
+    ProgressTask(const ProgressTask&) = delete;
+    ProgressTask& operator=(const ProgressTask&) = delete;
+
+    void advance(uint64_t amount = 1) {
+        _done.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void add_total(uint64_t amount) {
+        _total.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    const std::string& name() const {return _name;}
+    uint64_t done() const {return _done.load(std::memory_order_relaxed);}
+    uint64_t total() const {return _total.load(std::memory_order_relaxed);}
+
+private:
+    const std::string _name;
+    std::atomic<uint64_t> _done;
+    std::atomic<uint64_t> _total;
+    const bool _registered;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cassert>
 #include <stxxl/bits/common/utils.h>
 
 
@@ -20,21 +21,23 @@ protected:
     template <typename T1>
     void _build(const std::vector<T1>& leaves) {
         const Index n = leaves.size();
-
-        // FIX-ME: we can to it in linear time
-        for(Index i=0; i < n; i++) {
-            auto idx = i+_inner_nodes_offset;
-            _total_weight += leaves[i];
-
-            for(unsigned int l=_layers+1; l>1; --l) {
-                auto parent = idx >> 1;
-                bool is_right_child = idx & 1;
-
-                _tree_data[parent] += leaves[i] * !is_right_child;
-
-                idx = parent;
+        assert(n <= _inner_nodes_offset);
+
+        // subtree sums of the current layer; starts with the (padded) leaves.
+        // each inner node stores the weight of its left subtree, i.e. the sum of its
+        // left child, so we can compute all layers bottom-up in linear time
+        std::vector<T> sums(_inner_nodes_offset, 0);
+        for(Index i=0; i < n; i++)
+            sums[i] = leaves[i];
+
+        for(Index width = _inner_nodes_offset / 2; width; width /= 2) {
+            for(Index i=0; i < width; i++) {
+                _tree_data[width + i] = sums[2*i];
+                sums[i] = sums[2*i] + sums[2*i + 1];
             }
         }
+
+        _total_weight = sums[0];
     }
 
 public:
@@ -49,6 +52,15 @@ public:
         _build(leaves);
     }
 
+    /**
+     * Replace all leaf weights in linear time.
+     * The number of leaves must not exceed the one used during construction.
+     */
+    template <typename T1>
+    void rebuild(const std::vector<T1>& leaves) {
+        _build(leaves);
+    }
+
     Index getLeaf(T weight) const {
         Index idx = 1;
 
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Selection and naming of snapshots taken in certain phases of a randomisation
+ */
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <list>
+#include <string>
+
+#include <defs.h>
+
+//! Replaces every %p in pattern by the phase
+inline std::string snapshot_filename(const std::string& pattern, unsigned int phase) {
+    std::string result(pattern);
+    std::string phaseStr = std::to_string(phase);
+
+    size_t index = 0;
+    while (true) {
+        index = result.find("%p", index);
+        if (index == std::string::npos)
+            break;
+
+        result.replace(index, 2, phaseStr);
+        index += phaseStr.length();
+    }
+
+    return result;
+}
+
+/**
+ * Parses a comma-separated list of phases and ranges start:stop:step as in
+ * python; open ranges end before maxPhase. Returns the sorted, unique phases.
+ */
+inline std::list<uint_t> parse_phases(const std::string& phases, uint_t maxPhase) {
+    std::string str = phases;
+    str.erase(remove_if(str.begin(), str.end(), isspace), str.end());
+
+    size_t blockBegin = 0;
+    size_t blockEnd = 0;
+
+    std::list<uint_t> result;
+
+    while(true) {
+        // find next block
+        blockBegin = blockEnd;
+        blockEnd = str.find(',', blockBegin+1);
+        std::string block = str.substr(blockBegin, blockEnd-blockBegin);
+
+        // check if we have a range
+        const size_t firstColon = block.find(':');
+        if (firstColon == std::string::npos) {
+           if (!block.empty())
+              result.push_back(atoll(block.c_str()));
+
+        } else {
+            const size_t secondColon = block.find(':', firstColon+1);
+
+
+            // extract block infos
+            uint_t start = firstColon ?  atoll(block.substr(0, firstColon).c_str()) : 0;
+            uint_t step = (secondColon == std::string::npos)
+                          ? 1
+                          : atoll(block.substr(secondColon+1, std::string::npos).c_str());
+
+            uint_t stop;
+            if (firstColon+1 == secondColon) {
+                stop = maxPhase;
+            } else {
+                if (secondColon == std::string::npos) {
+                    if (firstColon+1 == block.size()) {
+                        stop = maxPhase;
+                    } else {
+                        stop = atoll(block.substr(firstColon + 1, std::string::npos).c_str());
+                    }
+                } else {
+                    stop = atoll(block.substr(firstColon + 1, secondColon - firstColon).c_str());
+                }
+            }
+
+            for(uint_t i=start; i < stop; i += step)
+                result.push_back(i);
+        }
+
+        // terminate if done
+        if (!(blockEnd < str.size()))
+            break;
+
+        blockEnd++;
+    }
+
+    result.sort();
+    result.unique();
+
+    return result;
+}
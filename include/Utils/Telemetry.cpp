@@ -0,0 +1,166 @@
+#include "Telemetry.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <stxxl/bits/mng/block_manager.h>
+#include <Utils/IOStatistics.h>
+
+// this introduces a memory leak; the file is finished by an atexit handler
+Telemetry* Telemetry::_instance = new Telemetry();
+std::atomic<bool> Telemetry::_enabled(false);
+
+namespace {
+    // names of the spans currently open in this thread
+    thread_local std::vector<std::string> span_stack;
+
+    std::string escape(const std::string& str) {
+        std::string result;
+        result.reserve(str.size());
+        for (char c : str) {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    int64_t clock_us(clockid_t clock) {
+        timespec ts;
+        clock_gettime(clock, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+    }
+}
+
+void Telemetry::open(const std::string& filename) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_out.is_open())
+        throw std::runtime_error("[Telemetry] Trace file is already open");
+
+    _out.open(filename, std::ios::trunc);
+    if (!_out)
+        throw std::runtime_error("[Telemetry] Cannot open trace file " + filename);
+
+    const std::string ext(".jsonl");
+    _jsonl = filename.size() >= ext.size() && 0 == filename.compare(filename.size() - ext.size(), ext.size(), ext);
+    _first_event = true;
+
+    if (!_jsonl)
+        _out << "[";
+
+    static bool registered = false;
+    if (!registered) {
+        std::atexit([] {Telemetry::get_instance().close();});
+        registered = true;
+    }
+
+    // named IOStatistics phases are recorded as spans
+    IOStatistics::phase_hook() = [] (const std::string& name) -> std::shared_ptr<void> {
+        return std::make_shared<TelemetrySpan>(name);
+    };
+
+    _enabled = true;
+}
+
+void Telemetry::close() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (!_out.is_open())
+        return;
+
+    _enabled = false;
+
+    if (!_jsonl)
+        _out << "\n]\n";
+
+    _out.close();
+}
+
+int64_t Telemetry::_wall_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t Telemetry::_thread_cpu_us() {
+    return clock_us(CLOCK_THREAD_CPUTIME_ID);
+}
+
+int64_t Telemetry::_process_cpu_us() {
+    return clock_us(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+uint32_t Telemetry::_thread_id() {
+    return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
+
+void Telemetry::_write(const std::string& event) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (!_out.is_open())
+        return;
+
+    if (_jsonl) {
+        _out << event << "\n";
+    } else {
+        _out << (_first_event ? "\n" : ",\n") << event;
+    }
+
+    _first_event = false;
+}
+
+void TelemetrySpan::_begin(const std::string& name) {
+    _active = true;
+    _name = name;
+
+    for (const auto& parent : span_stack)
+        _path += parent + "/";
+    _path += name;
+    span_stack.push_back(name);
+
+    _io_begin = stxxl::stats_data(*stxxl::stats::get_instance());
+    _thread_cpu_begin = Telemetry::_thread_cpu_us();
+    _process_cpu_begin = Telemetry::_process_cpu_us();
+    _wall_begin = Telemetry::_wall_us();
+}
+
+void TelemetrySpan::_end() {
+    const int64_t wall_end = Telemetry::_wall_us();
+    const int64_t thread_cpu = Telemetry::_thread_cpu_us() - _thread_cpu_begin;
+    const int64_t process_cpu = Telemetry::_process_cpu_us() - _process_cpu_begin;
+    const stxxl::stats_data io = stxxl::stats_data(*stxxl::stats::get_instance()) - _io_begin;
+    const auto em_peak = stxxl::block_manager::get_instance()->get_maximum_allocation();
+
+    span_stack.pop_back();
+
+    Telemetry& telemetry = Telemetry::get_instance();
+
+    std::ostringstream args;
+    args << "\"path\": \"" << escape(_path) << "\", "
+         << "\"thread_cpu_us\": " << thread_cpu << ", "
+         << "\"process_cpu_us\": " << process_cpu << ", "
+         << "\"io_reads\": " << io.get_reads() << ", "
+         << "\"io_writes\": " << io.get_writes() << ", "
+         << "\"io_read_bytes\": " << io.get_read_volume() << ", "
+         << "\"io_written_bytes\": " << io.get_written_volume() << ", "
+         << "\"em_peak_bytes\": " << em_peak;
+
+    for (const auto& c : _counters)
+        args << ", \"" << escape(c.first) << "\": " << c.second;
+
+    std::ostringstream event;
+    event << "{\"name\": \"" << escape(_name) << "\", "
+          << "\"ph\": \"X\", "
+          << "\"pid\": 0, "
+          << "\"tid\": " << Telemetry::_thread_id() << ", "
+          << "\"ts\": " << (_wall_begin - telemetry._origin_us) << ", "
+          << "\"dur\": " << (wall_end - _wall_begin) << ", "
+          << "\"args\": {" << args.str() << "}}";
+
+    telemetry._write(event.str());
+}
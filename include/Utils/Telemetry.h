@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief Hierarchical phase telemetry written as Chrome trace or JSONL
+ *
+ * A TelemetrySpan measures the phase between its construction and its
+ * destruction. Spans opened by the same thread while another span is alive
+ * become its children. Each span records
+ *  - wall time and CPU time (of the calling thread and of the whole process),
+ *  - STXXL read/write operations and bytes,
+ *  - the peak EM allocation so far (em_peak_bytes); this is the process-global
+ *    maximum of STXXL's block manager, not the peak within the span,
+ *  - arbitrary counters (e.g. sorter item counts) added via counter().
+ *
+ * Recording is enabled by Telemetry::get_instance().open(filename). If the
+ * filename ends with ".jsonl", one JSON object per span is written per line;
+ * otherwise the file is a Chrome trace (load it in chrome://tracing or
+ * Perfetto). While disabled, a span only costs a single branch.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stxxl/stats>
+
+class Telemetry {
+public:
+    static Telemetry& get_instance() {
+        return *_instance;
+    }
+
+    static bool enabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    //! Starts recording into the given file; throws if it cannot be opened
+    void open(const std::string& filename);
+
+    //! Finishes the file; called automatically at exit
+    void close();
+
+    ~Telemetry() {
+        close();
+    }
+
+protected:
+    friend class TelemetrySpan;
+
+    static Telemetry* _instance;
+    static std::atomic<bool> _enabled;
+
+    std::mutex _mutex;
+    std::ofstream _out;
+    bool _jsonl {false};
+    bool _first_event {true};
+
+    // process-wide origin of all timestamps
+    const int64_t _origin_us {_wall_us()};
+
+    static int64_t _wall_us();
+    static int64_t _thread_cpu_us();
+    static int64_t _process_cpu_us();
+    static uint32_t _thread_id();
+
+    void _write(const std::string& event);
+};
+
+class TelemetrySpan {
+public:
+    explicit TelemetrySpan(const std::string& name) {
+        if (Telemetry::enabled())
+            _begin(name);
+    }
+
+    ~TelemetrySpan() {
+        if (_active)
+            _end();
+    }
+
+    TelemetrySpan(const TelemetrySpan&) = delete;
+    TelemetrySpan& operator=(const TelemetrySpan&) = delete;
+
+    //! Attaches a named value to the span; reported when the span ends
+    void counter(const char* key, uint64_t value) {
+        if (_active)
+            _counters.emplace_back(key, value);
+    }
+
+private:
+    bool _active {false};
+    std::string _name;
+    std::string _path;
+
+    int64_t _wall_begin;
+    int64_t _thread_cpu_begin;
+    int64_t _process_cpu_begin;
+    stxxl::stats_data _io_begin;
+
+    std::vector<std::pair<const char*, uint64_t>> _counters;
+
+    void _begin(const std::string& name);
+    void _end();
+};
@@ -1,118 +1,205 @@
+/**
+ * @file
+ * @brief Streaming reader for graphs in the thrillbin format
+ *
+ * For each node u, the format stores the number of neighbours v listed for u as
+ * varint followed by their 32 bit ids. A graph is either a single file (as written
+ * by export_as_thrillbin) or split at node boundaries into the files
+ * "<filename>.part-00000", "<filename>.part-00001", ... (as written by
+ * export_as_thrillbin_sorted). The reader yields the edges (u, v) in the order
+ * written; all files are read with DirectFileReader and decoded block by block.
+ */
 #pragma once
+
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include <defs.h>
+#include <Utils/DirectFileReader.h>
 
 class ThrillBinaryReader {
 public:
     using value_type = edge_t;
 
-    ThrillBinaryReader(const std::string& filename = "")
+    explicit ThrillBinaryReader(const std::string& filename = "", size_t block_size = 8llu << 20)
+        : _block_size(block_size)
+        , _empty(true)
     {
         if (!filename.empty())
             open(filename);
     }
 
-    void open(const std::string& filename) {
-        _is.close();
+    static std::string part_filename(const std::string& filename, size_t part) {
+        std::stringstream ss;
+        ss << filename << ".part-" << std::setw(5) << std::setfill('0') << part;
+        return ss.str();
+    }
 
-        _current = {0, 0};
-        _edges_read = 0;
-        _remaining_degree = 0;
-        _empty = false;
+    //! Files storing the graph: all existing parts or, if there are none, the file itself
+    static std::vector<std::string> files(const std::string& filename) {
+        std::vector<std::string> result;
+        for (size_t i = 0; std::ifstream(part_filename(filename, i)).good(); ++i)
+            result.push_back(part_filename(filename, i));
 
+        if (result.empty() && std::ifstream(filename).good())
+            result.push_back(filename);
 
-        _is.open(filename);
-        _advance();
+        return result;
     }
 
-    ThrillBinaryReader& operator++() {
-        _advance();
-        return *this;
+    //! True if the graph exists either as parts or as a single file
+    static bool exists(const std::string& filename) {
+        return !files(filename).empty();
     }
 
-    const value_type & operator*() const {
-        assert(!empty());
-        return _current;
+    void open(const std::string& filename) {
+        _filename = filename;
+        _files = files(filename);
+        if (_files.empty())
+            throw std::runtime_error("[ThrillBinaryReader] Neither " + part_filename(filename, 0) + " nor " + filename + " exists");
+
+        _reader.reset();
+        _next_file = 0;
+        _pos = _end = nullptr;
+
+        _file_size = 0;
+        for (const auto& file : _files)
+            _file_size += std::ifstream(file, std::ios::binary | std::ios::ate).tellg();
+
+        _bytes_read = 0;
+        _node = -1;
+        _remaining = 0;
+        _edges_read = 0;
+        _empty = false;
+
+        ++(*this);
     }
 
+    //! Total size of all files
+    uint64_t file_size() const {return _file_size;}
 
-    bool empty() const {
-        return _empty;
-    }
+    //! Bytes handed out by the file readers so far
+    uint64_t bytes_read() const {return _bytes_read;}
 
-    const edgeid_t& edges_read() {
-        return _edges_read;
-    }
+    //! Number of edges read so far (including the current one)
+    edgeid_t edges_read() const {return _edges_read;}
 
-private:
-    std::ifstream _is;
+    //! Number of nodes read so far (including the source of the current edge)
+    node_t nodes_read() const {return _node + 1;}
 
-    value_type _current;
-    edgeid_t _edges_read;
-    degree_t _remaining_degree;
-    bool _empty;
+//! @name STXXL Streaming Interface
+//! @{
+    bool empty() const {return _empty;}
+    const value_type & operator*() const {return _current;}
+    const value_type * operator->() const {return &_current;}
 
-    void _advance() {
+    ThrillBinaryReader& operator++() {
         assert(!_empty);
 
-        if (!_is.good()) {
-            assert(!_remaining_degree);
-            _empty = true;
-        }
-
-        while(UNLIKELY(!_remaining_degree)) {
-            if (!_is.good()) {
+        // skip nodes without (further) neighbours
+        while (!_remaining) {
+            if (!_read_varint(_remaining)) {
                 _empty = true;
-                return;
+                return *this;
             }
 
-            _remaining_degree = _get_varint();
-            _current.first++;
+            ++_node;
         }
 
+        static_assert(sizeof(node_t) == 4, "Node type is not 32 bit anymore, adjust code!");
+        node_t neighbour;
+        if (LIKELY(_end - _pos >= static_cast<ptrdiff_t>(sizeof(node_t)))) {
+            memcpy(&neighbour, _pos, sizeof(node_t));
+            _pos += sizeof(node_t);
+        } else {
+            // neighbour crosses a block boundary
+            char bytes[sizeof(node_t)];
+            for (auto& byte : bytes) {
+                uint8_t b;
+                if (!_read_byte(b))
+                    throw std::runtime_error("[ThrillBinaryReader] Unexpected end of file in " + _filename);
+                byte = static_cast<char>(b);
+            }
+            memcpy(&neighbour, bytes, sizeof(node_t));
+        }
 
-        std::uint32_t v;
-        if (!_is.read(reinterpret_cast<char*>(&v), 4)) {
-            throw std::runtime_error("I/O error while reading next neighbor");
+        --_remaining;
+        ++_edges_read;
+        _current = edge_t(_node, neighbour);
+
+        return *this;
+    }
+//! @}
+
+protected:
+    size_t _block_size;
+
+    std::string _filename;
+    std::vector<std::string> _files;
+    size_t _next_file;
+    std::unique_ptr<DirectFileReader> _reader;
+
+    //! Remainder of the current block
+    const char* _pos;
+    const char* _end;
+
+    uint64_t _file_size;
+    uint64_t _bytes_read;
+
+    node_t _node;
+    uint64_t _remaining; //!< neighbours of _node still to read
+    edgeid_t _edges_read;
+    edge_t _current;
+    bool _empty;
+
+    //! Fetches the next non-empty block, proceeding with the next file at the end of one
+    bool _next_block() {
+        DirectFileReader::Block block;
+        while (!_reader || !_reader->next(block)) {
+            _reader.reset();
+            if (_next_file == _files.size())
+                return false;
+
+            _reader.reset(new DirectFileReader(_files[_next_file++], _block_size));
         }
-        _current.second = static_cast<node_t>(v);
 
-        _remaining_degree--;
-        _edges_read++;
+        _pos = block.data;
+        _end = block.data + block.size;
+        _bytes_read += block.size;
+        return true;
+    }
+
+    bool _read_byte(uint8_t& byte) {
+        if (UNLIKELY(_pos == _end) && !_next_block())
+            return false;
+
+        byte = static_cast<uint8_t>(*_pos++);
+        return true;
     }
 
+    bool _read_varint(uint64_t& value) {
+        uint8_t byte;
+        if (!_read_byte(byte))
+            return false;
+
+        value = byte & 0x7f;
+        for (unsigned int shift = 7; byte & 0x80; shift += 7) {
+            if (shift > 63)
+                throw std::runtime_error("[ThrillBinaryReader] Invalid degree in " + _filename);
+
+            if (!_read_byte(byte))
+                throw std::runtime_error("[ThrillBinaryReader] Truncated degree in " + _filename);
+
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        }
 
-    uint64_t _get_varint() {
-        auto get_byte = [&]() -> uint8_t {
-            uint8_t result;
-            assert(_is.good());
-            _is.read(reinterpret_cast<char*>(&result), 1);
-            return result;
-        };
-
-        uint64_t u, v = get_byte();
-        if (!(v & 0x80)) return v;
-        v &= 0x7F;
-        u = get_byte(), v |= (u & 0x7F) << 7;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 14;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 21;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 28;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 35;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 42;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 49;
-        if (!(u & 0x80)) return v;
-        u = get_byte(), v |= (u & 0x7F) << 56;
-        if (!(u & 0x80)) return v;
-        u = get_byte();
-        if (u & 0xFE)
-            throw std::overflow_error("Overflow during varint64 decoding.");
-        v |= (u & 0x7F) << 63;
-        return v;
+        return true;
     }
 };
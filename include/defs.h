@@ -19,6 +19,7 @@
         #include <parallel/algorithm>
 	#include "GenericComparator.h"
 	#include "TupleHelper.h"
+	#include "PackedKey.h"
 
 	#define SEQPAR __gnu_parallel
     #else
@@ -35,6 +35,8 @@
 #include <SwapStream.h>
 #include <EdgeSwaps/ModifiedEdgeSwapTFP.h>
 #include <Utils/ExportGraph.h>
+#include <Utils/GraphFileReader.h>
+#include <Utils/SnapshotPhases.h>
 
 struct RunConfig {
     stxxl::uint64 numNodes;
@@ -52,6 +54,7 @@ struct RunConfig {
 
     InputMethod inputMethod;
     std::string inputFile;
+    std::string inputFormat;
 
     std::string snapFiles;
 
@@ -79,6 +82,10 @@ struct RunConfig {
 
     double randomSwapsInCMES;
 
+    std::string checkpointFile;
+    double checkpointInterval;
+    bool resume;
+
     RunConfig()
             : numNodes(10 * IntScale::Mi)
             , minDeg(2)
@@ -87,6 +94,7 @@ struct RunConfig {
             , scaleDegree(1.0)
 
             , inputMethod(HH)
+            , inputFormat("binary")
             , snapFiles("snapshot%p.bin")
 
             , numSwaps(0)
@@ -99,6 +107,8 @@ struct RunConfig {
             , noRuns(8)
             , edgeSizeFactor(1)
             , randomSwapsInCMES(0)
+            , checkpointInterval(3600)
+            , resume(false)
     {
         using myclock = std::chrono::high_resolution_clock;
         myclock::duration d = myclock::now() - myclock::time_point::min();
@@ -149,8 +159,14 @@ struct RunConfig {
             cp.add_string(CMDLINE_COMP('A', "snapshots-at", snapshotsAt, "comma-sep list of phases, start:stop:step as in python allows"));
 
             cp.add_string(CMDLINE_COMP('I', "input-file", inputFile, "read edge list from file"));
+            cp.add_string(CMDLINE_COMP('F', "input-format", inputFormat, "format of the input file: binary (default), thrillbin, metis, snap"));
             cp.add_string(CMDLINE_COMP('o', "snap-files", snapFiles, "path to snapshot files; %p is replace by number of phases"));
 
+            cp.add_string(CMDLINE_COMP('K', "checkpoint", checkpointFile, "write checkpoints of the randomization to this file; "
+                                                                             "switches the swaps to the sampler of runRandomSwaps (same distribution, different sequence for a seed)"));
+            cp.add_double(CMDLINE_COMP('T', "checkpoint-interval", checkpointInterval, "min. seconds between two checkpoints; default: 3600"));
+            cp.add_flag  (CMDLINE_COMP('R', "resume", resume, "resume the randomization from the checkpoint; skips the input stage"));
+
 
             if (!cp.process(argc, argv)) {
                 cp.print_usage();
@@ -179,6 +195,11 @@ struct RunConfig {
         }
 
 
+        if (resume && checkpointFile.empty()) {
+            std::cerr << "Resuming requires a checkpoint file (--checkpoint)" << std::endl;
+            return false;
+        }
+
         if (runSize > std::numeric_limits<swapid_t>::max()) {
             std::cerr << "RunSize is limited by swapid_t. Max: " << std::numeric_limits<swapid_t>::max() << std::endl;
             return false;
@@ -199,83 +220,11 @@ struct RunConfig {
     }
 
     std::string snapshotFile(unsigned int phase) {
-        std::string result(snapFiles);
-        std::string phaseStr = std::to_string(phase);
-
-        size_t index = 0;
-        while (true) {
-            index = result.find("%p", index);
-            if (index == std::string::npos)
-                break;
-
-            result.replace(index, 2, phaseStr);
-            index += phaseStr.length();
-        }
-
-        return result;
+        return snapshot_filename(snapFiles, phase);
     }
 
     std::list<uint_t> extractPhases(uint_t maxPhase) const {
-        std::string str = snapshotsAt;
-        str.erase(remove_if(str.begin(), str.end(), isspace), str.end());
-
-        size_t blockBegin = 0;
-        size_t blockEnd = 0;
-
-        std::list<uint_t> result;
-
-        while(true) {
-            // find next block
-            blockBegin = blockEnd;
-            blockEnd = str.find(',', blockBegin+1);
-            std::string block = str.substr(blockBegin, blockEnd-blockBegin);
-
-            // check if we have a range
-            const size_t firstColon = block.find(':');
-            if (firstColon == std::string::npos) {
-               if (!block.empty())
-                  result.push_back(atoll(block.c_str()));
-
-            } else {
-                const size_t secondColon = block.find(':', firstColon+1);
-
-
-                // extract block infos
-                uint_t start = firstColon ?  atoll(block.substr(0, firstColon).c_str()) : 0;
-                uint_t step = (secondColon == std::string::npos)
-                              ? 1
-                              : atoll(block.substr(secondColon+1, std::string::npos).c_str());
-
-                uint_t stop;
-                if (firstColon+1 == secondColon) {
-                    stop = maxPhase;
-                } else {
-                    if (secondColon == std::string::npos) {
-                        if (firstColon+1 == block.size()) {
-                            stop = maxPhase;
-                        } else {
-                            stop = atoll(block.substr(firstColon + 1, std::string::npos).c_str());
-                        }
-                    } else {
-                        stop = atoll(block.substr(firstColon + 1, secondColon - firstColon).c_str());
-                    }
-                }
-
-                for(uint_t i=start; i < stop; i += step)
-                    result.push_back(i);
-            }
-
-            // terminate if done
-            if (!(blockEnd < str.size()))
-                break;
-
-            blockEnd++;
-        }
-
-        result.sort();
-        result.unique();
-
-        return result;
+        return parse_phases(snapshotsAt, maxPhase);
     }
 };
 
@@ -286,7 +235,20 @@ void benchmark(RunConfig & config) {
 
     // Load or generate edge list
     EdgeStream edge_stream;
-    {
+    std::unique_ptr<EdgeSwapTFP::EdgeSwapTFP::RandomSwapsState> resume_state;
+    if (config.resume) {
+        IOStatistics read_report("Checkpoint");
+        resume_state.reset(new EdgeSwapTFP::EdgeSwapTFP::RandomSwapsState(
+            EdgeSwapTFP::EdgeSwapTFP::loadCheckpoint(config.checkpointFile, edge_stream)));
+
+        // the parameters of the interrupted execution take precedence
+        config.numNodes = resume_state->num_nodes;
+        config.numSwaps = resume_state->total_swaps;
+        config.runSize = resume_state->run_length;
+        config.factorNoSwaps = 0;
+        config.noRuns = 0;
+
+    } else {
         switch(config.inputMethod) {
             case RunConfig::InputMethod::HH: {
                 std::cout << "Graph input: Havel Hakimi" << std::endl;
@@ -365,14 +327,8 @@ void benchmark(RunConfig & config) {
             break;
             case RunConfig::InputMethod::FILE: {
                 IOStatistics read_report("Read");
-                stxxl::linuxaio_file file(config.inputFile, stxxl::file::DIRECT | stxxl::file::RDONLY);
-                stxxl::vector<edge_t> vector(&file);
-                typename decltype(vector)::bufreader_type reader(vector);
-
-                for(; !reader.empty(); ++reader)
-                    edge_stream.push(*reader);
-
-                edge_stream.consume();
+                const auto info = load_graph_file(config.inputFile, parse_graph_file_format(config.inputFormat), edge_stream);
+                config.numNodes = info.num_nodes;
             }
             break;
             default:
@@ -437,6 +393,23 @@ void benchmark(RunConfig & config) {
         if (!config.numSwaps) {
             writeSnapshots(0);
 
+        } else if (!config.checkpointFile.empty()) {
+            // checkpoints are taken between the runs of runRandomSwaps. Its per-run sampler
+            // (SortedSwapRequestGenerator) can be restarted from a checkpoint, while the state
+            // of the SwapGenerator used below is spread over the asynchronous push pipeline.
+            // Both draw uniform random swaps, but yield different swaps for the same seed.
+            std::cout << "[Checkpoint] Swaps are drawn by runRandomSwaps instead of SwapGenerator; "
+                         "results differ from a run without --checkpoint for the same seed" << std::endl;
+
+            EdgeSwapTFP::EdgeSwapTFP swap_algo(edge_stream, config.runSize, config.numNodes, config.internalMem, writeSnapshots);
+            swap_algo.setCheckpoint(config.checkpointFile, config.checkpointInterval);
+
+            IOStatistics swap_report("Randomization");
+            if (resume_state)
+                swap_algo.resumeRandomSwaps(*resume_state);
+            else
+                swap_algo.runRandomSwaps(config.numSwaps, stxxl::get_next_seed());
+
         } else  {
             SwapGenerator swap_gen(config.numSwaps, edge_stream.size(), stxxl::get_next_seed());
 
@@ -15,7 +15,7 @@
 
 #include <Utils/StreamPusher.h>
 #include <Utils/IOStatistics.h>
-#include <Utils/MonotonicPowerlawRandomStream.h>
+#include <Utils/MonotonicPowerlawRunStream.h>
 #include <Utils/NodeHash.h>
 #include <DegreeStream.h>
 #include <Utils/StreamPusherRedirectStream.h>
@@ -103,18 +103,19 @@ void benchmark(const PowerlawBenchmarkParams& config) {
 
 	HavelHakimiIMGeneratorWithDegrees hh_gen(
 		HavelHakimiIMGeneratorWithDegrees::PushDirection::DecreasingDegree);
-	MonotonicPowerlawRandomStream<false> degree_sequence(config.min_deg,
-														 config.max_deg,
-														 config.gamma,
-														 config.num_nodes,
-														 1.0,
-														 stxxl::get_next_seed());
-
-	StreamPusher<decltype(degree_sequence), decltype(hh_gen)>(degree_sequence, hh_gen);
+	MonotonicPowerlawRunStream<false> degree_sequence(config.min_deg,
+													  config.max_deg,
+													  config.gamma,
+													  config.num_nodes,
+													  1.0,
+													  stxxl::get_next_seed());
+
+	for (; !degree_sequence.empty(); ++degree_sequence)
+		hh_gen.push(degree_sequence->value, static_cast<node_t>(degree_sequence->count));
 	hh_gen.generate();
 	StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edge_stream);
 	hh_gen.finalize();
-	DegreeStream& degree_stream = hh_gen.get_degree_stream();
+	RLEDegreeStream& degree_stream = hh_gen.get_degree_stream();
 
 	hh_report.report("HHEdges");
 
@@ -11,6 +11,8 @@
 #include <EdgeStream.h>
 
 #include <Utils/IOStatistics.h>
+#include <Utils/Progress.h>
+#include <Utils/Telemetry.h>
 
 #include <Utils/MonotonicPowerlawRandomStream.h>
 #include <HavelHakimi/HavelHakimiIMGenerator.h>
@@ -61,6 +63,15 @@ struct RunConfig {
 
     unsigned int edgeSizeFactor;
 
+    bool adaptiveMemory;
+    unsigned int hubDegree;
+    bool sortedSwaps;
+
+    std::string traceFilename;
+
+    double progressInterval;
+    std::string progressFilename;
+
     RunConfig()
         : numNodes(10 * IntScale::Mi)
         , minDeg(2)
@@ -80,6 +91,12 @@ struct RunConfig {
         , snapshots(true)
         , frequency(0)
         , edgeSizeFactor(10)
+        , adaptiveMemory(false)
+        , hubDegree(0)
+        , sortedSwaps(false)
+        , traceFilename("")
+        , progressInterval(0.0)
+        , progressFilename("")
     {
         using myclock = std::chrono::high_resolution_clock;
         myclock::duration d = myclock::now() - myclock::time_point::min();
@@ -125,6 +142,12 @@ struct RunConfig {
             cp.add_flag(CMDLINE_COMP('z', "snapshots", snapshots, "Write thrillbin file every frequency-times"));
             cp.add_uint  (CMDLINE_COMP('f', "frequency",      frequency,   "Frequency for snapshots"));
             cp.add_uint  (CMDLINE_COMP('w', "edge-size-factor",  edgeSizeFactor ,   "Swap number equals # * edge_stream"));
+            cp.add_flag  (CMDLINE_COMP('t', "adaptive-mem", adaptiveMemory, "TFP: Re-balance memory between runs based on observed volumes"));
+            cp.add_uint  (CMDLINE_COMP('u', "hub-degree", hubDegree, "TFP: Answer existence requests to edges of nodes with at least this degree in RAM (0 = off)"));
+            cp.add_flag  (CMDLINE_COMP('o', "sorted-swaps", sortedSwaps, "TFP: Generate swap requests in edge id order instead of sorting them"));
+            cp.add_string(CMDLINE_COMP('T', "trace", traceFilename, "Record phase telemetry into this file; Chrome trace, or JSONL if the name ends with .jsonl"));
+            cp.add_double(CMDLINE_COMP('P', "progress", progressInterval, "Report progress, throughput, I/O bandwidth and memory every this many seconds; default: off"));
+            cp.add_string(CMDLINE_COMP('F', "progress-file", progressFilename, "Overwrite this status file with the latest progress report instead of printing to stderr (requires --progress)"));
 
 
             if (!cp.process(argc, argv)) {
@@ -246,10 +269,16 @@ void benchmark(RunConfig & config) {
                 const swapid_t runSize = edge_stream.size() / 8;
 
                 EdgeSwapTFP::EdgeSwapTFP swap_algo(edge_stream, runSize, config.numNodes, config.internalMem);
+                swap_algo.setAdaptiveMemory(config.adaptiveMemory);
+                swap_algo.setHubExistenceIndex(config.hubDegree);
                 {
                     IOStatistics swap_report("SwapStats");
-                    StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
-                    swap_algo.run();
+                    if (config.sortedSwaps) {
+                        swap_algo.runRandomSwaps(config.numSwaps, stxxl::get_next_seed());
+                    } else {
+                        StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
+                        swap_algo.run();
+                    }
                 }
 
                 edge_stream.consume();
@@ -298,6 +327,12 @@ int main(int argc, char* argv[]) {
     stxxl::srandom_number32(config.randomSeed);
     stxxl::set_seed(config.randomSeed);
 
+    if (!config.traceFilename.empty())
+        Telemetry::get_instance().open(config.traceFilename);
+
+    if (config.progressInterval > 0)
+        Progress::get_instance().start(config.progressInterval, config.progressFilename);
+
     benchmark(config);
     std::cout << "Maximum EM allocation: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
 
@@ -17,6 +17,8 @@ enum OutputFileType {
 };
 
 #include <Utils/RandomSeed.h>
+#include <Utils/Progress.h>
+#include <Utils/Telemetry.h>
 
 
 class RunConfig {
@@ -56,6 +58,7 @@ public:
   unsigned int randomSeed;
 
   std::string output_filename, partition_filename;
+  std::string checkpoint_save_filename, checkpoint_load_filename;
   std::string output_filetype;
   OutputFileType outputFileType = METIS;
 
@@ -68,6 +71,16 @@ public:
 
   double community_rewiring_random;
 
+  bool verify;
+  std::string verify_filename;
+
+  std::string trace_filename;
+
+  double progress_interval;
+  std::string progress_filename;
+
+  bool internal_memory;
+
   RunConfig() :
 	  number_of_nodes      (100000),
 	  number_of_communities( 10000),
@@ -85,7 +98,10 @@ public:
 	  lfr_bench_rounds(100),
 	  lfr_bench_comassign(false),
 	  lfr_bench_comassign_retry(false),
-	  community_rewiring_random(1.0)
+	  community_rewiring_random(1.0),
+	  verify(false),
+	  progress_interval(0.0),
+	  internal_memory(false)
   {
 	  using myclock = std::chrono::high_resolution_clock;
 	  myclock::duration d = myclock::now() - myclock::time_point::min();
@@ -132,6 +148,15 @@ public:
 	  cp.add_flag(CMDLINE_COMP('f', "lfr-comassign-retry", lfr_bench_comassign_retry, "Perform LFR comassign retry benchmark"));
 	  cp.add_string(CMDLINE_COMP('t', "output-filetype", output_filetype, "Output filetype; METIS, THRILLBIN, ..."));
 
+	  cp.add_string(CMDLINE_COMP('w', "save-checkpoint", checkpoint_save_filename, "Store node degrees, community sizes and the community assignment in this file; the graph then differs from a run without checkpoint for the same seed"));
+	  cp.add_flag(CMDLINE_COMP('q', "internal-memory", internal_memory, "Generate the community and global graphs in internal memory (faster for instances that fit into the memory budget)"));
+	  cp.add_flag(CMDLINE_COMP('v', "verify", verify, "Verify the generated graph in parallel and print a JSON report; exits with 1 if it fails"));
+	  cp.add_string(CMDLINE_COMP('g', "verify-report", verify_filename, "Write the JSON verification report into this file instead of stdout (implies --verify)"));
+	  cp.add_string(CMDLINE_COMP('T', "trace", trace_filename, "Record phase telemetry into this file; Chrome trace, or JSONL if the name ends with .jsonl"));
+	  cp.add_double(CMDLINE_COMP('P', "progress", progress_interval, "Report progress, throughput, I/O bandwidth and memory every this many seconds; default: off"));
+	  cp.add_string(CMDLINE_COMP('F', "progress-file", progress_filename, "Overwrite this status file with the latest progress report instead of printing to stderr (requires --progress)"));
+	  cp.add_string(CMDLINE_COMP('u', "load-checkpoint", checkpoint_load_filename, "Restore node degrees, community sizes and the community assignment from this file (e.g. to sweep over the mixing parameter); overrides the degree and community parameters except for the number of nodes"));
+
 	  assert(number_of_communities < std::numeric_limits<community_t>::max());
 
 	  if (!cp.process(argc, argv)) {
@@ -176,6 +201,9 @@ public:
 	}
 
 
+	  if (!verify_filename.empty())
+		  verify = true;
+
 	  cp.print_result();
 
 	  _update_structs();
@@ -205,6 +233,12 @@ int main(int argc, char* argv[]) {
 	stxxl::set_seed(config.randomSeed);
 	RandomSeed::get_instance().seed(config.randomSeed);
 
+	if (!config.trace_filename.empty())
+		Telemetry::get_instance().open(config.trace_filename);
+
+	if (config.progress_interval > 0)
+		Progress::get_instance().start(config.progress_interval, config.progress_filename);
+
 	LFR::LFR lfr(config.node_distribution_param,
 				 config.community_distribution_param,
 				 config.mixing,
@@ -218,6 +252,17 @@ int main(int argc, char* argv[]) {
 
 	lfr.setCommunityRewiringRandom(config.community_rewiring_random);
 
+	if (!config.checkpoint_save_filename.empty())
+		lfr.setCheckpointSave(config.checkpoint_save_filename);
+
+	if (!config.checkpoint_load_filename.empty())
+		lfr.setCheckpointLoad(config.checkpoint_load_filename);
+
+	lfr.setInternalMemory(config.internal_memory);
+
+	// non-zero if the verification fails; the graph is exported nonetheless
+	int exit_code = 0;
+
 	if (config.lfr_bench_comassign) {
 		LFR::LFRCommunityAssignBenchmark bench(lfr);
 		bench.computeDistribution(config.lfr_bench_rounds);
@@ -227,6 +272,21 @@ int main(int argc, char* argv[]) {
 	} else {
 		lfr.run();
 
+		if (config.verify) {
+			const auto report = lfr.verify_graph();
+			if (config.verify_filename.empty()) {
+				report.write_json(std::cout);
+			} else {
+				std::ofstream report_stream(config.verify_filename, std::ios::trunc);
+				report.write_json(report_stream);
+			}
+
+			if (!report.valid()) {
+				std::cerr << "Verification of the generated graph failed" << std::endl;
+				exit_code = 1;
+			}
+		}
+
 		if (!config.output_filename.empty()) {
 			lfr.get_edges().rewind();
 
@@ -264,5 +324,5 @@ int main(int argc, char* argv[]) {
 
     std::cout << "Maximum EM allocation: " <<  stxxl::block_manager::get_instance()->get_maximum_allocation() << std::endl;
 
-	return 0;
+	return exit_code;
 }
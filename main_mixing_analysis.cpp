@@ -0,0 +1,214 @@
+/**
+ * @file main_mixing_analysis.cpp
+ * @brief Mixing quality of a randomisation chain from its snapshots
+ *
+ * Reads snapshots as written by benchmark (-A/-o) via export_as_thrillbin_sorted
+ * and merges them in a single streaming pass. It reports
+ *  - per snapshot: the number of edges, the fraction of edges shared with the
+ *    first snapshot and the degree assortativity,
+ *  - per thinning k: the mean lag-k autocorrelation of the edge indicators and
+ *    the fraction of edges whose k-thinned indicator series is classified as
+ *    non-independent (see MixingStatistics.h).
+ * With -c, the thinnings are also expressed in seconds, which allows to compare
+ * engines by the randomisation achieved per (CPU) second.
+ *
+ * Apart from one file buffer per snapshot, only the node degrees are kept in RAM.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+#include <list>
+
+#include <stxxl/cmdline>
+
+#include <defs.h>
+#include <MixingStatistics.h>
+#include <Utils/ThrillBinaryReader.h>
+#include <Utils/SnapshotPhases.h>
+#include <Utils/ScopedTimer.hpp>
+
+struct RunConfig {
+    std::string snapFiles;
+    std::string snapshotsAt;
+    unsigned int maxPhase;
+
+    unsigned int maxThinning;
+    double secondsPerPhase;
+
+    RunConfig()
+        : snapFiles("snapshot%p.bin")
+        , snapshotsAt("0:")
+        , maxPhase(1000)
+        , maxThinning(16)
+        , secondsPerPhase(0.0)
+    {}
+
+#if STXXL_VERSION_INTEGER > 10401
+#define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, dest, args
+#else
+    #define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, args, dest
+#endif
+
+    bool parse_cmdline(int argc, char* argv[]) {
+        stxxl::cmdline_parser cp;
+
+        cp.add_string(CMDLINE_COMP('o', "snap-files",   snapFiles,   "path to snapshot files; %p is replace by number of phases"));
+        cp.add_string(CMDLINE_COMP('A', "snapshots-at", snapshotsAt, "comma-sep list of phases, start:stop:step as in python allows; missing snapshots are skipped"));
+        cp.add_uint  (CMDLINE_COMP('m', "max-phase",    maxPhase,    "End of open ranges in -A; default: 1000"));
+        cp.add_uint  (CMDLINE_COMP('k', "max-thinning", maxThinning, "Largest thinning (in snapshots) to analyse; default: 16"));
+        cp.add_double(CMDLINE_COMP('c', "seconds-per-phase", secondsPerPhase, "Run time of a phase, e.g. CPU seconds per run; adds a seconds column"));
+
+        if (!cp.process(argc, argv)) {
+            cp.print_usage();
+            return false;
+        }
+
+        if (!maxThinning) {
+            std::cerr << "The maximal thinning has to be positive" << std::endl;
+            return false;
+        }
+
+        cp.print_result();
+        return true;
+    }
+};
+
+void analyse(const RunConfig & config) {
+    // select snapshots
+    std::vector<uint_t> phases;
+    for (const auto phase : parse_phases(config.snapshotsAt, config.maxPhase)) {
+        if (ThrillBinaryReader::exists(snapshot_filename(config.snapFiles, phase)))
+            phases.push_back(phase);
+    }
+
+    if (phases.size() < 2)
+        throw std::runtime_error("At least two snapshots are required");
+
+    const unsigned int num_snapshots = phases.size();
+    const uint_t phase_distance = phases[1] - phases[0];
+    for (unsigned int t = 1; t < num_snapshots; ++t) {
+        if (phases[t] - phases[t - 1] != phase_distance) {
+            std::cout << "[Warning] Snapshots are not equidistant; the lag columns assume "
+                      << phase_distance << " phases between snapshots" << std::endl;
+            break;
+        }
+    }
+
+    std::cout << "Analyse " << num_snapshots << " snapshots from phase " << phases.front()
+              << " to phase " << phases.back() << std::endl;
+
+    // degrees are invariant under randomisation, so it suffices to read them once
+    std::vector<degree_t> degrees;
+    {
+        ScopedTimer timer("Degrees");
+        for (ThrillBinaryReader reader(snapshot_filename(config.snapFiles, phases[0])); !reader.empty(); ++reader) {
+            const node_t max_node = std::max(reader->first, reader->second);
+            if (static_cast<size_t>(max_node) >= degrees.size())
+                degrees.resize(max_node + 1, 0);
+
+            degrees[reader->first]++;
+            degrees[reader->second]++;
+        }
+    }
+
+    std::vector<std::unique_ptr<ThrillBinaryReader>> readers;
+    for (const auto phase : phases)
+        readers.emplace_back(new ThrillBinaryReader(snapshot_filename(config.snapFiles, phase), 1llu << 20));
+
+    const unsigned int max_thinning = std::min(config.maxThinning, num_snapshots - 1);
+    EdgeIndicatorStatistics indicator_stats(num_snapshots, max_thinning);
+    std::vector<DegreeAssortativity> assortativity(num_snapshots);
+    std::vector<uint64_t> num_edges(num_snapshots, 0);
+    std::vector<uint64_t> num_shared(num_snapshots, 0);
+
+    auto degree = [&degrees] (const node_t u) -> degree_t {
+        return static_cast<size_t>(u) < degrees.size() ? degrees[u] : 0;
+    };
+
+    // merge all snapshots; each edge of their union is handled once
+    {
+        ScopedTimer timer("Merge");
+        std::vector<uint8_t> presence(num_snapshots);
+
+        while (true) {
+            bool found = false;
+            edge_t edge;
+            for (const auto & reader : readers) {
+                if (!reader->empty() && (!found || **reader < edge)) {
+                    edge = **reader;
+                    found = true;
+                }
+            }
+
+            if (!found)
+                break;
+
+            for (unsigned int t = 0; t < num_snapshots; ++t) {
+                auto & reader = *readers[t];
+                presence[t] = !reader.empty() && *reader == edge;
+
+                // multi-edges count as a single occurrence
+                while (!reader.empty() && *reader == edge)
+                    ++reader;
+            }
+
+            indicator_stats.push(presence);
+
+            for (unsigned int t = 0; t < num_snapshots; ++t) {
+                if (!presence[t])
+                    continue;
+
+                num_edges[t]++;
+                num_shared[t] += presence[0];
+                assortativity[t].push(degree(edge.first), degree(edge.second));
+            }
+        }
+    }
+
+    std::cout << "Union of all snapshots contains " << indicator_stats.num_edges() << " edges, "
+              << indicator_stats.num_varying_edges() << " of which are not in every snapshot\n";
+
+    std::cout << std::setprecision(6);
+
+    std::cout << "\n# Trajectory\n"
+                 "phase,edges,shared_with_first,assortativity\n";
+    for (unsigned int t = 0; t < num_snapshots; ++t) {
+        std::cout << phases[t] << ","
+                  << num_edges[t] << ","
+                  << (num_edges[0] ? static_cast<double>(num_shared[t]) / num_edges[0] : 0.0) << ","
+                  << assortativity[t].value() << "\n";
+    }
+
+    std::cout << "\n# Mixing\n"
+                 "thinning,phase_lag,seconds,mean_autocorrelation,non_independent_fraction\n";
+    for (unsigned int k = 1; k <= max_thinning; ++k) {
+        std::cout << k << ","
+                  << k * phase_distance << ","
+                  << k * phase_distance * config.secondsPerPhase << ","
+                  << indicator_stats.mean_autocorrelation(k) << ","
+                  << indicator_stats.non_independent_fraction(k) << "\n";
+    }
+
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[]) {
+    // nice to have in logs to restart it easier
+    for(int i=0; i < argc; ++i)
+        std::cout << argv[i] << " ";
+    std::cout << std::endl;
+
+    RunConfig config;
+    if (!config.parse_cmdline(argc, argv))
+        return -1;
+
+    analyse(config);
+
+    return 0;
+}
@@ -20,7 +20,7 @@
 #include <Utils/IOStatistics.h>
 #include <Utils/ScopedTimer.hpp>
 
-#include <Utils/MonotonicPowerlawRandomStream.h>
+#include <Utils/MonotonicPowerlawRunStream.h>
 #include <HavelHakimi/HavelHakimiIMGenerator.h>
 #include <Utils/StreamPusher.h>
 #include <Utils/EdgeToEdgeSwapPusher.h>
@@ -230,8 +230,10 @@ void generate(RunConfig & config) {
 
 				// prepare generator
 				HavelHakimiIMGenerator hh_gen(HavelHakimiIMGenerator::PushDirection::DecreasingDegree);
-				MonotonicPowerlawRandomStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
-				StreamPusher<decltype(degreeSequence), decltype(hh_gen)>(degreeSequence, hh_gen);
+				// push runs of equal degrees at once
+				MonotonicPowerlawRunStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
+				for (; !degreeSequence.empty(); ++degreeSequence)
+					hh_gen.push(degreeSequence->value, static_cast<node_t>(degreeSequence->count));
 				hh_gen.generate();
 
 				StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edge_stream);
@@ -245,8 +247,10 @@ void generate(RunConfig & config) {
 
 				// prepare generator
 				HavelHakimiIMGenerator hh_gen(HavelHakimiIMGenerator::PushDirection::DecreasingDegree);
-				MonotonicPowerlawRandomStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
-				StreamPusher<decltype(degreeSequence), decltype(hh_gen)>(degreeSequence, hh_gen);
+				// push runs of equal degrees at once
+				MonotonicPowerlawRunStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
+				for (; !degreeSequence.empty(); ++degreeSequence)
+					hh_gen.push(degreeSequence->value, static_cast<node_t>(degreeSequence->count));
 				hh_gen.generate();
 
 				ConfigurationModelRandom<HavelHakimiIMGenerator> cmhh_gen(hh_gen);
@@ -0,0 +1,605 @@
+/**
+ * @file main_swap_benchmark.cpp
+ * @brief Common benchmark driver for all graph randomisation engines
+ *
+ * The input graph is generated (Havel-Hakimi or CMES) or read from a binary
+ * edge list exactly once. Afterwards every selected algorithm is run on a
+ * fresh copy of it with equivalent mixing effort, i.e. x*|E| swaps for the
+ * edge swap algorithms and ceil(x) global trades for EM-Curveball (unless
+ * set explicitly). Copying the input is not part of the measurement.
+ *
+ * Each run yields one CSV row with the columns
+ *   algo, input, nodes, edges, ops, op, repetition, warmup, seconds,
+ *   ops_per_s, io_reads, io_writes, io_read_bytes, io_written_bytes,
+ *   em_cumulative_peak_bytes, rss_cumulative_peak_bytes
+ * where op is "swaps" or "trades". The I/O columns cover the run only. Neither
+ * STXXL nor getrusage can reset their maxima, so both peak columns are cumulative:
+ * they hold the process-wide maxima observed up to the end of the run including
+ * all earlier runs and the input generation. For per-configuration peaks, invoke
+ * the benchmark once per algorithm and repetition and append to the same file, e.g.
+ *   for a in TFP IM; do main_swap_benchmark -e $a -R 1 -o runs.csv ...; done
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <algorithm>
+#include <locale>
+
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <omp.h>
+
+#include <stxxl/cmdline>
+#include <stxxl/sorter>
+#include <stxxl/vector>
+
+#include <EdgeStream.h>
+#include <DegreeStream.h>
+#include <GenericComparator.h>
+
+#include <Utils/IOStatistics.h>
+#include <Utils/ScopedTimer.hpp>
+#include <Utils/Telemetry.h>
+
+#include <Utils/MonotonicPowerlawRandomStream.h>
+#include <Utils/MonotonicUniformRandomStream.h>
+#include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <Utils/StreamPusher.h>
+#include <Utils/EdgeToEdgeSwapPusher.h>
+
+#include "SwapGenerator.h"
+
+#include <ConfigurationModel/ConfigurationModelRandom.h>
+#include <EdgeSwaps/EdgeSwapTFP.h>
+#include <EdgeSwaps/EdgeSwapParallelTFP.h>
+#include <EdgeSwaps/ModifiedEdgeSwapTFP.h>
+#include <EdgeSwaps/SemiLoadedEdgeSwapTFP.h>
+#include <EdgeSwaps/IMEdgeSwap.h>
+#include <Curveball/EMCurveball.h>
+#include <Utils/NodeHash.h>
+
+enum class RandomizationAlgo {
+    TFP,
+    PTFP,
+    MTFP,       // ModifiedEdgeSwapTFP
+    SEMILOADED, // SemiLoadedEdgeSwapTFP
+    IM,
+    CURVEBALL
+};
+
+struct RunConfig {
+    stxxl::uint64 numNodes;
+    stxxl::uint64 minDeg;
+    stxxl::uint64 maxDeg;
+    double gamma;
+    double scaleDegree;
+
+    enum InputMethod {
+        HH,
+        CMES,
+        FILE
+    };
+
+    InputMethod inputMethod;
+    std::string inputFile;
+
+    std::string algoNames;
+    std::vector<RandomizationAlgo> algos;
+
+    double factorNoSwaps;
+    unsigned int noRuns;
+    unsigned int numRounds;
+
+    stxxl::uint64 internalMem;
+    int numThreads;
+
+    bool adaptiveMemory;
+    unsigned int hubDegree;
+    bool sortedSwaps;
+
+    unsigned int randomSeed;
+    unsigned int degreeDistrSeed;
+
+    double randomSwapsInCMES;
+
+    unsigned int warmups;
+    unsigned int repetitions;
+
+    std::string csvFilename;
+    std::string traceFilename;
+
+    RunConfig()
+            : numNodes(10 * IntScale::Mi)
+            , minDeg(2)
+            , maxDeg(100000)
+            , gamma(2.0)
+            , scaleDegree(1.0)
+
+            , inputMethod(HH)
+            , algoNames("TFP")
+
+            , factorNoSwaps(1)
+            , noRuns(8)
+            , numRounds(0)
+
+            , internalMem(8 * IntScale::Gi)
+            , numThreads(omp_get_max_threads())
+
+            , adaptiveMemory(false)
+            , hubDegree(0)
+            , sortedSwaps(false)
+
+            , randomSwapsInCMES(0)
+
+            , warmups(0)
+            , repetitions(1)
+    {
+        using myclock = std::chrono::high_resolution_clock;
+        myclock::duration d = myclock::now() - myclock::time_point::min();
+        randomSeed = d.count();
+        degreeDistrSeed = 123456789 * randomSeed;
+    }
+
+#if STXXL_VERSION_INTEGER > 10401
+#define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, dest, args
+#else
+    #define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, args, dest
+#endif
+
+    bool parse_cmdline(int argc, char* argv[]) {
+        stxxl::cmdline_parser cp;
+        bool input_cm = false;
+
+        // setup and gather parameters
+        {
+            cp.add_bytes (CMDLINE_COMP('n', "num-nodes",    numNodes,        "Generate # nodes, Default: 10 Mi"));
+            cp.add_bytes (CMDLINE_COMP('a', "min-deg",      minDeg,          "Min. Deg of Powerlaw Deg. Distr."));
+            cp.add_bytes (CMDLINE_COMP('b', "max-deg",      maxDeg,          "Max. Deg of Powerlaw Deg. Distr."));
+            cp.add_double(CMDLINE_COMP('g', "gamma",        gamma,           "Minus Gamma of Powerlaw Deg. Distr.; default: 2"));
+            cp.add_double(CMDLINE_COMP('d', "scale-degree", scaleDegree,     "ScaleDegree of PWL-Distr"));
+            cp.add_uint  (CMDLINE_COMP('s', "seed",         randomSeed,      "Initial seed for PRNG"));
+            cp.add_uint  (CMDLINE_COMP('S', "degree-seed",  degreeDistrSeed, "Initial seed for PRNG of degree distr"));
+
+            cp.add_flag  (CMDLINE_COMP('c', "input-cm",    input_cm,          "use Configuration Model + Rewiring instead of Havel Hakimi"));
+            cp.add_double(CMDLINE_COMP('C', "cmes-random", randomSwapsInCMES, "Include X*|E| random swaps during CMES rewiring steps; default: 0"));
+            cp.add_string(CMDLINE_COMP('I', "input-file",  inputFile,         "read edge list from file"));
+
+            cp.add_string(CMDLINE_COMP('e', "algos", algoNames, "Comma-separated list of TFP, PTFP, MTFP, SEMILOADED, IM, CURVEBALL; default: TFP"));
+
+            cp.add_double(CMDLINE_COMP('x', "factor-swaps", factorNoSwaps, "Mixing effort: perform x*|E| swaps; default: 1"));
+            cp.add_uint  (CMDLINE_COMP('y', "no-runs",      noRuns,        "Swaps per graph scan are #swaps / y + 1; default: 8"));
+            cp.add_uint  (CMDLINE_COMP('G', "global-trades", numRounds,    "Number of global trades of Curveball; default: ceil(x)"));
+
+            cp.add_bytes (CMDLINE_COMP('i', "ram",         internalMem, "Internal memory"));
+            cp.add_int   (CMDLINE_COMP('t', "num-threads", numThreads,  "Number of threads of Curveball"));
+
+            cp.add_flag  (CMDLINE_COMP('A', "adaptive-mem", adaptiveMemory, "TFP, SEMILOADED: Re-balance memory between runs based on observed volumes"));
+            cp.add_uint  (CMDLINE_COMP('u', "hub-degree",   hubDegree,      "TFP: Answer existence requests to edges of nodes with at least this degree in RAM; default: 0 (off)"));
+            cp.add_flag  (CMDLINE_COMP('O', "sorted-swaps", sortedSwaps,    "TFP: Generate swap requests in edge id order instead of sorting them"));
+
+            cp.add_uint  (CMDLINE_COMP('W', "warmups",     warmups,     "Unreported runs per algorithm before the measurement; default: 0"));
+            cp.add_uint  (CMDLINE_COMP('R', "repetitions", repetitions, "Measured runs per algorithm; default: 1"));
+
+            cp.add_string(CMDLINE_COMP('o', "csv",   csvFilename,   "Append the CSV rows to this file instead of printing them"));
+            cp.add_string(CMDLINE_COMP('T', "trace", traceFilename, "Record phase telemetry into this file; Chrome trace, or JSONL if the name ends with .jsonl"));
+
+            if (!cp.process(argc, argv)) {
+                cp.print_usage();
+                return false;
+            }
+        }
+
+        // select input stage
+        {
+            if (input_cm && !inputFile.empty()) {
+                std::cerr << "Can enable either CMES or File; not both" << std::endl;
+                return false;
+            }
+
+            if (input_cm) {inputMethod = CMES;}
+            else if (!inputFile.empty()) {inputMethod = FILE;}
+            else {inputMethod = HH;}
+        }
+
+        // select algorithms
+        {
+            std::string names(algoNames);
+            std::transform(names.begin(), names.end(), names.begin(), ::toupper);
+            names.erase(remove_if(names.begin(), names.end(), isspace), names.end());
+
+            std::stringstream ss(names);
+            std::string name;
+            while (std::getline(ss, name, ',')) {
+                if      (name == "TFP")        { algos.push_back(RandomizationAlgo::TFP); }
+                else if (name == "PTFP")       { algos.push_back(RandomizationAlgo::PTFP); }
+                else if (name == "MTFP")       { algos.push_back(RandomizationAlgo::MTFP); }
+                else if (name == "SEMILOADED") { algos.push_back(RandomizationAlgo::SEMILOADED); }
+                else if (name == "IM")         { algos.push_back(RandomizationAlgo::IM); }
+                else if (name == "CURVEBALL")  { algos.push_back(RandomizationAlgo::CURVEBALL); }
+                else if (!name.empty()) {
+                    std::cerr << "Invalid randomisation algorithm specified: " << name << std::endl;
+                    cp.print_usage();
+                    return false;
+                }
+            }
+
+            if (algos.empty()) {
+                std::cerr << "No randomisation algorithm selected" << std::endl;
+                return false;
+            }
+        }
+
+        if (!repetitions) {
+            std::cerr << "At least one repetition is required" << std::endl;
+            return false;
+        }
+
+        if (factorNoSwaps <= 0.0) {
+            std::cerr << "The swap factor has to be positive" << std::endl;
+            return false;
+        }
+
+        if (scaleDegree * minDeg < 1.0) {
+            std::cerr << "Scaling the minimum degree must yield at least 1.0" << std::endl;
+            return false;
+        }
+
+        if (gamma <= 1.0) {
+            std::cerr << "Gamma has to be at least 1.0" << std::endl;
+            return false;
+        }
+
+        cp.print_result();
+        return true;
+    }
+};
+
+static const char* algo_name(RandomizationAlgo algo) {
+    switch (algo) {
+        case RandomizationAlgo::TFP:        return "TFP";
+        case RandomizationAlgo::PTFP:       return "PTFP";
+        case RandomizationAlgo::MTFP:       return "MTFP";
+        case RandomizationAlgo::SEMILOADED: return "SEMILOADED";
+        case RandomizationAlgo::IM:         return "IM";
+        case RandomizationAlgo::CURVEBALL:  return "CURVEBALL";
+    }
+    return "";
+}
+
+//! Generates or reads the input graph according to the config
+static void load_input(const RunConfig & config, EdgeStream & edge_stream) {
+    switch(config.inputMethod) {
+        case RunConfig::InputMethod::HH: {
+            std::cout << "Graph input: Havel Hakimi" << std::endl;
+            IOStatistics hh_report("HHEdges");
+
+            HavelHakimiIMGenerator hh_gen(HavelHakimiIMGenerator::PushDirection::DecreasingDegree);
+            MonotonicPowerlawRandomStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
+            StreamPusher<decltype(degreeSequence), decltype(hh_gen)>(degreeSequence, hh_gen);
+            hh_gen.generate();
+
+            StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edge_stream);
+            edge_stream.consume();
+            break;
+        }
+
+        case RunConfig::InputMethod::CMES: {
+            std::cout << "Graph input: CMES" << std::endl;
+            IOStatistics cm_report("CMES");
+
+            HavelHakimiIMGenerator hh_gen(HavelHakimiIMGenerator::PushDirection::DecreasingDegree);
+            MonotonicPowerlawRandomStream<false> degreeSequence(config.minDeg, config.maxDeg, -1.0 * config.gamma, config.numNodes, config.scaleDegree, config.degreeDistrSeed);
+            StreamPusher<decltype(degreeSequence), decltype(hh_gen)>(degreeSequence, hh_gen);
+            hh_gen.generate();
+
+            ConfigurationModelRandom<HavelHakimiIMGenerator> cmhh_gen(hh_gen);
+            cmhh_gen.run();
+
+            ModifiedEdgeSwapTFP::ModifiedEdgeSwapTFP init_algo(edge_stream, config.numNodes / 10 + 1, config.numNodes, config.internalMem);
+
+            EdgeToEdgeSwapPusher<decltype(cmhh_gen), EdgeStream, ModifiedEdgeSwapTFP::ModifiedEdgeSwapTFP>
+                    cm_to_emes_pusher(cmhh_gen, edge_stream, init_algo);
+            edge_stream.consume();
+
+            const edgeid_t min_swaps = edge_stream.size() * config.randomSwapsInCMES;
+
+            while (init_algo.runnable()) {
+                if (init_algo.swaps_pushed() < min_swaps * 0.75) {
+                    const swapid_t additional_swaps = min_swaps - init_algo.swaps_pushed();
+                    SwapGenerator swap_gen(additional_swaps, edge_stream.size(), stxxl::get_next_seed());
+                    StreamPusher<decltype(swap_gen), decltype(init_algo)>(swap_gen, init_algo);
+                }
+
+                init_algo.run();
+            }
+            break;
+        }
+
+        case RunConfig::InputMethod::FILE: {
+            std::cout << "Graph input: " << config.inputFile << std::endl;
+            IOStatistics read_report("Read");
+
+            stxxl::linuxaio_file file(config.inputFile, stxxl::file::DIRECT | stxxl::file::RDONLY);
+            stxxl::vector<edge_t> vector(&file);
+            typename decltype(vector)::bufreader_type reader(vector);
+
+            for(; !reader.empty(); ++reader)
+                edge_stream.push(*reader);
+
+            edge_stream.consume();
+            break;
+        }
+    }
+}
+
+/**
+ * Computes the degree of each node as required by EM-Curveball; nodes without
+ * edges up to num_nodes get degree zero. Returns the number of nodes, which
+ * exceeds num_nodes if the graph contains larger node ids.
+ */
+static node_t compute_degrees(EdgeStream & edges, RLEDegreeStream & degrees, const node_t num_nodes) {
+    using NodeComparator = GenericComparator<node_t>::Ascending;
+    stxxl::sorter<node_t, NodeComparator> endpoints(NodeComparator(), SORTER_MEM);
+
+    for (edges.rewind(); !edges.empty(); ++edges) {
+        endpoints.push(edges->first);
+        endpoints.push(edges->second);
+    }
+    edges.rewind();
+    endpoints.sort();
+
+    node_t next_node = 0;
+    while (!endpoints.empty()) {
+        const node_t u = *endpoints;
+        degree_t degree = 0;
+        for (; !endpoints.empty() && *endpoints == u; ++endpoints)
+            ++degree;
+
+        degrees.push(0, u - next_node);
+        degrees.push(degree);
+        next_node = u + 1;
+    }
+
+    if (next_node < num_nodes) {
+        degrees.push(0, num_nodes - next_node);
+        next_node = num_nodes;
+    }
+
+    degrees.rewind();
+    return next_node;
+}
+
+static void copy_edges(EdgeStream & in, EdgeStream & out) {
+    for (in.rewind(); !in.empty(); ++in)
+        out.push(*in);
+
+    in.rewind();
+    out.consume();
+}
+
+/**
+ * Randomises edges with the given algorithm and returns the number of
+ * operations (swaps or trades) performed.
+ */
+static uint64_t run_algo(const RunConfig & config, const RandomizationAlgo algo,
+                         EdgeStream & edges, RLEDegreeStream & degrees, const node_t num_nodes) {
+    const uint64_t num_swaps = static_cast<uint64_t>(edges.size() * config.factorNoSwaps);
+    const swapid_t run_size = static_cast<swapid_t>(std::min<uint64_t>(
+        num_swaps / std::max(1u, config.noRuns) + 1, std::numeric_limits<swapid_t>::max() / 2));
+
+    SwapGenerator swap_gen(num_swaps, edges.size(), stxxl::get_next_seed());
+
+    switch (algo) {
+        case RandomizationAlgo::TFP: {
+            EdgeSwapTFP::EdgeSwapTFP swap_algo(edges, run_size, num_nodes, config.internalMem);
+            swap_algo.setAdaptiveMemory(config.adaptiveMemory);
+            swap_algo.setHubExistenceIndex(config.hubDegree);
+            if (config.sortedSwaps) {
+                swap_algo.runRandomSwaps(num_swaps, stxxl::get_next_seed());
+            } else {
+                StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
+                swap_algo.run();
+            }
+            return num_swaps;
+        }
+
+        case RandomizationAlgo::PTFP: {
+            EdgeSwapParallelTFP::EdgeSwapParallelTFP swap_algo(edges, run_size);
+            StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
+            swap_algo.run();
+            return num_swaps;
+        }
+
+        case RandomizationAlgo::MTFP: {
+            ModifiedEdgeSwapTFP::ModifiedEdgeSwapTFP swap_algo(edges, run_size, num_nodes, config.internalMem);
+            StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
+            while (swap_algo.runnable())
+                swap_algo.run();
+            return num_swaps;
+        }
+
+        case RandomizationAlgo::SEMILOADED: {
+            // the first edge of each swap is loaded in a scan over uniformly drawn sorted edge ids
+            const edgeid_t num_edges = edges.size();
+            EdgeStream loaded_edges;
+            {
+                MonotonicUniformRandomStream<true> positions(num_swaps, stxxl::get_next_seed());
+                edgeid_t eid = 0;
+                for (; !positions.empty(); ++positions) {
+                    const edgeid_t target = std::min<edgeid_t>(num_edges - 1, static_cast<edgeid_t>(*positions * num_edges));
+                    for (; eid < target; ++eid)
+                        ++edges;
+                    loaded_edges.push(*edges);
+                }
+                edges.rewind();
+                loaded_edges.consume();
+            }
+
+            STDRandomEngine gen(stxxl::get_next_seed());
+            std::uniform_int_distribution<edgeid_t> eid_distr(0, num_edges - 1);
+            std::bernoulli_distribution dir_distr;
+
+            EdgeSwapTFP::SemiLoadedEdgeSwapTFP swap_algo(edges, run_size, num_nodes, config.internalMem);
+            swap_algo.setAdaptiveMemory(config.adaptiveMemory);
+            for (; !loaded_edges.empty(); ++loaded_edges)
+                swap_algo.push(SemiLoadedSwapDescriptor(*loaded_edges, eid_distr(gen), dir_distr(gen)));
+            swap_algo.run();
+            return num_swaps;
+        }
+
+        case RandomizationAlgo::IM: {
+            IMEdgeSwap swap_algo(edges);
+            StreamPusher<decltype(swap_gen), decltype(swap_algo)>(swap_gen, swap_algo);
+            swap_algo.run();
+            return num_swaps;
+        }
+
+        case RandomizationAlgo::CURVEBALL: {
+            const tradeid_t num_rounds = config.numRounds ? config.numRounds
+                                                          : static_cast<tradeid_t>(std::ceil(config.factorNoSwaps));
+
+            EdgeStream out_edges;
+            degrees.rewind();
+            Curveball::EMCurveball<Curveball::ModHash, EdgeStream> cb_algo(edges, degrees, num_nodes, num_rounds,
+                                                                         out_edges, config.numThreads, config.internalMem, true);
+            cb_algo.run();
+
+            if (out_edges.size() != edges.size())
+                throw std::runtime_error("Curveball changed the number of edges");
+
+            // every global trade pairs up all nodes
+            return static_cast<uint64_t>(num_rounds) * (num_nodes / 2);
+        }
+    }
+
+    abort();
+}
+
+void benchmark(const RunConfig & config) {
+    EdgeStream input_edges;
+    load_input(config, input_edges);
+
+    RLEDegreeStream degrees;
+    const node_t num_nodes = compute_degrees(input_edges, degrees,
+        config.inputMethod == RunConfig::InputMethod::FILE ? 0 : static_cast<node_t>(config.numNodes));
+
+    std::cout << "Input graph contains " << num_nodes << " nodes and " << input_edges.size() << " edges\n"
+                 "  " << input_edges.selfloops() << " selfloops\n"
+                 "  " << input_edges.multiedges() << " multiedges"
+    << std::endl;
+
+    const std::string input_name =
+        config.inputMethod == RunConfig::InputMethod::HH   ? "HH" :
+        config.inputMethod == RunConfig::InputMethod::CMES ? "CMES" : config.inputFile;
+
+    if (config.algos.size() * (config.warmups + config.repetitions) > 1)
+        std::cout << "Note: the peak columns are cumulative over all runs of this process; "
+                     "run each configuration separately for per-run peaks" << std::endl;
+
+    std::ostringstream rows;
+    stxxl::stats *stats = stxxl::stats::get_instance();
+
+    for (const auto algo : config.algos) {
+        for (unsigned int rep = 0; rep < config.warmups + config.repetitions; ++rep) {
+            const bool warmup = rep < config.warmups;
+
+            EdgeStream edges;
+            copy_edges(input_edges, edges);
+
+            std::cout << "[" << algo_name(algo) << "] " << (warmup ? "Warm-up " : "Repetition ")
+                      << (warmup ? rep : rep - config.warmups) << std::endl;
+
+            const stxxl::stats_data io_begin(*stats);
+            double milliseconds;
+            uint64_t ops;
+            {
+                TelemetrySpan span(algo_name(algo));
+                ScopedTimer timer(milliseconds);
+                ops = run_algo(config, algo, edges, degrees, num_nodes);
+            }
+            const stxxl::stats_data io = stxxl::stats_data(*stats) - io_begin;
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+
+            const double seconds = milliseconds / 1e3;
+
+            rows << algo_name(algo) << ","
+                 << input_name << ","
+                 << num_nodes << ","
+                 << input_edges.size() << ","
+                 << ops << ","
+                 << (algo == RandomizationAlgo::CURVEBALL ? "trades" : "swaps") << ","
+                 << (warmup ? rep : rep - config.warmups) << ","
+                 << warmup << ","
+                 << seconds << ","
+                 << (seconds > 0 ? ops / seconds : 0.0) << ","
+                 << io.get_reads() << ","
+                 << io.get_writes() << ","
+                 << io.get_read_volume() << ","
+                 << io.get_written_volume() << ","
+                 // cumulative, see file comment
+                 << stxxl::block_manager::get_instance()->get_maximum_allocation() << ","
+                 << static_cast<uint64_t>(usage.ru_maxrss) * 1024 << "\n";
+        }
+    }
+
+    const char* header = "algo,input,nodes,edges,ops,op,repetition,warmup,seconds,ops_per_s,"
+                         "io_reads,io_writes,io_read_bytes,io_written_bytes,em_cumulative_peak_bytes,rss_cumulative_peak_bytes\n";
+
+    if (config.csvFilename.empty()) {
+        std::cout << "\n" << header << rows.str() << std::flush;
+    } else {
+        std::ofstream out(config.csvFilename, std::ios::app);
+        if (!out)
+            throw std::runtime_error("Cannot open CSV file " + config.csvFilename);
+
+        // only write the header into fresh files
+        if (!out.tellp())
+            out << header;
+
+        out << rows.str();
+    }
+}
+
+int main(int argc, char* argv[]) {
+#ifndef NDEBUG
+    std::cout << "[build with assertions]" << std::endl;
+#endif
+    std::cout << "STXXL VERSION: " << STXXL_VERSION_INTEGER << std::endl;
+
+    // nice to have in logs to restart it easier
+    for(int i=0; i < argc; ++i)
+        std::cout << argv[i] << " ";
+    std::cout << std::endl;
+
+    RunConfig config;
+    if (!config.parse_cmdline(argc, argv))
+        return -1;
+
+    stxxl::srandom_number32(config.randomSeed);
+    stxxl::set_seed(config.randomSeed);
+
+    if (!config.traceFilename.empty())
+        Telemetry::get_instance().open(config.traceFilename);
+
+    benchmark(config);
+
+    {
+        const auto max_alloc = stxxl::block_manager::get_instance()->get_maximum_allocation();
+        std::cout << "Maximum EM allocation: "
+            << max_alloc << "b (" <<  ((max_alloc + (1<<20) - 1) / (1<<20)) << " Mb)"
+            << std::endl;
+    }
+
+    return 0;
+}
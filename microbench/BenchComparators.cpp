@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief Microbenchmarks of the DECL_LEX_COMPARE comparators used by the TFP sorters
+ *
+ * Sorts messages with the comparator handed to stxxl::sorter. The "dense"
+ * variants draw the leading key from a small range, so most comparisons have to
+ * fall through to the later tuple members. The PackedKey variants compare the
+ * packed integer keys instead, or radix sort by them.
+ */
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <TupleHelper.h>
+#include <EdgeSwaps/EdgeSwapTFP.h>
+#include <Utils/IntSort.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+using EdgeSwapTFP::DependencyChainEdgeMsg;
+using EdgeSwapTFP::ExistenceSuccessorMsg;
+
+enum class SortMode {Tuple, Packed, Radix};
+
+template <typename Msg, SortMode Mode, typename Generator>
+void sort_messages(MicroBenchmark::State& state, Generator generate) {
+    const size_t n = state.arg();
+
+    STDRandomEngine gen(1234);
+    std::vector<Msg> input(n);
+    for (auto& msg : input)
+        msg = generate(gen);
+
+    std::vector<Msg> data;
+
+    while (state.next()) {
+        state.pause();
+        data = input;
+        state.resume();
+
+        switch (Mode) {
+            case SortMode::Tuple:
+                std::sort(data.begin(), data.end(), typename GenericComparatorStruct<Msg>::Ascending());
+                break;
+            case SortMode::Packed:
+                std::sort(data.begin(), data.end(), typename PackedKeyComparator<Msg>::Ascending());
+                break;
+            case SortMode::Radix:
+                intsort::sort_packed(data);
+                break;
+        }
+        MicroBenchmark::do_not_optimize(data.front());
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+template <swapid_t SwapRange, SortMode Mode = SortMode::Tuple>
+void dependency_chain_edge_msg(MicroBenchmark::State& state) {
+    sort_messages<DependencyChainEdgeMsg, Mode>(state, [] (STDRandomEngine& gen) {
+        std::uniform_int_distribution<swapid_t> swap_dis(0, SwapRange);
+        std::uniform_int_distribution<node_t> node_dis(0, 1 << 20);
+        return DependencyChainEdgeMsg(swap_dis(gen), edge_t(node_dis(gen), node_dis(gen)));
+    });
+}
+
+template <swapid_t SwapRange, SortMode Mode = SortMode::Tuple>
+void existence_successor_msg(MicroBenchmark::State& state) {
+    sort_messages<ExistenceSuccessorMsg, Mode>(state, [] (STDRandomEngine& gen) {
+        std::uniform_int_distribution<swapid_t> swap_dis(0, SwapRange);
+        std::uniform_int_distribution<node_t> node_dis(0, 1 << 20);
+        return ExistenceSuccessorMsg(swap_dis(gen), edge_t(node_dis(gen), node_dis(gen)), swap_dis(gen));
+    });
+}
+
+template <swapid_t SwapRange>
+void dependency_chain_edge_msg_packed(MicroBenchmark::State& state) {dependency_chain_edge_msg<SwapRange, SortMode::Packed>(state);}
+
+template <swapid_t SwapRange>
+void dependency_chain_edge_msg_radix(MicroBenchmark::State& state) {dependency_chain_edge_msg<SwapRange, SortMode::Radix>(state);}
+
+template <swapid_t SwapRange>
+void existence_successor_msg_packed(MicroBenchmark::State& state) {existence_successor_msg<SwapRange, SortMode::Packed>(state);}
+
+template <swapid_t SwapRange>
+void existence_successor_msg_radix(MicroBenchmark::State& state) {existence_successor_msg<SwapRange, SortMode::Radix>(state);}
+
+constexpr swapid_t uniform_range = std::numeric_limits<swapid_t>::max() - 1;
+
+}
+
+MICROBENCH(DECL_LEX_COMPARE/DependencyChainEdgeMsg/uniform, dependency_chain_edge_msg<std::numeric_limits<swapid_t>::max() - 1>, 1 << 12, 1 << 18);
+MICROBENCH(DECL_LEX_COMPARE/DependencyChainEdgeMsg/dense,   dependency_chain_edge_msg<15>, 1 << 12, 1 << 18);
+MICROBENCH(DECL_LEX_COMPARE/ExistenceSuccessorMsg/uniform,  existence_successor_msg<std::numeric_limits<swapid_t>::max() - 1>, 1 << 12, 1 << 18);
+MICROBENCH(DECL_LEX_COMPARE/ExistenceSuccessorMsg/dense,    existence_successor_msg<15>, 1 << 12, 1 << 18);
+
+MICROBENCH(PackedKey/DependencyChainEdgeMsg/uniform, dependency_chain_edge_msg_packed<uniform_range>, 1 << 12, 1 << 18);
+MICROBENCH(PackedKey/DependencyChainEdgeMsg/dense,   dependency_chain_edge_msg_packed<15>, 1 << 12, 1 << 18);
+MICROBENCH(PackedKey/ExistenceSuccessorMsg/uniform,  existence_successor_msg_packed<uniform_range>, 1 << 12, 1 << 18);
+MICROBENCH(PackedKey/ExistenceSuccessorMsg/dense,    existence_successor_msg_packed<15>, 1 << 12, 1 << 18);
+
+MICROBENCH(PackedKeyRadix/DependencyChainEdgeMsg/uniform, dependency_chain_edge_msg_radix<uniform_range>, 1 << 12, 1 << 18);
+MICROBENCH(PackedKeyRadix/ExistenceSuccessorMsg/uniform,  existence_successor_msg_radix<uniform_range>, 1 << 12, 1 << 18);
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Microbenchmarks of the Curveball kernels
+ *
+ * EMDualContainer::trade operates on the macrochunk state built up by
+ * EMCurveball and cannot be driven in isolation; it is measured by a single
+ * global trade of EMCurveball on a small Havel-Hakimi graph instead.
+ */
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <EdgeStream.h>
+#include <Curveball/CurveballHelper.h>
+#include <Curveball/EMCurveball.h>
+#include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <Utils/MonotonicPowerlawRandomStream.h>
+#include <Utils/NodeHash.h>
+#include <Utils/StreamPusher.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+//! Partitions state.arg() disjoint neighbours into sets of size arg/Divisor and arg - arg/Divisor
+template <size_t Divisor>
+void random_partition(MicroBenchmark::State& state) {
+    const size_t n = state.arg();
+    std::vector<node_t> neighbours(n);
+    std::iota(neighbours.begin(), neighbours.end(), 0);
+
+    STDRandomEngine gen(1234);
+    while (state.next()) {
+        CurveballImpl::random_partition(neighbours.begin(), neighbours.end(), n / Divisor, gen);
+        MicroBenchmark::do_not_optimize(neighbours.front());
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+//! Hashes state.arg() consecutive node ids
+void mod_hash(MicroBenchmark::State& state) {
+    const node_t n = state.arg();
+    const auto hash_func = Curveball::ModHash::get_random(n);
+
+    while (state.next()) {
+        for (node_t u = 0; u < n; ++u) {
+            auto h = hash_func.hash(u);
+            MicroBenchmark::do_not_optimize(h);
+        }
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+//! One global trade on a power-law graph with state.arg() nodes
+void global_trade(MicroBenchmark::State& state) {
+    const node_t num_nodes = state.arg();
+
+    EdgeStream edges;
+    HavelHakimiIMGeneratorWithDegrees hh_gen(HavelHakimiIMGeneratorWithDegrees::PushDirection::DecreasingDegree);
+    MonotonicPowerlawRandomStream<false> degree_sequence(5, num_nodes / 10, -2, num_nodes, 1.0, 1234);
+    StreamPusher<decltype(degree_sequence), decltype(hh_gen)>(degree_sequence, hh_gen);
+    hh_gen.generate();
+    StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edges);
+    hh_gen.finalize();
+
+    RLEDegreeStream& degrees = hh_gen.get_degree_stream();
+
+    while (state.next()) {
+        state.pause();
+        edges.rewind();
+        degrees.rewind();
+        EdgeStream out_edges;
+        Curveball::EMCurveball<Curveball::ModHash, EdgeStream> algo(edges, degrees, num_nodes, 1,
+                                                                    out_edges, 1, SORTER_MEM, false);
+        state.resume();
+
+        algo.run();
+    }
+
+    state.set_items_per_iteration(edges.size());
+}
+
+}
+
+MICROBENCH(CurveballImpl/random_partition/half,   random_partition<2>, 16, 256, 4096);
+MICROBENCH(CurveballImpl/random_partition/eighth, random_partition<8>, 16, 256, 4096);
+MICROBENCH(ModHash/hash, mod_hash, 1 << 16, 1 << 20);
+MICROBENCH(EMCurveball/global_trade, global_trade, 1 << 12, 1 << 15);
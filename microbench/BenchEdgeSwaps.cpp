@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief Microbenchmark of EdgeSwapBase::_swap_edges
+ */
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <EdgeSwaps/EdgeSwapBase.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+//! Exposes the swap kernel shared by all edge swap algorithms
+class SwapKernel : public EdgeSwapBase {
+public:
+    using EdgeSwapBase::_swap_edges;
+};
+
+//! Performs state.arg() swaps between random edges with random directions
+void swap_edges(MicroBenchmark::State& state) {
+    const size_t n = state.arg();
+
+    STDRandomEngine gen(1234);
+    std::uniform_int_distribution<node_t> node_dis(0, 1 << 20);
+    std::vector<edge_t> edges(n + 1);
+    for (auto& e : edges) {
+        e = {node_dis(gen), node_dis(gen)};
+        e.normalize();
+    }
+    std::vector<bool> directions(n);
+    for (size_t i = 0; i < n; ++i)
+        directions[i] = gen() & 1;
+
+    SwapKernel kernel;
+    while (state.next()) {
+        for (size_t i = 0; i < n; ++i) {
+            auto result = kernel._swap_edges(edges[i], edges[i + 1], directions[i]);
+            MicroBenchmark::do_not_optimize(result);
+        }
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+}
+
+MICROBENCH(EdgeSwapBase/swap_edges, swap_edges, 1 << 10, 1 << 16, 1 << 20);
@@ -0,0 +1,87 @@
+/**
+ * @file
+ * @brief Microbenchmarks of intsort::sort and intsort::sort_inplace compared to std::sort
+ */
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <Utils/IntSort.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+std::vector<uint64_t> random_keys(size_t n, uint64_t max_key) {
+    STDRandomEngine gen(1234);
+    std::uniform_int_distribution<uint64_t> dis(0, max_key);
+    std::vector<uint64_t> keys(n);
+    for (auto& k : keys)
+        k = dis(gen);
+    return keys;
+}
+
+template <uint64_t MaxKey>
+void int_sort(MicroBenchmark::State& state) {
+    const auto input = random_keys(state.arg(), MaxKey);
+    std::vector<uint64_t> data;
+
+    while (state.next()) {
+        state.pause();
+        data = input;
+        state.resume();
+
+        intsort::sort(data, [] (const uint64_t& x) {return x;}, MaxKey);
+        MicroBenchmark::do_not_optimize(data.front());
+    }
+
+    state.set_items_per_iteration(input.size());
+}
+
+template <uint64_t MaxKey>
+void int_sort_inplace(MicroBenchmark::State& state) {
+    const auto input = random_keys(state.arg(), MaxKey);
+    std::vector<uint64_t> data;
+
+    while (state.next()) {
+        state.pause();
+        data = input;
+        state.resume();
+
+        intsort::sort_inplace(data, [] (const uint64_t& x) {return x;}, MaxKey);
+        MicroBenchmark::do_not_optimize(data.front());
+    }
+
+    state.set_items_per_iteration(input.size());
+}
+
+template <uint64_t MaxKey>
+void std_sort(MicroBenchmark::State& state) {
+    const auto input = random_keys(state.arg(), MaxKey);
+    std::vector<uint64_t> data;
+
+    while (state.next()) {
+        state.pause();
+        data = input;
+        state.resume();
+
+        std::sort(data.begin(), data.end());
+        MicroBenchmark::do_not_optimize(data.front());
+    }
+
+    state.set_items_per_iteration(input.size());
+}
+
+constexpr uint64_t small_range = 255;
+constexpr uint64_t node_range = std::numeric_limits<uint32_t>::max();
+
+}
+
+MICROBENCH(intsort/sort/keys8bit,  int_sort<small_range>, 1 << 12, 1 << 16, 1 << 20);
+MICROBENCH(intsort/sort/keys32bit, int_sort<node_range>,  1 << 12, 1 << 16, 1 << 20);
+MICROBENCH(intsort/sort_inplace/keys8bit,  int_sort_inplace<small_range>, 1 << 12, 1 << 16, 1 << 20);
+MICROBENCH(intsort/sort_inplace/keys32bit, int_sort_inplace<node_range>,  1 << 12, 1 << 16, 1 << 20);
+MICROBENCH(std/sort/keys8bit,      std_sort<small_range>, 1 << 12, 1 << 16, 1 << 20);
+MICROBENCH(std/sort/keys32bit,     std_sort<node_range>,  1 << 12, 1 << 16, 1 << 20);
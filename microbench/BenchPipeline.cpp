@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Microbenchmarks of the producer/consumer stages AsyncStream and AsyncPusher
+ */
+#include <defs.h>
+#include <Utils/AsyncStream.h>
+#include <Utils/AsyncPusher.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+struct CounterStream {
+    using value_type = uint64_t;
+
+    const uint64_t _length;
+    uint64_t _current;
+
+    CounterStream(uint64_t length) : _length(length), _current(0) {}
+    CounterStream& operator++() {_current++; return *this;}
+    const uint64_t & operator*() const {return _current;}
+    bool empty() const {return _current >= _length;}
+};
+
+struct SumTarget {
+    uint64_t sum = 0;
+    void push(uint64_t x) {sum += x;}
+};
+
+//! Consumes state.arg() items produced by a worker thread
+void async_stream(MicroBenchmark::State& state) {
+    const uint64_t n = state.arg();
+
+    while (state.next()) {
+        CounterStream counter(n);
+        AsyncStream<CounterStream> stream(counter, true, 1.0e6, 0.1);
+
+        uint64_t sum = 0;
+        for (; !stream.empty(); ++stream)
+            sum += *stream;
+        MicroBenchmark::do_not_optimize(sum);
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+//! Pushes state.arg() items that are forwarded by a worker thread
+void async_pusher(MicroBenchmark::State& state) {
+    const uint64_t n = state.arg();
+
+    while (state.next()) {
+        SumTarget target;
+        AsyncPusher<SumTarget, uint64_t> pusher(target, 1 << 16, 4);
+
+        for (uint64_t i = 0; i < n; ++i)
+            pusher.push(i);
+        pusher.finish();
+        MicroBenchmark::do_not_optimize(target.sum);
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+}
+
+MICROBENCH(AsyncStream/consume, async_stream, 1 << 12, 1 << 22);
+MICROBENCH(AsyncPusher/push,    async_pusher, 1 << 12, 1 << 22);
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Microbenchmarks of RandomIntervalTree::getLeaf
+ */
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <Utils/RandomIntervalTree.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+constexpr size_t queries_per_iteration = 1 << 12;
+
+//! Draws leaves of a tree with state.arg() leaves; Skewed assigns power-law weights as for degree sequences
+template <bool Skewed>
+void get_leaf(MicroBenchmark::State& state) {
+    const size_t n = state.arg();
+
+    STDRandomEngine gen(1234);
+    std::vector<uint64_t> weights(n);
+    for (size_t i = 0; i < n; ++i)
+        weights[i] = Skewed ? 1 + n / (i + 1) : 1 + gen() % 100;
+
+    RandomIntervalTree<uint64_t> tree(weights);
+
+    std::uniform_int_distribution<uint64_t> weight_dis(0, tree.total_weight() - 1);
+    std::vector<uint64_t> queries(queries_per_iteration);
+    for (auto& q : queries)
+        q = weight_dis(gen);
+
+    while (state.next()) {
+        for (const auto q : queries) {
+            auto leaf = tree.getLeaf(q);
+            MicroBenchmark::do_not_optimize(leaf);
+        }
+    }
+
+    state.set_items_per_iteration(queries_per_iteration);
+}
+
+}
+
+MICROBENCH(RandomIntervalTree/getLeaf/uniform, get_leaf<false>, 1 << 10, 1 << 16, 1 << 22);
+MICROBENCH(RandomIntervalTree/getLeaf/skewed,  get_leaf<true>,  1 << 10, 1 << 16, 1 << 22);
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief Microbenchmarks of the external memory streams EdgeStream and BoolStream
+ */
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <EdgeStream.h>
+#include <BoolStream.h>
+
+#include "MicroBenchmark.h"
+
+namespace {
+
+//! Sorted edges with an average degree of 10 as they are produced by the generators
+std::vector<edge_t> sorted_edges(size_t n) {
+    STDRandomEngine gen(1234);
+    std::uniform_int_distribution<node_t> node_dis(0, static_cast<node_t>(n / 5));
+    std::vector<edge_t> edges(n);
+    for (auto& e : edges) {
+        e = {node_dis(gen), node_dis(gen)};
+        e.normalize();
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+void edge_stream_push(MicroBenchmark::State& state) {
+    const auto edges = sorted_edges(state.arg());
+
+    while (state.next()) {
+        EdgeStream stream;
+        for (const auto& e : edges)
+            stream.push(e);
+        stream.consume();
+        MicroBenchmark::do_not_optimize(stream.size());
+    }
+
+    state.set_items_per_iteration(edges.size());
+}
+
+void edge_stream_read(MicroBenchmark::State& state) {
+    EdgeStream stream;
+    for (const auto& e : sorted_edges(state.arg()))
+        stream.push(e);
+    stream.consume();
+
+    while (state.next()) {
+        stream.rewind();
+        for (; !stream.empty(); ++stream)
+            MicroBenchmark::do_not_optimize(*stream);
+    }
+
+    state.set_items_per_iteration(stream.size());
+}
+
+void bool_stream_push(MicroBenchmark::State& state) {
+    const size_t n = state.arg();
+    BoolStream stream;
+
+    while (state.next()) {
+        stream.clear();
+        for (size_t i = 0; i < n; ++i)
+            stream.push(i % 3 == 0);
+        stream.consume();
+        MicroBenchmark::do_not_optimize(stream.size());
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+void bool_stream_read(MicroBenchmark::State& state) {
+    const size_t n = state.arg();
+    BoolStream stream;
+    for (size_t i = 0; i < n; ++i)
+        stream.push(i % 3 == 0);
+    stream.consume();
+
+    while (state.next()) {
+        stream.rewind();
+        for (; !stream.empty(); ++stream)
+            MicroBenchmark::do_not_optimize(*stream);
+    }
+
+    state.set_items_per_iteration(n);
+}
+
+}
+
+MICROBENCH(EdgeStream/push, edge_stream_push, 1 << 16, 1 << 22);
+MICROBENCH(EdgeStream/read, edge_stream_read, 1 << 16, 1 << 22);
+MICROBENCH(BoolStream/push, bool_stream_push, 1 << 16, 1 << 24);
+MICROBENCH(BoolStream/read, bool_stream_read, 1 << 16, 1 << 24);
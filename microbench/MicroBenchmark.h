@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Minimal microbenchmark harness in the spirit of google-benchmark
+ *
+ * A benchmark is a function taking a MicroBenchmark::State. Everything inside
+ * the `while (state.next())` loop is measured; setup before the loop and
+ * sections between state.pause() and state.resume() are not:
+ *
+ *   static void swap_edges(MicroBenchmark::State& state) {
+ *       std::vector<edge_t> edges = ...;        // size state.arg()
+ *       while (state.next()) { ... }
+ *       state.set_items_per_iteration(edges.size());
+ *   }
+ *   MICROBENCH(EdgeSwapBase/swap_edges, swap_edges, 1 << 10, 1 << 20);
+ *
+ * Each benchmark is run once per argument. The number of iterations is
+ * doubled until a run takes at least the minimum time; this calibrated run is
+ * then repeated and reported as one CSV row or JSON object per repetition
+ * (see main_microbench.cpp).
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace MicroBenchmark {
+
+//! Prevents the compiler from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class State {
+public:
+    State(int64_t arg, uint64_t iterations)
+        : _arg(arg)
+        , _iterations(iterations)
+        , _remaining(iterations)
+        , _items_per_iteration(0)
+        , _elapsed(Clock::duration::zero())
+        , _started(false)
+        , _running(false)
+    {}
+
+    //! Parameter of the benchmark, e.g. the input size
+    int64_t arg() const {return _arg;}
+
+    //! Number of iterations of the measurement loop
+    uint64_t iterations() const {return _iterations;}
+
+    //! Returns true as long as another iteration has to be performed
+    bool next() {
+        if (!_started) {
+            _started = true;
+            resume();
+        }
+
+        if (!_remaining) {
+            pause();
+            return false;
+        }
+
+        --_remaining;
+        return true;
+    }
+
+    //! Excludes the following code from the measurement
+    void pause() {
+        if (!_running) return;
+        _elapsed += Clock::now() - _begin;
+        _running = false;
+    }
+
+    void resume() {
+        if (_running) return;
+        _running = true;
+        _begin = Clock::now();
+    }
+
+    //! Number of items (e.g. elements sorted) processed per iteration; enables the throughput column
+    void set_items_per_iteration(uint64_t items) {_items_per_iteration = items;}
+    uint64_t items_per_iteration() const {return _items_per_iteration;}
+
+    double seconds() const {
+        return std::chrono::duration<double>(_elapsed).count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const int64_t _arg;
+    const uint64_t _iterations;
+    uint64_t _remaining;
+    uint64_t _items_per_iteration;
+
+    Clock::duration _elapsed;
+    Clock::time_point _begin;
+    bool _started;
+    bool _running;
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(State&)> function;
+    std::vector<int64_t> args;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const std::string& name, std::function<void(State&)> function, std::initializer_list<int64_t> args) {
+        registry().push_back({name, function, args.size() ? std::vector<int64_t>(args) : std::vector<int64_t>{0}});
+    }
+};
+
+} // namespace MicroBenchmark
+
+#define MICROBENCH_CONCAT_IMPL(a, b) a##b
+#define MICROBENCH_CONCAT(a, b) MICROBENCH_CONCAT_IMPL(a, b)
+
+//! Registers function under the given name; it is run once for each of the optional integer arguments
+#define MICROBENCH(name, function, ...) \
+    static MicroBenchmark::Registrar MICROBENCH_CONCAT(microbench_registrar_, __LINE__) (#name, function, {__VA_ARGS__})
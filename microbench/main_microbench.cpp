@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Runs the registered microbenchmarks (see MicroBenchmark.h)
+ *
+ * Results are written as CSV with the columns
+ *   benchmark, arg, repetition, iterations, seconds, ns_per_iteration, items_per_s
+ * or, with --json, as one JSON object per line with the same keys.
+ */
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+#include <stxxl/cmdline>
+
+#include "MicroBenchmark.h"
+
+struct RunConfig {
+    std::string filter;
+    double minTime;
+    unsigned int repetitions;
+    bool json;
+    bool list;
+    std::string outputFilename;
+
+    RunConfig()
+        : minTime(0.1)
+        , repetitions(3)
+        , json(false)
+        , list(false)
+    {}
+
+#if STXXL_VERSION_INTEGER > 10401
+#define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, dest, args
+#else
+    #define CMDLINE_COMP(chr, str, dest, args...) \
+        chr, str, args, dest
+#endif
+
+    bool parse_cmdline(int argc, char* argv[]) {
+        stxxl::cmdline_parser cp;
+
+        cp.add_string(CMDLINE_COMP('f', "filter",      filter,         "Only run benchmarks whose name contains this string"));
+        cp.add_double(CMDLINE_COMP('t', "min-time",    minTime,        "Minimum time of a measurement in seconds; default: 0.1"));
+        cp.add_uint  (CMDLINE_COMP('r', "repetitions", repetitions,    "Measurements per benchmark and argument; default: 3"));
+        cp.add_flag  (CMDLINE_COMP('j', "json",        json,           "Write one JSON object per line instead of CSV"));
+        cp.add_flag  (CMDLINE_COMP('l', "list",        list,           "List the benchmarks and exit"));
+        cp.add_string(CMDLINE_COMP('o', "output",      outputFilename, "Write results into this file instead of stdout"));
+
+        if (!cp.process(argc, argv)) {
+            cp.print_usage();
+            return false;
+        }
+
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    RunConfig config;
+    if (!config.parse_cmdline(argc, argv))
+        return -1;
+
+    std::ofstream file;
+    if (!config.outputFilename.empty()) {
+        file.open(config.outputFilename, std::ios::trunc);
+        if (!file) {
+            std::cerr << "Cannot open " << config.outputFilename << std::endl;
+            return -1;
+        }
+    }
+    std::ostream& out = config.outputFilename.empty() ? std::cout : file;
+    out << std::setprecision(6);
+
+    if (!config.json)
+        out << "benchmark,arg,repetition,iterations,seconds,ns_per_iteration,items_per_s\n";
+
+    for (const auto& bench : MicroBenchmark::registry()) {
+        if (bench.name.find(config.filter) == std::string::npos)
+            continue;
+
+        for (const auto arg : bench.args) {
+            if (config.list) {
+                out << bench.name << "/" << arg << "\n";
+                continue;
+            }
+
+            // double the iterations until the measurement is long enough
+            uint64_t iterations = 1;
+            while (true) {
+                MicroBenchmark::State state(arg, iterations);
+                bench.function(state);
+                if (state.seconds() >= config.minTime || iterations >= (1llu << 40))
+                    break;
+
+                const double factor = state.seconds() > 0 ? 1.2 * config.minTime / state.seconds() : 1e3;
+                iterations = std::max(2 * iterations, static_cast<uint64_t>(iterations * std::min(factor, 1e3)));
+            }
+
+            for (unsigned int rep = 0; rep < config.repetitions; ++rep) {
+                MicroBenchmark::State state(arg, iterations);
+                bench.function(state);
+
+                const double seconds = state.seconds();
+                const double ns_per_iteration = 1e9 * seconds / iterations;
+                const double items_per_s = seconds > 0 ? state.items_per_iteration() * iterations / seconds : 0.0;
+
+                if (config.json) {
+                    out << "{\"benchmark\": \"" << bench.name << "\", "
+                        << "\"arg\": " << arg << ", "
+                        << "\"repetition\": " << rep << ", "
+                        << "\"iterations\": " << iterations << ", "
+                        << "\"seconds\": " << seconds << ", "
+                        << "\"ns_per_iteration\": " << ns_per_iteration << ", "
+                        << "\"items_per_s\": " << items_per_s << "}\n";
+                } else {
+                    out << bench.name << ","
+                        << arg << ","
+                        << rep << ","
+                        << iterations << ","
+                        << seconds << ","
+                        << ns_per_iteration << ","
+                        << items_per_s << "\n";
+                }
+                out << std::flush;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <LFR/CommunityEdgeRewiringSwaps.h>
+#include <algorithm>
+#include <map>
 
 class TestCommunityRewiring : public ::testing::Test { };
 
@@ -22,3 +24,48 @@ TEST_F(TestCommunityRewiring, testTwoCommunities) {
 		EXPECT_NE(prev.edge, it->edge);
 	}
 };
+
+TEST_F(TestCommunityRewiring, testSequentialAndPerCommunity) {
+	using edge_community_vector_t = stxxl::vector<LFR::CommunityEdge>;
+
+	// two overlapping cliques sharing nodes 0 to 4
+	auto member = [] (node_t u, community_t c) {return u < 5 || (u - 5) % 2 == c;};
+
+	for (bool parallel : {false, true}) {
+		std::vector<LFR::CommunityEdge> input;
+		std::map<std::pair<community_t, node_t>, degree_t> degrees;
+		for (node_t u = 0; u < 20; ++u)
+			for (node_t v = u + 1; v < 20; ++v)
+				for (community_t c = 0; c < 2; ++c)
+					if (member(u, c) && member(v, c) && (u + v) % 3) {
+						input.push_back(LFR::CommunityEdge(c, edge_t(u, v)));
+						degrees[{c, u}]++;
+						degrees[{c, v}]++;
+					}
+		std::sort(input.begin(), input.end());
+
+		edge_community_vector_t edges;
+		for (const auto& e : input)
+			edges.push_back(e);
+
+		CommunityEdgeRewiringSwaps rewiring(edges, edges.size() / 3, 1.0, SORTER_MEM, parallel);
+		rewiring.run();
+
+		// the duplicates are resolvable, so no edge is deleted
+		ASSERT_EQ(edges.size(), input.size()) << "parallel: " << parallel;
+		for (auto it = edges.cbegin(); it != edges.cend(); ++it) {
+			if (it != edges.cbegin())
+				EXPECT_NE((it - 1)->edge, it->edge) << "parallel: " << parallel;
+			EXPECT_FALSE(it->edge.is_loop());
+
+			// swaps stay within a community and keep the degrees in it
+			EXPECT_TRUE(member(it->edge.first, it->community_id) && member(it->edge.second, it->community_id))
+				<< "parallel: " << parallel << " community " << it->community_id << " edge " << it->edge;
+			degrees[{it->community_id, it->edge.first}]--;
+			degrees[{it->community_id, it->edge.second}]--;
+		}
+
+		for (const auto& d : degrees)
+			EXPECT_EQ(d.second, 0) << "parallel: " << parallel << " community " << d.first.first << " node " << d.first.second;
+	}
+}
@@ -46,7 +46,7 @@ TEST_F(TestCurveball, pld_instance_without_paramest) {
 	StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edge_stream);
 	hh_gen.finalize();
 
-	DegreeStream &degree_stream = hh_gen.get_degree_stream();
+	RLEDegreeStream &degree_stream = hh_gen.get_degree_stream();
 
 	// Run algorithm
 	edge_stream.rewind();
@@ -113,7 +113,7 @@ TEST_F(TestCurveball, pld_instance_with_paramest) {
 	StreamPusher<decltype(hh_gen), EdgeStream>(hh_gen, edge_stream);
 	hh_gen.finalize();
 
-	DegreeStream &degree_stream = hh_gen.get_degree_stream();
+	RLEDegreeStream &degree_stream = hh_gen.get_degree_stream();
 
 	// Run algorithm
 	edge_stream.rewind();
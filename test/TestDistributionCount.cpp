@@ -3,6 +3,7 @@
 //
 
 #include <DistributionCount.h>
+#include <DegreeStream.h>
 #include <stxxl/stream>
 #include <defs.h>
 #include <gtest/gtest.h>
@@ -52,3 +53,41 @@ TEST_F(TestDistributionCount, testPowerlawCounting) {
     }
 }
 
+
+TEST_F(TestDistributionCount, testRLEDegreeStream) {
+    std::vector<degree_t> degrees({5, 5, 5, 4, 3, 3, 1, 1, 1, 1});
+    std::vector<std::pair<degree_t, int_t> > distribution = {{5, 3}, {4, 1}, {3, 2}, {1, 4}};
+
+    RLEDegreeStream stream;
+    stream.push(5, 2);
+    for (auto it = degrees.begin() + 2; it != degrees.end(); ++it)
+        stream.push(*it);
+
+    stream.rewind();
+    ASSERT_EQ(stream.size(), degrees.size());
+    ASSERT_EQ(stream.num_runs(), distribution.size());
+
+    // node-wise consumption
+    for (auto d : degrees) {
+        ASSERT_FALSE(stream.empty());
+        EXPECT_EQ(d, *stream);
+        ++stream;
+    }
+    EXPECT_TRUE(stream.empty());
+
+    // run-wise consumption, starting in the middle of a run
+    stream.rewind();
+    ++stream;
+    EXPECT_EQ(stream.run_remaining(), 2u);
+
+    int_t index = 0;
+    for (auto dist : distribution) {
+        ASSERT_FALSE(stream.empty());
+        index += dist.second;
+        EXPECT_EQ(dist.first, stream.current_run().value);
+        EXPECT_EQ(dist.second, static_cast<int_t>(stream.current_run().count));
+        EXPECT_EQ(index, static_cast<int_t>(stream.current_run().index));
+        stream.next_run();
+    }
+    EXPECT_TRUE(stream.empty());
+}
@@ -17,6 +17,7 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <random>
 #include "EdgeStream.h"
 
@@ -73,3 +74,36 @@ TEST_F(TestEdgeStream, fillReadRereadReset) {
         check_against_ref(es, reference);
     }
 }
+
+TEST_F(TestEdgeStream, internalMemory) {
+    EdgeStream es;
+    es.enableInternalMemory();
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<node_t> distr(0, 999);
+
+    for (unsigned int iter = 0; iter < 3; iter++) {
+        if (iter)
+            es.clear();
+
+        // includes nodes without edges, loops and multi-edges
+        std::vector<edge_t> reference;
+        for (unsigned int i = 0; i < 10000; ++i)
+            reference.emplace_back(distr(gen), distr(gen));
+        std::sort(reference.begin(), reference.end());
+
+        for (const auto& edge : reference)
+            es.push(edge);
+        ASSERT_EQ(es.size(), reference.size());
+
+        es.consume();
+        for (unsigned int pass = 0; pass < 2; ++pass, es.rewind()) {
+            for (const auto& edge : reference) {
+                ASSERT_FALSE(es.empty());
+                ASSERT_EQ(*es, edge);
+                ++es;
+            }
+            ASSERT_TRUE(es.empty());
+        }
+    }
+}
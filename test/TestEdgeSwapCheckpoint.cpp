@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <EdgeStream.h>
+#include <EdgeSwaps/EdgeSwapTFP.h>
+#include <Utils/ThrillBinaryReader.h>
+
+class TestEdgeSwapCheckpoint : public ::testing::Test {
+protected:
+   const std::string _filename = "TestEdgeSwapCheckpoint.ckpt";
+   const node_t _num_nodes = 1000;
+   const swapid_t _run_length = 2000;
+
+   // circulant graph in which each node is connected to its next four nodes
+   void _generate_graph(EdgeStream& edges) {
+      std::vector<edge_t> edge_list;
+      for (node_t u = 0; u < _num_nodes; ++u)
+         for (node_t d = 1; d <= 4; ++d) {
+            edge_t e(u, (u + d) % _num_nodes);
+            e.normalize();
+            edge_list.push_back(e);
+         }
+
+      std::sort(edge_list.begin(), edge_list.end());
+      for (const auto& e : edge_list)
+         edges.push(e);
+      edges.consume();
+   }
+
+   static std::vector<edge_t> _to_vector(EdgeStream& edges) {
+      std::vector<edge_t> result;
+      for (edges.rewind(); !edges.empty(); ++edges)
+         result.push_back(*edges);
+      edges.rewind();
+      return result;
+   }
+
+   void TearDown() override {
+      std::remove(_filename.c_str());
+      for (unsigned int slot = 0; slot < 2; ++slot) {
+         const std::string edges = _filename + ".edges" + std::to_string(slot);
+         for (size_t part = 0; !std::remove(ThrillBinaryReader::part_filename(edges, part).c_str()); ++part) {}
+      }
+   }
+};
+
+TEST_F(TestEdgeSwapCheckpoint, resumeYieldsSameGraph) {
+   const swapid_t number_of_swaps = 5 * _run_length + 123;
+
+   // uninterrupted run writing a checkpoint at the start of each run
+   std::vector<edge_t> expected;
+   {
+      EdgeStream edges;
+      _generate_graph(edges);
+
+      EdgeSwapTFP::EdgeSwapTFP algo(edges, _run_length, _num_nodes, 1llu << 28);
+      algo.setCheckpoint(_filename, 0.0);
+      algo.runRandomSwaps(number_of_swaps, 1234);
+
+      expected = _to_vector(edges);
+   }
+
+   // the last checkpoint was taken at the start of the last run
+   EdgeStream edges;
+   const auto state = EdgeSwapTFP::EdgeSwapTFP::loadCheckpoint(_filename, edges);
+   ASSERT_EQ(state.total_swaps, number_of_swaps);
+   ASSERT_EQ(state.swaps_done, 5 * _run_length);
+   ASSERT_EQ(state.runs_done, 5u);
+   ASSERT_EQ(state.num_nodes, _num_nodes);
+   ASSERT_EQ(state.num_edges, static_cast<edgeid_t>(expected.size()));
+
+   EdgeSwapTFP::EdgeSwapTFP algo(edges, _run_length, _num_nodes, 1llu << 28);
+   algo.resumeRandomSwaps(state);
+
+   ASSERT_EQ(_to_vector(edges), expected);
+}
+
+TEST_F(TestEdgeSwapCheckpoint, rejectsDifferentRunLength) {
+   {
+      EdgeStream edges;
+      _generate_graph(edges);
+
+      EdgeSwapTFP::EdgeSwapTFP algo(edges, _run_length, _num_nodes, 1llu << 28);
+      algo.setCheckpoint(_filename, 0.0);
+      algo.runRandomSwaps(3 * _run_length, 1);
+   }
+
+   EdgeStream edges;
+   const auto state = EdgeSwapTFP::EdgeSwapTFP::loadCheckpoint(_filename, edges);
+
+   EdgeSwapTFP::EdgeSwapTFP algo(edges, _run_length + 1, _num_nodes, 1llu << 28);
+   ASSERT_THROW(algo.resumeRandomSwaps(state), std::runtime_error);
+}
@@ -17,6 +17,19 @@
 
 
 #ifdef EDGE_SWAP_DEBUG_VECTOR
+// EdgeSwapTFP answering existence requests of most edges from RAM
+class EdgeSwapTFPHubIndex : public EdgeSwapTFP::EdgeSwapTFP {
+public:
+   EdgeSwapTFPHubIndex(edge_buffer_t &edges, swap_vector &swaps) :
+      EdgeSwapTFP::EdgeSwapTFP(edges, swaps, 1000)
+   {
+      setHubExistenceIndex(4, 1000);
+   }
+};
+
+template <>
+struct EdgeSwapTrait<EdgeSwapTFPHubIndex> : public EdgeSwapTrait<EdgeSwapTFP::EdgeSwapTFP> {};
+
 namespace {
    using EdgeVector = stxxl::vector<edge_t>;
    using SwapVector = stxxl::vector<SwapDescriptor>;
@@ -77,6 +90,7 @@ namespace {
    using TestEdgeSwapCrossImplementations = ::testing::Types <
       EdgeSwapInternalSwaps,
       EdgeSwapTFP::EdgeSwapTFP,
+      EdgeSwapTFPHubIndex,
       EdgeSwapParallelTFP::EdgeSwapParallelTFP,
       IMEdgeSwap
    >;
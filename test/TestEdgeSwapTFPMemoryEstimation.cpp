@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief Test cases for EdgeSwapTFP::MemoryEstimation::rebalance
+ */
+#include <gtest/gtest.h>
+
+#include <EdgeSwaps/EdgeSwapTFP.h>
+
+namespace {
+    // MemoryEstimation is a protected member type of EdgeSwapTFP
+    struct EstimationAccess : public EdgeSwapTFP::EdgeSwapTFP {
+        using Estimation = MemoryEstimation;
+    };
+
+    using Estimation = EstimationAccess::Estimation;
+
+    size_t total(const Estimation& est) {
+        return est.depchain_edge_sorter() + 2 * est.depchain_pq_pool() + est.depchain_successor_sorter()
+             + 2 * est.edge_state_pq_pool() + 2 * est.edge_swap_sorter() + est.edge_update_sorter()
+             + 2 * est.existence_info_pq_pool() + est.existence_info_sorter()
+             + est.existence_request_sorter() + est.existence_successor_sorter();
+    }
+}
+
+class TestEdgeSwapTFPMemoryEstimation : public ::testing::Test {
+protected:
+    const size_t _mem = 4 * IntScale::Gi;
+    const swapid_t _swaps = 10 * IntScale::Mi;
+};
+
+TEST_F(TestEdgeSwapTFPMemoryEstimation, followsObservedVolumes) {
+    const Estimation initial(_mem, _swaps, 10);
+    Estimation est(initial);
+
+    // existence requests dominate, the dependency chain edges are almost absent
+    Estimation::volume_array_t observed {};
+    observed[0] = 1000;
+    observed[8] = 20 * _swaps;
+    est.rebalance(observed);
+
+    EXPECT_GT(est.existence_request_sorter(), initial.existence_request_sorter());
+    EXPECT_LT(est.depchain_edge_sorter(), initial.depchain_edge_sorter());
+    EXPECT_GT(est.existence_request_sorter(), est.existence_info_sorter());
+    EXPECT_LE(total(est), _mem);
+
+    // the swap and update sorters carry data across runs
+    EXPECT_EQ(est.edge_swap_sorter(), initial.edge_swap_sorter());
+    EXPECT_EQ(est.edge_update_sorter(), initial.edge_update_sorter());
+}
+
+TEST_F(TestEdgeSwapTFPMemoryEstimation, ignoresEdgeStatePQ) {
+    Estimation::volume_array_t observed {};
+    observed[1] = 2 * _swaps;
+    observed[8] = 4 * _swaps;
+
+    Estimation a(_mem, _swaps, 10);
+    a.rebalance(observed);
+
+    observed[3] = 100 * _swaps;
+    Estimation b(_mem, _swaps, 10);
+    b.rebalance(observed);
+
+    EXPECT_EQ(a.edge_state_pq_pool(), b.edge_state_pq_pool());
+    EXPECT_EQ(a.existence_request_sorter(), b.existence_request_sorter());
+    EXPECT_LT(a.edge_state_pq_pool(), a.depchain_pq_pool());
+}
+
+TEST_F(TestEdgeSwapTFPMemoryEstimation, reserveShrinksBudget) {
+    const Estimation initial(_mem, _swaps, 10);
+
+    // reserving nothing only moves the share of the unused edge state PQ
+    Estimation unreserved(initial);
+    unreserved.reserve(0);
+
+    Estimation est(initial);
+    const size_t reserved = _mem / 4;
+    est.reserve(reserved);
+
+    EXPECT_EQ(est.budget(), _mem - reserved);
+    EXPECT_LE(total(est), _mem - reserved);
+    EXPECT_LT(est.existence_request_sorter(), unreserved.existence_request_sorter());
+    EXPECT_LT(est.depchain_edge_sorter(), unreserved.depchain_edge_sorter());
+
+    // the swap and update sorters carry data across runs
+    EXPECT_EQ(est.edge_swap_sorter(), initial.edge_swap_sorter());
+    EXPECT_EQ(est.edge_update_sorter(), initial.edge_update_sorter());
+
+    EXPECT_THROW(est.reserve(_mem), std::runtime_error);
+}
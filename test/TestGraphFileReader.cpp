@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <EdgeStream.h>
+#include <Utils/DirectFileReader.h>
+#include <Utils/ExportGraph.h>
+#include <Utils/GraphFileReader.h>
+#include <Utils/ThrillBinaryReader.h>
+
+class TestGraphFileReader : public ::testing::Test {
+protected:
+   const std::string _filename = "TestGraphFileReader.graph";
+
+   void TearDown() override {
+      std::remove(_filename.c_str());
+      for (size_t part = 0; !std::remove(ThrillBinaryReader::part_filename(_filename, part).c_str()); ++part) {}
+   }
+
+   void _write(const std::string& content) {
+      std::ofstream out(_filename, std::ios::trunc | std::ios::binary);
+      out << content;
+   }
+
+   static std::vector<edge_t> _to_vector(EdgeStream& edges) {
+      std::vector<edge_t> result;
+      for (; !edges.empty(); ++edges)
+         result.push_back(*edges);
+      return result;
+   }
+
+   // circulant graph in which each node is connected to its next three nodes
+   static std::vector<edge_t> _circulant(node_t n) {
+      std::vector<edge_t> result;
+      for (node_t u = 0; u < n; ++u)
+         for (node_t d = 1; d <= 3; ++d)
+            result.emplace_back(std::min<node_t>(u, (u + d) % n), std::max<node_t>(u, (u + d) % n));
+
+      std::sort(result.begin(), result.end());
+      return result;
+   }
+};
+
+TEST_F(TestGraphFileReader, directFileReaderBlocks) {
+   std::string content;
+   for (size_t i = 0; i < 100000; ++i)
+      content.push_back(static_cast<char>(i * 7 + i / 251));
+   _write(content);
+
+   // small blocks, so that every I/O thread reads several of them
+   for (unsigned int depth : {1, 3}) {
+      DirectFileReader reader(_filename, 4096, depth);
+      ASSERT_EQ(reader.file_size(), content.size());
+
+      std::string read;
+      DirectFileReader::Block block;
+      while (reader.next(block)) {
+         ASSERT_EQ(block.offset, read.size());
+         read.append(block.data, block.size);
+      }
+
+      ASSERT_EQ(read, content);
+   }
+}
+
+TEST_F(TestGraphFileReader, binary) {
+   const auto expected = _circulant(1000);
+   {
+      std::ofstream out(_filename, std::ios::trunc | std::ios::binary);
+      out.write(reinterpret_cast<const char*>(expected.data()), expected.size() * sizeof(edge_t));
+   }
+
+   EdgeStream edges;
+   const auto info = load_graph_file(_filename, GraphFileFormat::Binary, edges);
+   ASSERT_EQ(info.num_nodes, 1000);
+   ASSERT_EQ(info.num_edges, static_cast<edgeid_t>(expected.size()));
+   ASSERT_EQ(_to_vector(edges), expected);
+}
+
+TEST_F(TestGraphFileReader, thrillbin) {
+   // node 0: 1, 2; node 1: none; node 2: 2000 neighbours (two-byte degree); node 3: 3
+   std::string content;
+   auto put_node = [&] (node_t v) {content.append(reinterpret_cast<const char*>(&v), sizeof(v));};
+   std::vector<edge_t> expected;
+
+   content.push_back(2);
+   put_node(1); put_node(2);
+   expected.emplace_back(0, 1);
+   expected.emplace_back(0, 2);
+
+   content.push_back(0);
+
+   content.push_back(static_cast<char>((2000 & 0x7f) | 0x80));
+   content.push_back(static_cast<char>((2000 >> 7) | 0x80));
+   content.push_back(0);
+   for (node_t v = 3; v < 2003; ++v) {
+      put_node(v);
+      expected.emplace_back(2, v);
+   }
+
+   content.push_back(1);
+   put_node(3);
+   expected.emplace_back(3, 3);
+
+   _write(content);
+
+   EdgeStream edges;
+   const auto info = load_graph_file(_filename, GraphFileFormat::ThrillBin, edges);
+   ASSERT_EQ(info.num_nodes, 4);
+   ASSERT_EQ(_to_vector(edges), expected);
+}
+
+TEST_F(TestGraphFileReader, thrillbinParts) {
+   const node_t n = 10000;
+   const auto expected = _circulant(n);
+
+   // parts of at most 4 KiB, so the graph spans many of them
+   {
+      EdgeStream edges;
+      for (const auto& e : expected)
+         edges.push(e);
+      edges.consume();
+      export_as_thrillbin_sorted(edges, _filename, n, 4096);
+   }
+   ASSERT_TRUE(std::ifstream(ThrillBinaryReader::part_filename(_filename, 10)).good());
+
+   EdgeStream edges;
+   const auto info = load_graph_file(_filename, GraphFileFormat::ThrillBin, edges);
+   ASSERT_EQ(info.num_nodes, n);
+   ASSERT_EQ(info.num_edges, static_cast<edgeid_t>(expected.size()));
+   ASSERT_EQ(_to_vector(edges), expected);
+
+   // neither parts nor a single file
+   ASSERT_THROW(load_graph_file(_filename + ".missing", GraphFileFormat::ThrillBin, edges), std::runtime_error);
+}
+
+TEST_F(TestGraphFileReader, metis) {
+   const node_t n = 50000;
+   const auto expected = _circulant(n);
+
+   // each neighbourhood in descending order; the reader has to sort it
+   std::vector<std::vector<node_t>> adjacency(n);
+   for (const auto& e : expected) {
+      adjacency[e.first].push_back(e.second);
+      adjacency[e.second].push_back(e.first);
+   }
+
+   std::string content = "% comment\n" + std::to_string(n) + " " + std::to_string(expected.size()) + "\n";
+   for (node_t u = 0; u < n; ++u) {
+      std::sort(adjacency[u].rbegin(), adjacency[u].rend());
+      for (node_t v : adjacency[u])
+         content += " " + std::to_string(v + 1);
+      content += (u % 1000 ? "\n" : "\r\n% comment within the nodes\n");
+   }
+   _write(content);
+
+   EdgeStream edges;
+   const auto info = load_graph_file(_filename, GraphFileFormat::Metis, edges);
+   ASSERT_EQ(info.num_nodes, n);
+   ASSERT_EQ(info.num_edges, static_cast<edgeid_t>(expected.size()));
+   ASSERT_EQ(_to_vector(edges), expected);
+}
+
+TEST_F(TestGraphFileReader, snap) {
+   const node_t n = 50000;
+   const auto expected = _circulant(n);
+
+   // both directions, a self-loop and no line break at the end of the file
+   std::string content = "# Nodes: 50000\n";
+   for (size_t i = expected.size(); i--; ) {
+      const auto& e = expected[i];
+      content += std::to_string(e.second) + "\t" + std::to_string(e.first) + "\n";
+      content += std::to_string(e.first) + " " + std::to_string(e.second) + "\n";
+   }
+   content += "7 7";
+   _write(content);
+
+   EdgeStream edges;
+   const auto info = load_graph_file(_filename, GraphFileFormat::Snap, edges);
+   ASSERT_EQ(info.num_nodes, n);
+   ASSERT_EQ(info.num_edges, static_cast<edgeid_t>(expected.size()));
+   ASSERT_EQ(_to_vector(edges), expected);
+}
+
+TEST_F(TestGraphFileReader, malformed) {
+   EdgeStream edges;
+
+   _write("1 2\n3 x\n");
+   ASSERT_THROW(load_graph_file(_filename, GraphFileFormat::Snap, edges), std::runtime_error);
+
+   _write("2 1\n2\n3\n");
+   ASSERT_THROW(load_graph_file(_filename, GraphFileFormat::Metis, edges), std::runtime_error);
+
+   _write("2 5\n2\n1\n");
+   ASSERT_THROW(load_graph_file(_filename, GraphFileFormat::Metis, edges), std::runtime_error);
+
+   ASSERT_THROW(parse_graph_file_format("csv"), std::runtime_error);
+}
@@ -179,4 +179,42 @@ TEST_F(TestHavelHakimiIMGenerator, barabasiAlbertDefect) {
         std::sort(degrees.begin(), degrees.end());
         this->_check_hh(degrees, HavelHakimiIMGenerator::PushDirection::IncreasingDegree, 0, false);
     }
-}
\ No newline at end of file
+}
+
+TEST_F(TestHavelHakimiIMGenerator, pushRuns) {
+    auto degrees = this->_barabasi(1000, 3);
+    std::sort(degrees.begin(), degrees.end(), std::greater<degree_t>());
+
+    RLEDegreeStream runs;
+    for (auto d : degrees)
+        runs.push(d);
+    runs.rewind();
+
+    HavelHakimiIMGeneratorWithDegrees single(HavelHakimiIMGeneratorWithDegrees::DecreasingDegree);
+    HavelHakimiIMGeneratorWithDegrees blocks(HavelHakimiIMGeneratorWithDegrees::DecreasingDegree);
+    for (auto d : degrees)
+        single.push(d);
+    blocks.push(runs);
+
+    single.generate();
+    blocks.generate();
+    ASSERT_EQ(single.maxEdges(), blocks.maxEdges());
+
+    for (; !single.empty(); ++single, ++blocks) {
+        ASSERT_FALSE(blocks.empty());
+        ASSERT_EQ(*single, *blocks);
+    }
+    ASSERT_TRUE(blocks.empty());
+
+    single.finalize();
+    blocks.finalize();
+
+    auto &single_degrees = single.get_degree_stream();
+    auto &block_degrees = blocks.get_degree_stream();
+    single_degrees.rewind();
+    block_degrees.rewind();
+    for (; !single_degrees.empty(); ++single_degrees, ++block_degrees) {
+        ASSERT_FALSE(block_degrees.empty());
+        ASSERT_EQ(*single_degrees, *block_degrees);
+    }
+}
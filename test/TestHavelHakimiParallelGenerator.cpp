@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <HavelHakimi/HavelHakimiIMGenerator.h>
+#include <HavelHakimi/HavelHakimiParallelGenerator.h>
+
+#include <stxxl/bits/common/rand.h>
+
+#include <algorithm>
+#include <vector>
+
+class TestHavelHakimiParallelGenerator : public ::testing::Test {
+protected:
+    void _compare(const std::vector<degree_t> & sequence, HavelHakimiIMGenerator::PushDirection dir, node_t initial_id, edgeid_t batch_size) {
+        HavelHakimiIMGenerator serial(dir, initial_id);
+        HavelHakimiParallelGenerator parallel(
+            dir == HavelHakimiIMGenerator::IncreasingDegree
+                ? HavelHakimiParallelGenerator::IncreasingDegree
+                : HavelHakimiParallelGenerator::DecreasingDegree,
+            initial_id, batch_size);
+
+        for (auto &d : sequence) {
+            serial.push(d);
+            parallel.push(d);
+        }
+
+        ASSERT_TRUE(parallel.empty());
+        serial.generate();
+        parallel.generate();
+        ASSERT_EQ(serial.maxEdges(), parallel.maxEdges());
+
+        edgeid_t no_edges = 0;
+        for (; !serial.empty(); ++serial, ++parallel, ++no_edges) {
+            ASSERT_FALSE(parallel.empty()) << "edge " << no_edges;
+            ASSERT_EQ(*serial, *parallel) << "edge " << no_edges;
+        }
+        ASSERT_TRUE(parallel.empty());
+
+        ASSERT_EQ(serial.unsatisfiedDegree(), parallel.unsatisfiedDegree());
+        ASSERT_EQ(serial.unsatisfiedNodes(), parallel.unsatisfiedNodes());
+    }
+
+    void _compare_all(std::vector<degree_t> degrees) {
+        for (edgeid_t batch_size : {edgeid_t(1), edgeid_t(7), edgeid_t(1) << 20}) {
+            std::sort(degrees.begin(), degrees.end(), std::greater<degree_t>());
+            _compare(degrees, HavelHakimiIMGenerator::DecreasingDegree, 0, batch_size);
+            _compare(degrees, HavelHakimiIMGenerator::DecreasingDegree, 1234, batch_size);
+
+            std::sort(degrees.begin(), degrees.end());
+            _compare(degrees, HavelHakimiIMGenerator::IncreasingDegree, 0, batch_size);
+            _compare(degrees, HavelHakimiIMGenerator::IncreasingDegree, 1234, batch_size);
+        }
+    }
+};
+
+TEST_F(TestHavelHakimiParallelGenerator, clique) {
+    for (node_t nodes : {3, 4, 5, 1000, 1001})
+        _compare_all(std::vector<degree_t>(nodes, static_cast<degree_t>(nodes - 1)));
+}
+
+TEST_F(TestHavelHakimiParallelGenerator, random) {
+    stxxl::random_number32 rand;
+
+    for (unsigned int iter = 0; iter < 20; iter++) {
+        std::vector<degree_t> degrees(1000);
+        for (auto &d : degrees)
+            d = 1 + rand(rand(2) ? 10 : 500);
+
+        // the sequence is not necessarily realizable; unsatisfied requests have to match as well
+        _compare_all(degrees);
+    }
+}
@@ -52,3 +52,57 @@ TEST(IntSort, random_uint8) {random_test_suite<uint8_t>();}
 TEST(IntSort, random_uint16) {random_test_suite<uint16_t>();}
 TEST(IntSort, random_uint32) {random_test_suite<uint32_t>();}
 TEST(IntSort, random_uint64) {random_test_suite<uint64_t>();}
+
+template <typename T, typename Key, typename KeyExtract>
+void compare_sort_inplace(std::vector<T>& input, KeyExtract extract, Key max_key) {
+	std::vector<T> vec_ref(input);
+	std::sort(vec_ref.begin(), vec_ref.end());
+
+	intsort::sort_inplace(input, extract, max_key);
+
+	for(size_t i = 1; i < input.size(); ++i)
+		ASSERT_LE(extract(input[i-1]), extract(input[i])) << "i=" << i;
+
+	// not stable, hence compare as multisets
+	std::sort(input.begin(), input.end());
+	ASSERT_EQ(input, vec_ref);
+};
+
+TEST(IntSort, inplace_random) {
+	for(unsigned int i = 1; i != 10; ++i) {
+		std::mt19937 gen(i);
+		const size_t len = 123 + pow(i, 6.1);
+		const uint64_t max_key = (0x12345678llu * i) ^ (0x31415923llu * i);
+		std::uniform_int_distribution<uint64_t> dist(0, max_key);
+
+		std::vector<uint64_t> input(len);
+		for(auto& x : input)
+			x = dist(gen);
+
+		compare_sort_inplace(input, [] (uint64_t x) {return x;}, max_key);
+	}
+}
+
+TEST(IntSort, inplace_skewed_payload) {
+	// keys in the upper half of the words are heavily skewed, the payload is ignored
+	using T = std::pair<uint32_t, uint32_t>;
+	std::mt19937 gen(42);
+	std::geometric_distribution<uint32_t> dist(0.001);
+
+	std::vector<T> input(3000000);
+	for(size_t i = 0; i < input.size(); ++i)
+		input[i] = T(std::min<uint32_t>(dist(gen), 1000000), i);
+
+	compare_sort_inplace(input, [] (const T& x) {return x.first;}, 1000000u);
+}
+
+TEST(IntSort, inplace_corner_cases) {
+	std::vector<uint32_t> empty;
+	compare_sort_inplace(empty, [] (uint32_t x) {return x;}, 10u);
+
+	std::vector<uint32_t> zeros(1000000, 0);
+	compare_sort_inplace(zeros, [] (uint32_t x) {return x;}, 0u);
+
+	std::vector<uint32_t> full_range = {std::numeric_limits<uint32_t>::max(), 0, 256, 255, 1};
+	compare_sort_inplace(full_range, [] (uint32_t x) {return x;}, std::numeric_limits<uint32_t>::max());
+}
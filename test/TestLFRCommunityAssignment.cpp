@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Test cases for the parallel online phase of LFR::_compute_community_assignments
+ */
+#include <gtest/gtest.h>
+
+#include <LFR/LFR.h>
+#include <Utils/RandomSeed.h>
+#include <omp.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+class TestLFRCommunityAssignment : public ::testing::Test {
+protected:
+	using Parameters = LFR::LFR::NodeDegreeDistribution::Parameters;
+
+	// runs the phases up to the community assignment in internal memory
+	class AssigningLFR : public LFR::LFR {
+	public:
+		AssigningLFR(const Parameters& nodes, const Parameters& communities)
+			: LFR(nodes, communities, 0.2, (4 + omp_get_max_threads()) * UIntScale::Gi)
+		{
+			setInternalMemory(true);
+
+			::LFR::OverlapConfig config;
+			config.constDegree.multiCommunityDegree = 2;
+			config.constDegree.overlappingNodes = 10000;
+			setOverlap(::LFR::OverlapMethod::constDegree, config);
+		}
+
+		//! (community, degree, node) of all assignments
+		std::vector<std::tuple<community_t, degree_t, node_t>> assign() {
+			_compute_node_distributions();
+			_compute_community_size();
+			_correct_community_sizes();
+			_compute_community_assignments();
+
+			std::vector<std::tuple<community_t, degree_t, node_t>> result;
+			for (const auto& a : _internal_assignments)
+				result.push_back(a.to_tuple());
+			return result;
+		}
+
+		std::vector<node_t> capacities() const {
+			std::vector<node_t> result;
+			for (community_t com = 0; com + 1 < static_cast<community_t>(_community_cumulative_sizes.size()); ++com)
+				result.push_back(_community_size(com));
+			return result;
+		}
+	};
+
+	static Parameters _params(node_t n, int_t min, int_t max, double exponent) {
+		Parameters p;
+		p.exponent = exponent;
+		p.minDegree = min;
+		p.maxDegree = max;
+		p.numberOfNodes = n;
+		p.scale = 1.0;
+		return p;
+	}
+};
+
+TEST_F(TestLFRCommunityAssignment, independentOfThreads) {
+	// large enough that the online phase processes several batches in parallel
+	const node_t n = 3000000;
+	const int max_threads = omp_get_max_threads();
+
+	std::vector<node_t> capacities;
+	auto assign = [&] (int threads) {
+		omp_set_num_threads(threads);
+		RandomSeed::get_instance().seed(42);
+		AssigningLFR lfr(_params(n, 10, 100, -2.0), _params(4000, 200, 2000, -1.0));
+		auto assignments = lfr.assign();
+		capacities = lfr.capacities();
+		return assignments;
+	};
+
+	const auto reference = assign(1);
+	ASSERT_FALSE(reference.empty());
+	ASSERT_EQ(reference, assign(std::max(2, max_threads)));
+	ASSERT_EQ(reference, assign(3));
+
+	omp_set_num_threads(max_threads);
+
+	// no community exceeds its capacity and nodes join communities large enough
+	std::vector<node_t> members(capacities.size(), 0);
+	for (const auto& a : reference) {
+		const community_t com = std::get<0>(a);
+		ASSERT_LT(static_cast<size_t>(com), capacities.size());
+		EXPECT_LT(std::get<1>(a), capacities[com]);
+		++members[com];
+	}
+
+	for (size_t com = 0; com < capacities.size(); ++com)
+		EXPECT_LE(members[com], capacities[com]) << "community " << com;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @brief Test cases for LFR::MemoryPlanner
+ */
+#include <gtest/gtest.h>
+
+#include <LFR/LFRMemoryPlanner.h>
+#include <stdexcept>
+
+class TestLFRMemoryPlanner : public ::testing::Test {};
+
+using LFR::MemoryPlanner;
+
+TEST_F(TestLFRMemoryPlanner, tooSmallBudget) {
+    EXPECT_THROW(MemoryPlanner(256 * UIntScale::Mi, 4, 1000000, 1000), std::runtime_error);
+}
+
+TEST_F(TestLFRMemoryPlanner, phasesFitIntoBudget) {
+    const uint_t budget = 16 * UIntScale::Gi;
+    const node_t nodes = 10000000;
+
+    MemoryPlanner planner(budget, 4, nodes, 100000);
+    planner.plan(2 * edgeid_t(nodes), 50 * edgeid_t(nodes), 0.3, 50000, true);
+
+    const uint_t available = budget - planner.node_sorter();
+
+    EXPECT_LE(planner[MemoryPlanner::AssignmentSorter] + planner[MemoryPlanner::AssignmentInternal], available);
+    EXPECT_LE(planner[MemoryPlanner::CommunityEdgeSorter] + planner[MemoryPlanner::CommunityWorkers], available);
+    EXPECT_LE(planner[MemoryPlanner::GlobalDegreeSorter]
+              + planner[MemoryPlanner::GlobalEdgeSorterSource]
+              + planner[MemoryPlanner::GlobalEdgeSorterTarget], available);
+    EXPECT_LE(planner[MemoryPlanner::GlobalSwaps] + planner[MemoryPlanner::GlobalRewiringSorters], available);
+
+    // every consumer receives at least its minimum
+    for (unsigned int c = 0; c < MemoryPlanner::NumberOfConsumers; ++c) {
+        if (c == MemoryPlanner::AssignmentInternal) continue;
+        EXPECT_GE(planner[static_cast<MemoryPlanner::Consumer>(c)], MemoryPlanner::min_sorter_mem);
+    }
+
+    EXPECT_GE(planner.community_worker(), MemoryPlanner::min_swap_mem / 2);
+    EXPECT_GE(planner[MemoryPlanner::GlobalSwaps], MemoryPlanner::min_swap_mem);
+}
+
+TEST_F(TestLFRMemoryPlanner, sortersAreCappedByVolume) {
+    const uint_t budget = 64 * UIntScale::Gi;
+    const node_t nodes = 100000;
+
+    MemoryPlanner planner(budget, 2, nodes, 100);
+    planner.plan(nodes, 20 * edgeid_t(nodes), 0.5, 5000, false);
+
+    // small instance: sorters need no more than the minimum, the rest goes to the elastic consumers
+    EXPECT_EQ(planner[MemoryPlanner::GlobalDegreeSorter], MemoryPlanner::min_sorter_mem);
+    EXPECT_EQ(planner[MemoryPlanner::ExportSorter], MemoryPlanner::min_sorter_mem);
+    EXPECT_GT(planner[MemoryPlanner::GlobalSwaps], budget / 2);
+    EXPECT_GT(planner[MemoryPlanner::CommunityWorkers], budget / 2);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Test cases for LFR::verify_graph and LFR::VerificationReport
+ */
+#include <gtest/gtest.h>
+
+#include <LFR/LFR.h>
+#include <omp.h>
+#include <vector>
+
+class TestLFRVerification : public ::testing::Test {
+protected:
+	using Parameters = LFR::LFR::NodeDegreeDistribution::Parameters;
+
+	// exposes the state verify_graph() inspects
+	class VerifiableLFR : public LFR::LFR {
+	public:
+		VerifiableLFR(const Parameters& nodes, const Parameters& communities)
+			: LFR(nodes, communities, 0.0, (4 + omp_get_max_threads()) * UIntScale::Gi)
+		{}
+
+		// communities {0, 1, 2} and {3, 4, 5}, all nodes with degree 2;
+		// only the first requested_nodes nodes get a requested degree
+		void setup(const std::vector<edge_t>& edges, node_t requested_nodes = 6) {
+			for (node_t u = 0; u < requested_nodes; ++u)
+				_node_sorter.push(::LFR::NodeDegreeMembership(2, 1));
+			_node_sorter.sort();
+
+			_community_cumulative_sizes = {0, 3, 6};
+			for (node_t u = 0; u < 6; ++u)
+				_community_assignments.push_back(::LFR::CommunityAssignment(u / 3, 2, u));
+
+			for (const auto& e : edges)
+				_edges.push(e);
+			_edges.consume();
+		}
+	};
+
+	static Parameters _params(node_t n, int_t min, int_t max) {
+		Parameters p;
+		p.exponent = -2.0;
+		p.minDegree = min;
+		p.maxDegree = max;
+		p.numberOfNodes = n;
+		p.scale = 1.0;
+		return p;
+	}
+
+	VerifiableLFR _lfr {_params(6, 2, 2), _params(2, 3, 3)};
+};
+
+TEST_F(TestLFRVerification, validGraph) {
+	_lfr.setup({{0, 1}, {0, 2}, {1, 2}, {3, 4}, {3, 5}, {4, 5}});
+
+	const auto report = _lfr.verify_graph();
+	EXPECT_TRUE(report.valid());
+	EXPECT_EQ(report.nodes, 6u);
+	EXPECT_EQ(report.edges, 6u);
+	EXPECT_EQ(report.intra_edges, 6u);
+	EXPECT_EQ(report.inter_edges, 0u);
+	EXPECT_EQ(report.communities, 2u);
+	EXPECT_EQ(report.degree_mismatches, 0u);
+	EXPECT_EQ(report.degree_deviation[0], 6u);
+}
+
+TEST_F(TestLFRVerification, brokenGraph) {
+	// multi-edge {0, 1} instead of {1, 2}, inter-community edge {2, 3} and self-loop {5, 5}
+	_lfr.setup({{0, 1}, {0, 1}, {0, 2}, {2, 3}, {3, 4}, {3, 5}, {4, 5}, {5, 5}});
+
+	const auto report = _lfr.verify_graph();
+	EXPECT_FALSE(report.valid());
+	EXPECT_EQ(report.edges, 8u);
+	EXPECT_EQ(report.multi_edges, 1u);
+	EXPECT_EQ(report.self_loops, 1u);
+	EXPECT_EQ(report.inter_edges, 1u);
+	EXPECT_EQ(report.degree_overassigned, 2u); // nodes 0 and 3
+	EXPECT_EQ(report.degree_mismatches, 2u);
+	EXPECT_EQ(report.missing_degree, -2);
+	EXPECT_EQ(report.intra_degree_mismatches, 2u); // nodes 0 and 2
+}
+
+TEST_F(TestLFRVerification, nodeCountMismatch) {
+	_lfr.setup({{0, 1}, {0, 2}, {1, 2}, {3, 4}, {3, 5}, {4, 5}}, 5);
+
+	const auto report = _lfr.verify_graph();
+	EXPECT_FALSE(report.valid());
+	EXPECT_TRUE(report.node_count_mismatch);
+	EXPECT_EQ(report.nodes, 5u);
+	EXPECT_EQ(report.membership_mismatches, 0u);
+	EXPECT_EQ(report.degree_mismatches, 0u);
+}
+
+TEST_F(TestLFRVerification, mergeReports) {
+	LFR::VerificationReport a, b;
+	a.edges = 10;
+	a.inter_edges = 4;
+	a.missing_degree = 3;
+	a.degree_deviation[LFR::VerificationReport::deviation_bucket(3)] = 1;
+
+	b.edges = 5;
+	b.inter_edges = 1;
+	b.missing_degree = -5;
+	b.self_loops = 1;
+	b.degree_deviation[LFR::VerificationReport::deviation_bucket(-5)] = 2;
+
+	EXPECT_TRUE(a.valid());
+	a.merge(b);
+
+	EXPECT_FALSE(a.valid());
+	EXPECT_EQ(a.edges, 15u);
+	EXPECT_EQ(a.self_loops, 1u);
+	EXPECT_EQ(a.missing_degree, -2);
+	EXPECT_DOUBLE_EQ(a.realised_mixing(), 1.0 / 3);
+	EXPECT_EQ(a.degree_deviation[2], 1u);
+	EXPECT_EQ(a.degree_deviation[3], 2u);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <MixingStatistics.h>
+
+#include <random>
+#include <vector>
+
+class TestMixingStatistics : public ::testing::Test {};
+
+TEST_F(TestMixingStatistics, alternatingEdge) {
+    EdgeIndicatorStatistics stats(10, 2);
+
+    stats.push({0, 1, 0, 1, 0, 1, 0, 1, 0, 1});
+    stats.push({1, 1, 1, 1, 1, 1, 1, 1, 1, 1});
+
+    ASSERT_EQ(stats.num_edges(), 2u);
+    ASSERT_EQ(stats.num_varying_edges(), 1u);
+
+    // the constant edge does not contribute to the autocorrelation
+    ASSERT_NEAR(stats.mean_autocorrelation(1), -0.9, 1e-9);
+    ASSERT_NEAR(stats.mean_autocorrelation(2), 0.8, 1e-9);
+
+    // strict alternation is a Markov chain; every second snapshot is constant
+    ASSERT_DOUBLE_EQ(stats.non_independent_fraction(1), 0.5);
+    ASSERT_DOUBLE_EQ(stats.non_independent_fraction(2), 0.0);
+}
+
+TEST_F(TestMixingStatistics, independentEdges) {
+    const unsigned int snapshots = 200;
+    EdgeIndicatorStatistics stats(snapshots, 1);
+
+    STDRandomEngine gen(1234);
+    std::bernoulli_distribution distr(0.3);
+    std::vector<uint8_t> presence(snapshots);
+
+    for (unsigned int e = 0; e < 1000; ++e) {
+        for (auto & x : presence)
+            x = distr(gen);
+        stats.push(presence);
+    }
+
+    ASSERT_NEAR(stats.mean_autocorrelation(1), 0.0, 0.01);
+    ASSERT_LT(stats.non_independent_fraction(1), 0.1);
+}
+
+TEST_F(TestMixingStatistics, assortativity) {
+    // star: hubs only connect to leaves
+    DegreeAssortativity star;
+    for (unsigned int i = 0; i < 3; ++i)
+        star.push(3, 1);
+    ASSERT_DOUBLE_EQ(star.value(), -1.0);
+
+    // triangle and an isolated edge: endpoints always have equal degrees
+    DegreeAssortativity equal;
+    for (unsigned int i = 0; i < 3; ++i)
+        equal.push(2, 2);
+    equal.push(1, 1);
+    ASSERT_DOUBLE_EQ(equal.value(), 1.0);
+}
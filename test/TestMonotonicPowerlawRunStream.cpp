@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <defs.h>
+#include <cmath>
+#include <Utils/MonotonicPowerlawRunStream.h>
+
+class TestMonotonicPowerlawRunStream :
+    public ::testing::TestWithParam<std::tuple<uint_t, uint_t, bool>> {};
+
+template <bool Increasing>
+static void checkRuns(const degree_t min, const degree_t max, const int_t length) {
+    MonotonicPowerlawRunStream<Increasing> rs(min, max, -2.0, length, 1.0, 1234 * length);
+
+    degree_t last_degree = Increasing ? min - 1 : max + 1;
+    uint_t nodes = 0;
+    for (; !rs.empty(); ++rs) {
+        ASSERT_GT(rs->count, 0u);
+
+        if (Increasing) {
+            ASSERT_LT(last_degree, rs->value); // strictly monotonic runs
+        } else {
+            ASSERT_GT(last_degree, rs->value);
+        }
+
+        ASSERT_LE(rs->value, max);
+        ASSERT_GE(rs->value, min);
+
+        nodes += rs->count;
+        ASSERT_EQ(nodes, rs->index);
+        last_degree = rs->value;
+    }
+
+    ASSERT_EQ(nodes, static_cast<uint_t>(length));
+}
+
+TEST_P(TestMonotonicPowerlawRunStream, basicProperties) {
+    const degree_t min        = std::get<0>(GetParam());
+    const degree_t length     = std::get<1>(GetParam());
+    const bool   increasing = std::get<2>(GetParam());
+
+    if (increasing)
+        checkRuns<true>(min, 10000, length);
+    else
+        checkRuns<false>(min, 10000, length);
+}
+
+INSTANTIATE_TEST_CASE_P(TestMonotonicPowerlawRunStreamSets,
+                        TestMonotonicPowerlawRunStream,
+                        ::testing::Combine(
+                            ::testing::Values(1, 10),
+                            ::testing::Values(10, 100000, 10000000),
+                            ::testing::Bool()
+                        )
+);
+
+TEST(TestMonotonicPowerlawRunStreamDistribution, expectedCounts) {
+    const degree_t min = 1;
+    const degree_t max = 100;
+    const int_t length = 1000000;
+
+    double normalization = 0.0;
+    for (degree_t d = min; d <= max; d++)
+        normalization += std::pow(double(d), -2.0);
+
+    MonotonicPowerlawRunStream<true> rs(min, max, -2.0, length, 1.0, 4321);
+    for (; !rs.empty(); ++rs) {
+        const double p = std::pow(double(rs->value), -2.0) / normalization;
+        const double expected = p * length;
+        const double sigma = std::sqrt(length * p * (1.0 - p));
+
+        EXPECT_LE(std::abs(double(rs->count) - expected), 6 * sigma + 1) << "degree " << rs->value;
+    }
+}
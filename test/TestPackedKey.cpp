@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <defs.h>
+#include <PackedKey.h>
+#include <Utils/IntSort.h>
+#include <EdgeSwaps/EdgeSwapTFP.h>
+
+namespace {
+    struct SignedMsg {
+        int64_t a;
+        int8_t b;
+        bool c;
+
+        DECL_LEX_COMPARE_OS(SignedMsg, a, b, c);
+    };
+
+    using EdgeSwapTFP::DependencyChainEdgeMsg;
+    using EdgeSwapTFP::ExistenceRequestMsg;
+    using EdgeSwapTFP::ExistenceSuccessorMsg;
+
+    //! Checks that the packed keys induce the same order as operator< on all pairs
+    template <typename T>
+    void check_order(const std::vector<T>& msgs) {
+        for (const auto& x : msgs) {
+            for (const auto& y : msgs) {
+                ASSERT_EQ(x < y, PackedKey<T>::pack(x) < PackedKey<T>::pack(y)) << x << " " << y;
+                ASSERT_LE(PackedKey<T>::pack(x), PackedKey<T>::max_key());
+            }
+        }
+    }
+}
+
+TEST(PackedKey, keySizes) {
+    static_assert(PackedKey<DependencyChainEdgeMsg>::bits == 96, "swap_id and two nodes");
+    static_assert(PackedKey<EdgeSwapTFP::DependencyChainSuccessorMsg>::bits == 64, "two swap ids");
+    static_assert(std::is_same<PackedKey<EdgeSwapTFP::DependencyChainSuccessorMsg>::type, uint64_t>::value, "fits into 64 bits");
+    static_assert(PackedKey<SignedMsg>::bits == 73, "int64_t, int8_t and bool");
+}
+
+TEST(PackedKey, signedMembers) {
+    std::vector<SignedMsg> msgs;
+    for (int64_t a : {std::numeric_limits<int64_t>::min(), int64_t(-1), int64_t(0), int64_t(1), std::numeric_limits<int64_t>::max()})
+        for (int8_t b : {int8_t(-128), int8_t(-1), int8_t(0), int8_t(127)})
+            for (bool c : {false, true})
+                msgs.push_back(SignedMsg{a, b, c});
+
+    check_order(msgs);
+}
+
+TEST(PackedKey, messages) {
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<swapid_t> swap_dis(0, 7);
+    std::uniform_int_distribution<node_t> node_dis(-2, 2);
+
+    std::vector<DependencyChainEdgeMsg> depchain;
+    std::vector<ExistenceRequestMsg> requests;
+    std::vector<ExistenceSuccessorMsg> successors;
+    for (int i = 0; i < 300; ++i) {
+        const edge_t edge(node_dis(gen), node_dis(gen));
+        depchain.emplace_back(swap_dis(gen), edge);
+        requests.emplace_back(edge, swap_dis(gen), swap_dis(gen) & 1);
+        successors.emplace_back(swap_dis(gen), edge, swap_dis(gen));
+    }
+
+    check_order(depchain);
+    check_order(requests); // hand-written operator< with descending swap id
+    check_order(successors);
+}
+
+TEST(PackedKey, comparatorAndSort) {
+    std::mt19937_64 gen(2);
+    std::uniform_int_distribution<swapid_t> swap_dis(0, 1000);
+    std::uniform_int_distribution<node_t> node_dis(0, 1 << 20);
+
+    std::vector<ExistenceSuccessorMsg> msgs;
+    for (int i = 0; i < 500000; ++i)
+        msgs.emplace_back(swap_dis(gen), edge_t(node_dis(gen), node_dis(gen)), swap_dis(gen));
+
+    auto expected = msgs;
+    std::sort(expected.begin(), expected.end());
+
+    auto sorted = msgs;
+    std::sort(sorted.begin(), sorted.end(), PackedKeyComparator<ExistenceSuccessorMsg>::Ascending());
+    ASSERT_EQ(sorted, expected);
+
+    std::sort(sorted.begin(), sorted.end(), PackedKeyComparator<ExistenceSuccessorMsg>::Descending());
+    ASSERT_TRUE(std::equal(sorted.begin(), sorted.end(), expected.rbegin()));
+
+    intsort::sort_packed(msgs);
+    ASSERT_EQ(msgs, expected);
+}
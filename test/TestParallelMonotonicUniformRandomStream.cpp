@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <defs.h>
+#include <omp.h>
+#include <vector>
+#include <Utils/ParallelMonotonicUniformRandomStream.h>
+
+class TestParallelMonotonicUniformRandomStream : public ::testing::TestWithParam<std::tuple<uint_t, uint_t, bool>> {
+protected:
+    template <bool Increasing>
+    void _check(const uint_t length, const uint_t segments) {
+        ParallelMonotonicUniformRandomStream<Increasing> rs(length, 1234 * length, segments);
+
+        double last_rv = Increasing ? 0.0 : 1.0;
+        double sum = 0.0;
+
+        for(uint_t i=0; i<length; i++, ++rs) {
+            ASSERT_FALSE(rs.empty());
+
+            if (Increasing) {
+                ASSERT_LE(last_rv, *rs); // monotony
+            } else {
+                ASSERT_GE(last_rv, *rs); // monotony
+            }
+
+            ASSERT_LE(*rs, 1.0);
+            ASSERT_GE(*rs, 0.0);
+
+            sum += *rs;
+            last_rv = *rs;
+        }
+
+        sum /= length;
+
+        ASSERT_TRUE(rs.empty());
+        EXPECT_LE(sum, 0.6);
+        EXPECT_GE(sum, 0.4);
+    }
+};
+
+TEST_P(TestParallelMonotonicUniformRandomStream, basicProperties) {
+    const uint_t length = std::get<0>(GetParam());
+    const uint_t segments = std::get<1>(GetParam());
+    const bool   increasing = std::get<2>(GetParam());
+
+    if (increasing)
+        _check<true>(length, segments);
+    else
+        _check<false>(length, segments);
+}
+
+INSTANTIATE_TEST_CASE_P(TestParallelMonotonicUniformRandomStreamSets,
+                        TestParallelMonotonicUniformRandomStream,
+                        ::testing::Combine(
+                            ::testing::Values(100, 1000000, 10000000),
+                            ::testing::Values(0, 1, 7, 1000),
+                            ::testing::Bool()
+                        )
+);
+
+TEST(TestParallelMonotonicUniformRandomStreamReproducibility, independentOfThreads) {
+    const uint_t length = 1000000;
+    const int max_threads = omp_get_max_threads();
+
+    auto sample = [&] (int threads) {
+        omp_set_num_threads(threads);
+        std::vector<double> values;
+        for (ParallelMonotonicUniformRandomStream<> rs(length, 42, 64); !rs.empty(); ++rs)
+            values.push_back(*rs);
+        return values;
+    };
+
+    const auto reference = sample(1);
+    ASSERT_EQ(reference.size(), length);
+    ASSERT_EQ(reference, sample(std::max(2, max_threads)));
+    ASSERT_EQ(reference, sample(3));
+
+    omp_set_num_threads(max_threads);
+}
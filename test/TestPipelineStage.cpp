@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <defs.h>
+#include <Utils/PipelineStage.h>
+#include <Utils/AsyncPusher.h>
+#include <Utils/AsyncStream.h>
+
+#include <thread>
+#include <vector>
+
+class TestPipelineStage : public ::testing::Test {};
+
+TEST_F(TestPipelineStage, queueKeepsOrder) {
+    SPSCBatchQueue<uint_t> queue(7, 3);
+    const uint_t n = 100000;
+
+    std::thread producer([&] {
+        uint_t i = 0;
+        while (i < n) {
+            auto* batch = queue.begin_produce();
+            for (; i < n && batch->size < queue.capacity(); ++i)
+                batch->data[batch->size++] = i;
+            queue.end_produce();
+        }
+        queue.close();
+    });
+
+    uint_t expected = 0;
+    while (auto* batch = queue.begin_consume()) {
+        ASSERT_GT(batch->size, 0u);
+        for (const auto x : *batch)
+            ASSERT_EQ(x, expected++);
+        queue.end_consume();
+    }
+    producer.join();
+
+    ASSERT_EQ(expected, n);
+}
+
+TEST_F(TestPipelineStage, queueBackPressure) {
+    SPSCBatchQueue<uint_t> queue(1, 2);
+
+    // fill all batches without consuming
+    for (unsigned int i = 0; i < 2; ++i) {
+        auto* batch = queue.begin_produce();
+        batch->data[0] = i;
+        batch->size = 1;
+        queue.end_produce();
+    }
+
+    std::atomic<bool> produced {false};
+    std::thread producer([&] {
+        queue.begin_produce();
+        produced = true;
+        queue.end_produce();
+        queue.close();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(produced);
+
+    // releasing a batch unblocks the producer
+    ASSERT_EQ(queue.begin_consume()->data[0], 0u);
+    queue.end_consume();
+    producer.join();
+    ASSERT_TRUE(produced);
+}
+
+TEST_F(TestPipelineStage, queueCancel) {
+    SPSCBatchQueue<uint_t> queue(1, 2);
+
+    std::thread producer([&] {
+        while (auto* batch = queue.begin_produce()) {
+            batch->size = 1;
+            queue.end_produce();
+        }
+    });
+
+    queue.begin_consume();
+    queue.cancel();
+    producer.join();
+
+    ASSERT_EQ(queue.begin_consume(), nullptr);
+}
+
+TEST_F(TestPipelineStage, asyncPusherRestart) {
+    struct Target {
+        std::vector<uint_t> items;
+        void push(uint_t x) {items.push_back(x);}
+    };
+
+    Target target;
+    AsyncPusher<Target, uint_t> pusher(target, 10, 3);
+
+    for (uint_t i = 0; i < 1000; ++i)
+        pusher.push(i);
+    pusher.finish();
+    ASSERT_EQ(target.items.size(), 1000u);
+
+    pusher.restart();
+    for (uint_t i = 1000; i < 1005; ++i)
+        pusher.push(i);
+    pusher.finish();
+
+    ASSERT_EQ(target.items.size(), 1005u);
+    for (uint_t i = 0; i < target.items.size(); ++i)
+        ASSERT_EQ(target.items[i], i);
+}
+
+TEST_F(TestPipelineStage, asyncStreamRestart) {
+    struct RangeStream {
+        using value_type = uint_t;
+        uint_t begin, end, current;
+
+        RangeStream(uint_t b, uint_t e) : begin(b), end(e), current(b) {}
+        void rewind() {current = begin;}
+
+        bool empty() const {return current == end;}
+        const uint_t& operator*() const {return current;}
+        RangeStream& operator++() {++current; return *this;}
+    };
+
+    // small buffers, so each pass spans many batches
+    RangeStream source(0, 1000);
+    AsyncStream<RangeStream> stream(source, true, 1.0e7, 0.5, 10);
+
+    for (unsigned int pass = 0; pass < 3; ++pass) {
+        uint_t expected = source.begin;
+        for (; !stream.empty(); ++stream)
+            ASSERT_EQ(*stream, expected++);
+        ASSERT_EQ(expected, source.end);
+
+        // the input is restarted externally with a different range
+        source.begin += 500;
+        source.end += 700;
+        source.rewind();
+        stream.restart(false);
+        stream.acquire();
+    }
+
+    ASSERT_FALSE(stream.empty());
+    ASSERT_EQ(*stream, 1500u);
+}
@@ -75,4 +75,39 @@ TEST_F(TestRandomIntervalTree, integration) {
                 ASSERT_EQ(ps[i+1], tree.prefixsum(i)) << "i=" << i;
         }
    }
-}
\ No newline at end of file
+}
+
+TEST_F(TestRandomIntervalTree, rebuild) {
+    using T = uint64_t;
+    std::default_random_engine re(2);
+    std::uniform_int_distribution<int> sdist(0,13);
+
+    for(size_t size : {1, 2, 3, 17, 64, 1000}) {
+        std::vector<unsigned int> leafes(size);
+        for(auto & l : leafes)
+            l = sdist(re);
+
+        RandomIntervalTree<T> tree(leafes);
+
+        for(unsigned int round=0; round < 10 && tree.total_weight(); round++) {
+            // decrease some leaves externally (the tree is stale in the meantime)
+            // and update the tree in bulk
+            for(unsigned int i=0; i < 5; i++) {
+                std::uniform_int_distribution<T> tdist(0, tree.total_weight() - 1);
+                const auto leaf = tree.getLeaf(tdist(re));
+                ASSERT_LT(leaf, size);
+                if (leafes[leaf])
+                    leafes[leaf]--;
+            }
+
+            tree.rebuild(leafes);
+
+            T ps = 0;
+            for(size_t i=0; i < size; i++) {
+                ps += leafes[i];
+                ASSERT_EQ(ps, tree.prefixsum(i)) << "i=" << i;
+            }
+            ASSERT_EQ(ps, tree.total_weight());
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "SortedSwapRequestGenerator.h"
+
+#include <vector>
+
+class TestSortedSwapRequestGenerator : public ::testing::Test {};
+
+TEST_F(TestSortedSwapRequestGenerator, sortedAndComplete) {
+   for(swapid_t num = 1; num < 100; num++) {
+      for(edgeid_t edges : {2, 3, 10, 1000}) {
+         SortedSwapRequestGenerator gen(num, edges, 1234*num + edges);
+
+         std::vector<edgeid_t> edge_of_request(2*num, -1);
+         edgeid_t last_edge = -1;
+         swapid_t last_request = 0;
+
+         for(swapid_t i=0; i < 2*num; i++) {
+            ASSERT_FALSE(gen.empty());
+            const auto & req = *gen;
+
+            ASSERT_GE(req.edge_id, 0);
+            ASSERT_LT(req.edge_id, edges);
+            ASSERT_LT(req.swap_id, 2*num);
+
+            // ordered by edge id and then by request
+            ASSERT_LE(last_edge, req.edge_id);
+            if (last_edge == req.edge_id)
+               ASSERT_LT(last_request, req.swap_id);
+
+            // each request is emitted exactly once
+            ASSERT_EQ(edge_of_request[req.swap_id], -1);
+            edge_of_request[req.swap_id] = req.edge_id;
+
+            last_edge = req.edge_id;
+            last_request = req.swap_id;
+            ++gen;
+         }
+
+         ASSERT_TRUE(gen.empty());
+
+         // the two edges of a swap are distinct
+         for(swapid_t s=0; s < num; s++)
+            ASSERT_NE(edge_of_request[2*s], edge_of_request[2*s+1]);
+      }
+   }
+}
+
+TEST_F(TestSortedSwapRequestGenerator, uniform) {
+   const swapid_t num = 1000000;
+   const edgeid_t edges = 100;
+   SortedSwapRequestGenerator gen(num, edges, 1);
+
+   // the first and second edge of each swap are uniform over all edges
+   std::vector<swapid_t> hist[2] = {std::vector<swapid_t>(edges), std::vector<swapid_t>(edges)};
+   for(; !gen.empty(); ++gen)
+      hist[gen->swap_id & 1][gen->edge_id]++;
+
+   for(unsigned int i=0; i < 2; i++) {
+      for(edgeid_t e=0; e < edges; e++) {
+         ASSERT_GT(hist[i][e], num / edges * 95 / 100);
+         ASSERT_LT(hist[i][e], num / edges * 105 / 100);
+      }
+   }
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <LFR/SparseGlobalRewiring.h>
+#include <map>
+#include <random>
+#include <set>
+
+class TestSparseGlobalRewiring : public ::testing::Test { };
+
+TEST_F(TestSparseGlobalRewiring, resolvesConflicts) {
+	// communities {0, 1, 2}, {3, 4, 5}, and singletons 6 to 11
+	stxxl::vector<LFR::CommunityAssignment> assignments;
+	for (node_t u = 0; u < 12; ++u) {
+		const community_t com = (u < 6) ? u / 3 : u - 4;
+		assignments.push_back(LFR::CommunityAssignment(com, 0, u));
+	}
+
+	std::vector<edge_t> input = {
+		{0, 1}, {0, 3}, {1, 4}, {2, 5}, {2, 6}, {3, 8},
+		{4, 10}, {6, 7}, {8, 9}, {10, 11}
+	};
+
+	std::map<node_t, degree_t> degrees;
+	EdgeStream edges;
+	for (const auto& e : input) {
+		edges.push(e);
+		degrees[e.first]++;
+		degrees[e.second]++;
+	}
+	edges.consume();
+
+	SparseGlobalRewiring rewiring(edges, assignments, 1234);
+	rewiring.push(SemiLoadedSwapDescriptor(edge_t(0, 1), 7, false));
+	rewiring.run();
+
+	ASSERT_EQ(edges.size(), input.size());
+
+	edge_t prev = edge_t::invalid();
+	for (; !edges.empty(); ++edges) {
+		const edge_t& e = *edges;
+		EXPECT_FALSE(e.is_loop());
+		if (!prev.is_invalid()) EXPECT_LT(prev, e);
+		EXPECT_FALSE(e.first < 6 && e.second < 6 && e.first / 3 == e.second / 3) << e;
+
+		degrees[e.first]--;
+		degrees[e.second]--;
+		prev = e;
+	}
+
+	for (const auto& d : degrees)
+		EXPECT_EQ(d.second, 0) << "node " << d.first;
+}
+
+TEST_F(TestSparseGlobalRewiring, manyRounds) {
+	// communities of ten nodes; nodes 0 to 9 are additionally members of a second community
+	const node_t n = 2000;
+	auto communities = [] (node_t u) {
+		std::vector<community_t> result {static_cast<community_t>(u / 10)};
+		if (u < 10) result.push_back(n / 10 + u % 2);
+		return result;
+	};
+
+	stxxl::vector<LFR::CommunityAssignment> assignments;
+	for (node_t u = 0; u < n; ++u)
+		for (const community_t com : communities(u))
+			assignments.push_back(LFR::CommunityAssignment(com, 0, u));
+
+	auto conflicting = [&] (const edge_t& e) {
+		const auto cu = communities(e.first);
+		const auto cv = communities(e.second);
+		for (const community_t c : cu)
+			if (std::find(cv.cbegin(), cv.cend(), c) != cv.cend())
+				return true;
+		return false;
+	};
+
+	// random simple graph; roughly every tenth edge lies within a community
+	std::mt19937_64 gen(42);
+	std::uniform_int_distribution<node_t> node_distr(0, n - 1);
+	std::set<edge_t> input;
+	while (input.size() < 10000) {
+		edge_t e(node_distr(gen), node_distr(gen));
+		if (input.size() % 10 == 0) e.second = e.first / 10 * 10 + (e.first + 1) % 10;
+		e.normalize();
+		if (!e.is_loop()) input.insert(e);
+	}
+
+	std::map<node_t, degree_t> degrees;
+	EdgeStream edges;
+	for (const auto& e : input) {
+		edges.push(e);
+		degrees[e.first]++;
+		degrees[e.second]++;
+	}
+	edges.consume();
+
+	SparseGlobalRewiring rewiring(edges, assignments, 1234);
+	std::uniform_int_distribution<edgeid_t> eid_distr(0, input.size() - 1);
+	for (const auto& e : input)
+		if (conflicting(e))
+			rewiring.push(SemiLoadedSwapDescriptor(e, eid_distr(gen), gen() % 2));
+	rewiring.run();
+
+	ASSERT_EQ(edges.size(), static_cast<edgeid_t>(input.size()));
+
+	edge_t prev = edge_t::invalid();
+	for (; !edges.empty(); ++edges) {
+		const edge_t& e = *edges;
+		EXPECT_FALSE(e.is_loop());
+		if (!prev.is_invalid()) EXPECT_LT(prev, e);
+		EXPECT_FALSE(conflicting(e)) << e;
+
+		degrees[e.first]--;
+		degrees[e.second]--;
+		prev = e;
+	}
+
+	for (const auto& d : degrees)
+		EXPECT_EQ(d.second, 0) << "node " << d.first;
+}
+
+TEST_F(TestSparseGlobalRewiring, givesUpWithoutProgress) {
+	// all nodes but 20 and 21 share community 0, hence almost no swap resolves a conflict
+	const node_t n = 22;
+	stxxl::vector<LFR::CommunityAssignment> assignments;
+	for (node_t u = 0; u < n; ++u)
+		assignments.push_back(LFR::CommunityAssignment(u < 20 ? 0 : u - 19, 0, u));
+
+	std::set<edge_t> input;
+	for (node_t u = 0; u < 20; ++u)
+		for (node_t v = u + 1; v < 20; v += 3)
+			input.emplace(u, v);
+	input.emplace(20, 21);
+
+	std::map<node_t, degree_t> degrees;
+	EdgeStream edges;
+	for (const auto& e : input) {
+		edges.push(e);
+		degrees[e.first]++;
+		degrees[e.second]++;
+	}
+	edges.consume();
+
+	std::mt19937_64 gen(42);
+	std::uniform_int_distribution<edgeid_t> eid_distr(0, input.size() - 1);
+	SparseGlobalRewiring rewiring(edges, assignments, 1234);
+	for (const auto& e : input)
+		if (e.second < 20)
+			rewiring.push(SemiLoadedSwapDescriptor(e, eid_distr(gen), gen() % 2));
+	rewiring.run();
+
+	// the conflicting edges are removed, the others keep the degrees
+	ASSERT_LT(edges.size(), static_cast<edgeid_t>(input.size()));
+
+	edge_t prev = edge_t::invalid();
+	for (; !edges.empty(); ++edges) {
+		const edge_t& e = *edges;
+		EXPECT_FALSE(e.is_loop());
+		if (!prev.is_invalid()) EXPECT_LT(prev, e);
+		EXPECT_FALSE(e.first < 20 && e.second < 20) << e;
+
+		degrees[e.first]--;
+		degrees[e.second]--;
+		prev = e;
+	}
+
+	for (const auto& d : degrees)
+		EXPECT_GE(d.second, 0) << "node " << d.first;
+}
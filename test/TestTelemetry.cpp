@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Test cases for Telemetry, parsing the Chrome trace and JSONL output
+ */
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Utils/IOStatistics.h>
+#include <Utils/Telemetry.h>
+
+namespace {
+    //! Minimal JSON value: objects, arrays, strings and numbers as produced by Telemetry
+    struct JsonValue {
+        enum Type {Object, Array, String, Number} type;
+        std::map<std::string, JsonValue> object;
+        std::vector<JsonValue> array;
+        std::string string;
+        double number;
+
+        const JsonValue& operator[](const std::string& key) const {
+            auto it = object.find(key);
+            if (it == object.cend())
+                throw std::runtime_error("missing key " + key);
+            return it->second;
+        }
+    };
+
+    class JsonParser {
+        const std::string& _str;
+        size_t _pos;
+
+        void _skip() {
+            while (_pos < _str.size() && std::isspace(static_cast<unsigned char>(_str[_pos])))
+                ++_pos;
+        }
+
+        void _expect(char c) {
+            _skip();
+            if (_pos >= _str.size() || _str[_pos] != c)
+                throw std::runtime_error(std::string("expected ") + c + " at " + std::to_string(_pos));
+            ++_pos;
+        }
+
+        bool _consume(char c) {
+            _skip();
+            if (_pos < _str.size() && _str[_pos] == c) {
+                ++_pos;
+                return true;
+            }
+            return false;
+        }
+
+        std::string _string() {
+            _expect('"');
+            std::string result;
+            while (_pos < _str.size() && _str[_pos] != '"') {
+                if (_str[_pos] == '\\')
+                    ++_pos;
+                result += _str[_pos++];
+            }
+            _expect('"');
+            return result;
+        }
+
+    public:
+        explicit JsonParser(const std::string& str) : _str(str), _pos(0) {}
+
+        JsonValue value() {
+            JsonValue v;
+            _skip();
+            if (_consume('{')) {
+                v.type = JsonValue::Object;
+                if (!_consume('}')) {
+                    do {
+                        const std::string key = _string();
+                        _expect(':');
+                        v.object[key] = value();
+                    } while (_consume(','));
+                    _expect('}');
+                }
+            } else if (_consume('[')) {
+                v.type = JsonValue::Array;
+                if (!_consume(']')) {
+                    do {
+                        v.array.push_back(value());
+                    } while (_consume(','));
+                    _expect(']');
+                }
+            } else if (_pos < _str.size() && _str[_pos] == '"') {
+                v.type = JsonValue::String;
+                v.string = _string();
+            } else {
+                v.type = JsonValue::Number;
+                size_t len;
+                v.number = std::stod(_str.substr(_pos), &len);
+                _pos += len;
+            }
+            return v;
+        }
+
+        bool done() {
+            _skip();
+            return _pos == _str.size();
+        }
+    };
+
+    JsonValue parse(const std::string& str) {
+        JsonParser parser(str);
+        JsonValue v = parser.value();
+        if (!parser.done())
+            throw std::runtime_error("trailing characters");
+        return v;
+    }
+}
+
+class TestTelemetry : public ::testing::Test {
+protected:
+    std::string _filename;
+
+    void TearDown() override {
+        Telemetry::get_instance().close();
+        std::remove(_filename.c_str());
+    }
+
+    // records an inner span with a counter inside an outer IOStatistics phase
+    void _record(const std::string& filename) {
+        _filename = filename;
+        Telemetry::get_instance().open(filename);
+        ASSERT_TRUE(Telemetry::enabled());
+        {
+            IOStatistics outer("outer \"phase\"");
+            TelemetrySpan inner("inner");
+            inner.counter("items", 42);
+        }
+        Telemetry::get_instance().close();
+        ASSERT_FALSE(Telemetry::enabled());
+    }
+
+    std::string _read() const {
+        std::ifstream in(_filename);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    static void _check_events(const std::vector<JsonValue>& events) {
+        ASSERT_EQ(events.size(), 2u);
+
+        // the inner span ends first
+        const JsonValue& inner = events[0];
+        const JsonValue& outer = events[1];
+
+        EXPECT_EQ(inner["name"].string, "inner");
+        EXPECT_EQ(inner["ph"].string, "X");
+        EXPECT_EQ(inner["args"]["path"].string, "outer \"phase\"/inner");
+        EXPECT_EQ(inner["args"]["items"].number, 42);
+
+        EXPECT_EQ(outer["name"].string, "outer \"phase\"");
+        EXPECT_EQ(outer["args"]["path"].string, "outer \"phase\"");
+        EXPECT_EQ(outer["args"].object.count("items"), 0u);
+
+        for (const JsonValue* e : {&inner, &outer}) {
+            for (const char* key : {"thread_cpu_us", "process_cpu_us", "io_reads", "io_writes",
+                                    "io_read_bytes", "io_written_bytes", "em_peak_bytes"})
+                EXPECT_EQ((*e)["args"][key].type, JsonValue::Number) << key;
+            EXPECT_GE((*e)["dur"].number, 0);
+        }
+
+        EXPECT_LE(outer["ts"].number, inner["ts"].number);
+        EXPECT_GE(outer["ts"].number + outer["dur"].number, inner["ts"].number + inner["dur"].number);
+    }
+};
+
+TEST_F(TestTelemetry, chromeTrace) {
+    _record("TestTelemetry.json");
+
+    const JsonValue trace = parse(_read());
+    ASSERT_EQ(trace.type, JsonValue::Array);
+    _check_events(trace.array);
+}
+
+TEST_F(TestTelemetry, jsonl) {
+    _record("TestTelemetry.jsonl");
+
+    std::vector<JsonValue> events;
+    std::istringstream lines(_read());
+    for (std::string line; std::getline(lines, line); )
+        events.push_back(parse(line));
+
+    _check_events(events);
+}
+
+TEST_F(TestTelemetry, disabled) {
+    _filename = "TestTelemetry.unused";
+    ASSERT_FALSE(Telemetry::enabled());
+
+    // spans and phases must not write anything without an open trace
+    IOStatistics phase("phase");
+    TelemetrySpan span("span");
+    span.counter("items", 1);
+    EXPECT_FALSE(std::ifstream(_filename).good());
+}